@@ -83,8 +83,24 @@ typedef struct Engine_Obj {
     /* Filled in when Engine_initFromServer() is called */
     Engine_AlgDesc *remoteAlgTab;
     Int numRemoteAlgs;
+
+    /* Buffers registered by Engine_registerBufs(), sorted by address */
+    struct Engine_RegBuf *regBufs;
+    Int numRegBufs;
+    Int maxRegBufs;
 } Engine_Obj;
 
+/*
+ *  Buffer whose physical address was looked up once at registration time,
+ *  so stubs don't have to translate it on every process call.
+ */
+typedef struct Engine_RegBuf {
+    UInt32          virtAddr;
+    UInt32          size;
+    UInt32          physAddr;
+    Int             refCount;   /* number of registrations of this buffer */
+} Engine_RegBuf;
+
 typedef struct Engine_NodeObj {
     Engine_Handle   engine;
     Comm_Queue      stdIn;      /* the node's input queue */
@@ -135,6 +151,7 @@ static Void freeNode(Engine_Node node);
 static Void freeServerTab(Engine_Handle engine);
 static String getServerKey(Engine_Handle engine);
 static Bool isa(Engine_AlgDesc *alg, String type);
+static Int findRegBuf(Engine_Obj *engine, UInt32 virtAddr);
 static Void name2Uuid(Engine_Obj *engine, String name, NODE_Uuid *uuid);
 static Engine_Handle rmsInit(Engine_Obj *engine, Engine_Error *ec);
 static Int getRpcProtocolVersion(Engine_Obj *engine, NODE_Uuid uuid);
@@ -466,6 +483,11 @@ Void Engine_close(Engine_Handle engine)
             freeServerTab(engine);
         }
 
+        if (engine->regBufs != NULL) {
+            Memory_free(engine->regBufs,
+                    engine->maxRegBufs * sizeof(Engine_RegBuf), NULL);
+        }
+
         /* free Engine object */
         Memory_free(engine, sizeof (Engine_Obj), NULL);
     }
@@ -1126,6 +1148,37 @@ Engine_Handle Engine_getEngine(Engine_Node node)
     return (node->engine);
 }
 
+/*
+ *  ======== Engine_getBufferPhysicalAddress ========
+ */
+UInt32 Engine_getBufferPhysicalAddress(Engine_Handle engine, Ptr buf,
+    Int size)
+{
+    Engine_RegBuf *regBuf;
+    Int            i;
+
+    if ((engine != NULL) && (engine->numRegBufs > 0)) {
+        i = findRegBuf(engine, (UInt32)buf);
+
+        /* findRegBuf() returns the first entry at or past buf */
+        if ((i == engine->numRegBufs) ||
+                (engine->regBufs[i].virtAddr != (UInt32)buf)) {
+            i--;
+        }
+
+        if (i >= 0) {
+            regBuf = &engine->regBufs[i];
+
+            if (((UInt32)buf >= regBuf->virtAddr) &&
+                    ((UInt32)buf + size <= regBuf->virtAddr + regBuf->size)) {
+                return (regBuf->physAddr + ((UInt32)buf - regBuf->virtAddr));
+            }
+        }
+    }
+
+    return (Memory_getBufferPhysicalAddress(buf, size, NULL));
+}
+
 /*
  *  ======== Engine_getCpuLoad ========
  */
@@ -1977,6 +2030,9 @@ Engine_Handle Engine_open(String name, Engine_Attrs *attrs, Engine_Error *ec)
     engine->hasServer = FALSE;
     engine->remoteAlgTab = NULL;
     engine->numRemoteAlgs = 0;
+    engine->regBufs = NULL;
+    engine->numRegBufs = 0;
+    engine->maxRegBufs = 0;
 
     /*
      *  If we're getting trace from the DSP, make sure that the thread that
@@ -2014,6 +2070,129 @@ Engine_Handle Engine_open(String name, Engine_Attrs *attrs, Engine_Error *ec)
     return (engine);
 }
 
+/*
+ *  ======== Engine_registerBufs ========
+ */
+Engine_Error Engine_registerBufs(Engine_Handle engine, Ptr bufs[],
+    Int sizes[], Int numBufs)
+{
+    Engine_RegBuf *regBufs;
+    Engine_RegBuf *regBuf;
+    Engine_Error   status = Engine_EOK;
+    UInt32         physAddr;
+    Int            maxRegBufs;
+    Int            i;
+    Int            j;
+
+    GT_3trace(curTrace, GT_ENTER, "Engine_registerBufs> "
+        "Enter(engine=0x%x, bufs=0x%x, numBufs=%d)\n", engine, bufs, numBufs);
+
+    for (i = 0; i < numBufs; i++) {
+        if ((bufs[i] == NULL) || (sizes[i] <= 0)) {
+            status = Engine_EINVAL;
+            break;
+        }
+
+        j = findRegBuf(engine, (UInt32)bufs[i]);
+
+        if ((j < engine->numRegBufs) &&
+                (engine->regBufs[j].virtAddr == (UInt32)bufs[i]) &&
+                (engine->regBufs[j].size == (UInt32)sizes[i])) {
+            /* already registered, e.g. by another codec on this engine */
+            engine->regBufs[j].refCount++;
+            continue;
+        }
+
+        physAddr = Memory_getBufferPhysicalAddress(bufs[i], sizes[i], NULL);
+        if (physAddr == 0) {
+            GT_2trace(curTrace, GT_6CLASS, "Engine_registerBufs> "
+                "buffer 0x%x (size %d) is not contiguous\n", bufs[i],
+                sizes[i]);
+            status = Engine_EINVAL;
+            break;
+        }
+
+        if (engine->numRegBufs == engine->maxRegBufs) {
+            maxRegBufs = (engine->maxRegBufs > 0) ?
+                engine->maxRegBufs * 2 : 16;
+
+            regBufs = Memory_alloc(maxRegBufs * sizeof(Engine_RegBuf), NULL);
+            if (regBufs == NULL) {
+                status = Engine_ENOMEM;
+                break;
+            }
+
+            if (engine->regBufs != NULL) {
+                memcpy(regBufs, engine->regBufs,
+                        engine->numRegBufs * sizeof(Engine_RegBuf));
+                Memory_free(engine->regBufs,
+                        engine->maxRegBufs * sizeof(Engine_RegBuf), NULL);
+            }
+
+            engine->regBufs = regBufs;
+            engine->maxRegBufs = maxRegBufs;
+        }
+
+        regBuf = &engine->regBufs[j];
+        memmove(regBuf + 1, regBuf,
+                (engine->numRegBufs - j) * sizeof(Engine_RegBuf));
+        regBuf->virtAddr = (UInt32)bufs[i];
+        regBuf->size = sizes[i];
+        regBuf->physAddr = physAddr;
+        regBuf->refCount = 1;
+        engine->numRegBufs++;
+    }
+
+    if (status != Engine_EOK) {
+        /* undo the registrations done by this call */
+        Engine_unregisterBufs(engine, bufs, sizes, i);
+    }
+
+    GT_1trace(curTrace, GT_ENTER, "Engine_registerBufs> return(%d)\n",
+        status);
+
+    return (status);
+}
+
+/*
+ *  ======== Engine_unregisterBufs ========
+ */
+Engine_Error Engine_unregisterBufs(Engine_Handle engine, Ptr bufs[],
+    Int sizes[], Int numBufs)
+{
+    Engine_RegBuf *regBuf;
+    Engine_Error   status = Engine_EOK;
+    Int            i;
+    Int            j;
+
+    GT_3trace(curTrace, GT_ENTER, "Engine_unregisterBufs> "
+        "Enter(engine=0x%x, bufs=0x%x, numBufs=%d)\n", engine, bufs, numBufs);
+
+    for (i = 0; i < numBufs; i++) {
+        j = findRegBuf(engine, (UInt32)bufs[i]);
+
+        if ((j == engine->numRegBufs) ||
+                (engine->regBufs[j].virtAddr != (UInt32)bufs[i]) ||
+                (engine->regBufs[j].size != (UInt32)sizes[i])) {
+            status = Engine_ENOTFOUND;
+            continue;
+        }
+
+        regBuf = &engine->regBufs[j];
+
+        if (--regBuf->refCount == 0) {
+            engine->numRegBufs--;
+            memmove(regBuf, regBuf + 1,
+                    (engine->numRegBufs - j) * sizeof(Engine_RegBuf));
+        }
+    }
+
+    GT_1trace(curTrace, GT_ENTER, "Engine_unregisterBufs> return(%d)\n",
+        status);
+
+    return (status);
+}
+
 /*
  *  ======== Engine_setTrace ========
  */
@@ -2324,6 +2503,30 @@ static Int outputDspTrace(Char *cp, Int size, String prefix)
 }
 #endif
 
+/*
+ *  ======== findRegBuf ========
+ *  Returns the index of the first registered buffer at or past virtAddr,
+ *  which is numRegBufs if there is none.
+ */
+static Int findRegBuf(Engine_Obj *engine, UInt32 virtAddr)
+{
+    Int lo = 0;
+    Int hi = engine->numRegBufs;
+    Int mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (engine->regBufs[mid].virtAddr < virtAddr) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    return (lo);
+}
+
 /*
  *  ======== freeNode ========
  */
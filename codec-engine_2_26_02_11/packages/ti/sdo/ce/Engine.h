@@ -509,6 +509,15 @@ extern UInt32 Engine_getRemoteVisa(Engine_Node node);
 extern Ptr Engine_getCodecClassConfig(Engine_Handle engine, String name,
     String type);
 
+/*
+ *  ======== Engine_getBufferPhysicalAddress ========
+ *  Returns the physical address of a buffer registered by
+ *  Engine_registerBufs(), or translates it with
+ *  Memory_getBufferPhysicalAddress() if it isn't registered.
+ */
+extern UInt32 Engine_getBufferPhysicalAddress(Engine_Handle engine, Ptr buf,
+        Int size);
+
 /*
  *  ======== Engine_getNodeQueues ========
  */
@@ -896,6 +905,67 @@ extern Server_Handle Engine_getServer(Engine_Handle engine);
 extern UInt32 Engine_getUsedMem(Engine_Handle engine);
 
 
+/*
+ *  ======== Engine_registerBufs ========
+ */
+/**
+ *  @brief      Register buffers that will be passed repeatedly to the
+ *              remote codecs of an engine.
+ *
+ *  @param[in]  engine      The handle to the opened engine.
+ *  @param[in]  bufs        Array of @c numBufs buffer addresses.
+ *  @param[in]  sizes       Array of @c numBufs buffer sizes, in bytes.
+ *  @param[in]  numBufs     Number of buffers to register.
+ *
+ *  @retval     Engine_EOK      Success.
+ *  @retval     Engine_EINVAL   A buffer is NULL, empty or not physically
+ *                              contiguous.
+ *  @retval     Engine_ENOMEM   Memory allocation failed.
+ *
+ *  @pre        @c engine is a valid (non-NULL) engine handle and the engine
+ *              is in the open state.
+ *
+ *  @remarks    The physical address of each buffer is looked up once here;
+ *              the codec stubs then use it for any part of the buffer
+ *              instead of translating the address on every process call.
+ *
+ *  @remarks    A buffer may be registered several times, e.g. by two codecs
+ *              sharing it; it stays registered until it has been
+ *              unregistered as many times.
+ *
+ *  @remarks    On failure, none of the buffers in @c bufs are registered.
+ *
+ *  @remarks    Buffers must be unregistered before they are freed.
+ *
+ *  @sa         Engine_unregisterBufs()
+ */
+extern Engine_Error Engine_registerBufs(Engine_Handle engine, Ptr bufs[],
+        Int sizes[], Int numBufs);
+
+/*
+ *  ======== Engine_unregisterBufs ========
+ */
+/**
+ *  @brief      Unregister buffers registered by Engine_registerBufs().
+ *
+ *  @param[in]  engine      The handle to the opened engine.
+ *  @param[in]  bufs        Array of @c numBufs buffer addresses.
+ *  @param[in]  sizes       Array of @c numBufs buffer sizes, in bytes.
+ *  @param[in]  numBufs     Number of buffers to unregister.
+ *
+ *  @retval     Engine_EOK          Success.
+ *  @retval     Engine_ENOTFOUND    At least one of the buffers was not
+ *                                  registered with this address and size;
+ *                                  the others are unregistered.
+ *
+ *  @pre        @c engine is a valid (non-NULL) engine handle and the engine
+ *              is in the open state.
+ *
+ *  @sa         Engine_registerBufs()
+ */
+extern Engine_Error Engine_unregisterBufs(Engine_Handle engine, Ptr bufs[],
+        Int sizes[], Int numBufs);
+
 /*
  *  ======== Engine_setTrace ========
  */
@@ -102,6 +102,44 @@ typedef struct Algorithm_Attrs {
                              */
 } Algorithm_Attrs;
 
+/**
+ *  @brief      Algorithm activation statistics.
+ *
+ *  @sa         Algorithm_getActivationStat()
+ */
+typedef struct Algorithm_ActivationStat {
+    UInt32  numSwitches;    /**< Number of activations that acquired the
+                             *   scratch group lock.
+                             */
+    UInt32  numElided;      /**< Number of activations of the instance
+                             *   that was already active in its scratch
+                             *   group, for which both the deactivation
+                             *   and the activation were skipped.
+                             *   Currently always 0, since instances are
+                             *   deactivated before their group is released.
+                             */
+} Algorithm_ActivationStat;
+
+/**
+ *  @brief      Algorithm memory allocation statistics.
+ *
+ *  @sa         Algorithm_getMemStat()
+ */
+typedef struct Algorithm_MemStat {
+    UInt32  numBytesZeroed;     /**< Bytes of algorithm memory cleared
+                                 *   while creating instances.
+                                 */
+    UInt32  numBytesSkipped;    /**< Bytes of algorithm memory that the
+                                 *   configured zeroing policy
+                                 *   (ti_sdo_ce_alg_ALG_zeroMem) left as
+                                 *   allocated.
+                                 */
+    UInt32  numBytesRecycled;   /**< Bytes of algorithm memory reused from
+                                 *   deleted instances, which were cleared
+                                 *   when the instance was deleted.
+                                 */
+} Algorithm_MemStat;
+
 
 extern IALG_Handle _Algorithm_lockOwner[];
 
@@ -177,6 +215,10 @@ extern Void Algorithm_activate(Algorithm_Handle alg);
  *
  *  @pre        Algorithm_init() must have been called.
  *
+ *  @remarks    The instance is deactivated before its scratch group is
+ *              released, since the group may be shared with other
+ *              processes, which can't deactivate it on its behalf.
+ *
  *  @sa         Algorithm_activate()
  */
 extern Void Algorithm_deactivate(Algorithm_Handle alg);
@@ -252,6 +294,35 @@ extern Int Algorithm_getNumRecs(Algorithm_Handle alg);
 extern Int Algorithm_getMemRecs(Algorithm_Handle alg, IALG_MemRec *memTab,
         Int size);
 
+/*
+ *  ======== Algorithm_getActivationStat ========
+ */
+/**
+ *  @brief      Get the number of real and elided algorithm activations.
+ *
+ *  @param[out] statbuf Activation statistics.
+ *
+ *  @pre        Algorithm_init() must have been called.
+ *
+ *  @sa         Algorithm_deactivate()
+ */
+extern Void Algorithm_getActivationStat(Algorithm_ActivationStat *statbuf);
+
+/*
+ *  ======== Algorithm_getMemStat ========
+ */
+/**
+ *  @brief      Get the cumulative memory allocation statistics of the
+ *              algorithm instances created so far.
+ *
+ *  @param[out] statbuf Memory allocation statistics.
+ *
+ *  @pre        Algorithm_init() must have been called.
+ *
+ *  @sa         Algorithm_create()
+ */
+extern Void Algorithm_getMemStat(Algorithm_MemStat *statbuf);
+
 /*
  *  ======== Algorithm_init ========
  */
@@ -310,6 +310,27 @@ Void Algorithm_exit()
 }
 
 
+/*
+ *  ======== Algorithm_getActivationStat ========
+ */
+Void Algorithm_getActivationStat(Algorithm_ActivationStat *statbuf)
+{
+    /* DSKT2 does its own lazy deactivation, and doesn't count it */
+    statbuf->numSwitches = 0;
+    statbuf->numElided = 0;
+}
+
+/*
+ *  ======== Algorithm_getMemStat ========
+ */
+Void Algorithm_getMemStat(Algorithm_MemStat *statbuf)
+{
+    /* DSKT2 allocates algorithm memory, and doesn't count it */
+    statbuf->numBytesZeroed = 0;
+    statbuf->numBytesSkipped = 0;
+    statbuf->numBytesRecycled = 0;
+}
+
 /*
  *  ======== Algorithm_getAlgHandle ========
  */
@@ -45,6 +45,7 @@
 
 #include <ti/sdo/ce/osal/Memory.h>
 #include <ti/sdo/ce/osal/Global.h>
+#include <ti/sdo/ce/osal/Lock.h>
 
 #include "alg.h"
 
@@ -71,6 +72,18 @@ extern Void DMAN3_CE_exit();
 static Int curInit = FALSE;
 static GT_Mask curTrace = {NULL, NULL};
 
+/*
+ *  An instance is always deactivated before its scratch group lock is
+ *  released.  The group may be shared with other processes, which can't
+ *  deactivate our instances, and a process may start using the group at
+ *  any time, so an instance can't be left active once the lock is gone.
+ */
+static Lock_Handle statLock = NULL;         /* protects actStat */
+static Algorithm_ActivationStat actStat = {0, 0};
+
+static Void activate(Algorithm_Obj *pObject);
+static Void deactivate(Algorithm_Obj *pObject);
+
 /*
  *  ======== Algorithm_acquireLock ========
  */
@@ -81,6 +94,7 @@ Void Algorithm_acquireLock(Int groupId, IALG_Handle alg)
             " groupId=%d)\n", alg, groupId);
 
     ALG_acquireLock(groupId, alg);
+
     /* Would be NULL if noone else grabbed it, would be some other alg if
        some alg in some other thread grabbed it */
     _Algorithm_lockOwner[groupId] = alg;
@@ -111,18 +125,24 @@ Void Algorithm_releaseLock(Int groupId, IALG_Handle alg)
 Void Algorithm_activate(Algorithm_Handle alg)
 {
     Algorithm_Obj *pObject = (Algorithm_Obj *)alg;
+    Int            groupId = pObject->groupId;
 
     GT_1trace(curTrace, GT_ENTER, "Algorithm_activate> Enter(alg=0x%x)\n",
             alg);
 
-    ALG_activate(pObject->groupId, pObject->alg);
+    if ((0 <= groupId) && (groupId < _ALGORITHM_MAXGROUPS)) {
+        ALG_acquireLock(groupId, pObject->alg);
+        activate(pObject);
 
-    if (pObject->iresFxns) {
-        RMAN_activateAllResources(pObject->alg, pObject->iresFxns,
-                pObject->groupId);
+        Lock_acquire(statLock);
+        actStat.numSwitches++;
+        Lock_release(statLock);
+    }
+    else {
+        activate(pObject);
     }
 
-    _Algorithm_lockOwner[pObject->groupId] = pObject->alg;
+    _Algorithm_lockOwner[groupId] = pObject->alg;
 
     GT_0trace(curTrace, GT_ENTER, "Algorithm_activate> Exit\n");
 }
@@ -248,6 +268,7 @@ Algorithm_create_return:
 Void Algorithm_deactivate(Algorithm_Handle alg)
 {
     Algorithm_Obj *pObject = (Algorithm_Obj *)alg;
+    Int            groupId = pObject->groupId;
 
     GT_1trace(curTrace, GT_ENTER, "Algorithm_deactivate> Enter(alg=0x%x)\n",
             alg);
@@ -274,13 +295,12 @@ Void Algorithm_deactivate(Algorithm_Handle alg)
 
        _Algorithm_lockOwner[pObject->groupId] = NULL;
 
-        if (pObject->iresFxns) {
+        /* save its scratch before anyone, in any process, can take it */
+        deactivate(pObject);
 
-            RMAN_deactivateAllResources(pObject->alg, pObject->iresFxns,
-                    pObject->groupId);
+        if ((0 <= groupId) && (groupId < _ALGORITHM_MAXGROUPS)) {
+            ALG_releaseLock(groupId, pObject->alg);
         }
-
-        ALG_deactivate(pObject->groupId, pObject->alg);
     }
 
     GT_0trace(curTrace, GT_ENTER, "Algorithm_deactivate> Exit\n");
@@ -332,6 +352,14 @@ Void Algorithm_exit()
     GT_assert(curTrace, curInit > 0);
 
     if (--curInit == 0) {
+        if (statLock != NULL) {
+            Lock_delete(statLock);
+            statLock = NULL;
+        }
+
+        actStat.numSwitches = 0;
+        actStat.numElided = 0;
+
         ALG_exit();
 
         DMAN3_CE_exit();
@@ -340,6 +368,32 @@ Void Algorithm_exit()
 }
 
 
+/*
+ *  ======== Algorithm_getActivationStat ========
+ */
+Void Algorithm_getActivationStat(Algorithm_ActivationStat *statbuf)
+{
+    Lock_acquire(statLock);
+
+    *statbuf = actStat;
+
+    Lock_release(statLock);
+}
+
+/*
+ *  ======== Algorithm_getMemStat ========
+ */
+Void Algorithm_getMemStat(Algorithm_MemStat *statbuf)
+{
+    ALG_MemStat algStat;
+
+    ALG_getMemStat(&algStat);
+
+    statbuf->numBytesZeroed = algStat.numBytesZeroed;
+    statbuf->numBytesSkipped = algStat.numBytesSkipped;
+    statbuf->numBytesRecycled = algStat.numBytesRecycled;
+}
+
 /*
  *  ======== Algorithm_getAlgHandle ========
  */
@@ -383,6 +437,10 @@ Void Algorithm_init()
         RMAN_init();
         DMAN3_CE_init();
 
+        statLock = Lock_create(NULL);
+
+        GT_assert(curTrace, statLock != NULL);
+
         /*
          *  NOTE: We are calling ALG_init() here rather than calling it in
          *  CERuntime_init(). This simplifies the auto-generation of
@@ -409,6 +467,36 @@ Void Algorithm_removeGroup(Int groupId)
 
     GT_0trace(curTrace, GT_ENTER, "Algorithm_removeGroup> Exit\n");
 }
+
+/*
+ *  ======== activate ========
+ *  Activate an instance, whose group lock the caller holds.
+ */
+static Void activate(Algorithm_Obj *pObject)
+{
+    /* -1: the group lock is taken separately */
+    ALG_activate(-1, pObject->alg);
+
+    if (pObject->iresFxns) {
+        RMAN_activateAllResources(pObject->alg, pObject->iresFxns,
+                pObject->groupId);
+    }
+}
+
+/*
+ *  ======== deactivate ========
+ *  Deactivate an instance, whose group lock the caller holds.
+ */
+static Void deactivate(Algorithm_Obj *pObject)
+{
+    if (pObject->iresFxns) {
+        RMAN_deactivateAllResources(pObject->alg, pObject->iresFxns,
+                pObject->groupId);
+    }
+
+    /* -1: the group lock is released separately */
+    ALG_deactivate(-1, pObject->alg);
+}
 /*
  *  @(#) ti.sdo.ce.alg; 1, 0, 1,191; 12-2-2010 21:18:41; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
 
@@ -40,7 +40,7 @@
 extern "C" {
 #endif
 
-#include <ti/sdo/ce/osal/SemMP.h>
+#include <ti/sdo/ce/osal/LockMP.h>
 
 /**
  *  Number of group Ids for algorithms sharing resources. These group Ids
@@ -53,19 +53,19 @@ extern unsigned int ti_sdo_ce_alg_ALG_maxGroups;
 #define _ALG_NUMGROUPS ti_sdo_ce_alg_ALG_maxGroups
 
 
-extern SemMP_Handle _ALG_sems[];
+extern LockMP_Handle _ALG_locks[];
 
 /* Auto-generated by Settings.xdt */
 extern int _ALG_groupUsed[];
 extern Int _ALG_groupRefCount[];
 
 /*
- *  ======== _ALG_sems ========
+ *  ======== _ALG_locks ========
  */
 /**
- *  Semaphores for aquiring resources for algorithms of a given group Id.
+ *  Locks for aquiring resources for algorithms of a given group Id.
  */
-extern SemMP_Handle _ALG_sems[];
+extern LockMP_Handle _ALG_locks[];
 
 
 /*
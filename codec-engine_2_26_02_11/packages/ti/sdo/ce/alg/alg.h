@@ -65,6 +65,9 @@ typedef IALG_Handle ALG_Handle;
  *  @param[in] groupId  Group which @c alg is associated with.
  *  @param[in] alg      Handle of algorithm to activate.
  *
+ *  @remarks    The group's lock is acquired first, unless @c groupId is
+ *              out of range (eg, -1, when the caller already holds it).
+ *
  *  @todo       Typically handles are the first params passed to a fxn.
  *  @todo       Could we store the groupId in the alg handle at create time
  *              so we don't need to supply it to ALG_delete()?
@@ -115,6 +118,39 @@ typedef enum ALG_CachedMemType {
     ALG_USECACHEDMEM_CACHED = 1     /**< Use cached memory */
 } ALG_CachedMemType;
 
+/**
+ *  @brief      Which algorithm memTabs are cleared when they are allocated.
+ *              The policy in effect is set by ti_sdo_ce_alg_ALG_zeroMem.
+ *
+ *  @remarks    memTab[0], the instance object, is always cleared.
+ *
+ *  @enumWarning
+ */
+typedef enum ALG_ZeroMemPolicy {
+    ALG_ZEROMEM_ALL = 0,        /**< Clear every memTab */
+    ALG_ZEROMEM_PERSIST = 1,    /**< Clear persistent and write-once
+                                 *   memTabs, leave scratch memTabs as
+                                 *   allocated
+                                 */
+    ALG_ZEROMEM_NONE = 2        /**< Only clear the instance object */
+} ALG_ZeroMemPolicy;
+
+/**
+ *  @brief      Algorithm memory allocation statistics.
+ *
+ *  @sa         ALG_getMemStat()
+ */
+typedef struct ALG_MemStat {
+    UInt32  numBytesZeroed;     /**< Bytes cleared when allocated */
+    UInt32  numBytesSkipped;    /**< Bytes not cleared due to the
+                                 *   zeroing policy
+                                 */
+    UInt32  numBytesRecycled;   /**< Bytes taken from memTabs of deleted
+                                 *   algorithms, which were cleared when
+                                 *   they were freed
+                                 */
+} ALG_MemStat;
+
 
 /*
  *  ======== ALG_create ========
@@ -147,6 +183,9 @@ extern ALG_Handle ALG_create(Int groupId, IALG_Fxns *fxns, IALG_Handle p,
  *  @param[in] groupId  Group which @c alg is associated with.
  *  @param[in] alg      Handle of algorithm to deactivate.
  *
+ *  @remarks    The group's lock is released last, unless @c groupId is
+ *              out of range (eg, -1, when the caller releases it itself).
+ *
  *  @todo       Typically handles are the first params passed to a fxn.
  *  @todo       Could we store the groupId in the alg handle at create time
  *              so we don't need to supply it to ALG_delete()?
@@ -201,6 +240,17 @@ extern Void ALG_acquireLock(Int groupId, IALG_Handle alg);
 
 extern Void ALG_releaseLock(Int groupId, IALG_Handle alg);
 
+/*
+ *  ======== ALG_getMemStat ========
+ */
+/**
+ *  @brief      Get the cumulative memory allocation statistics of all
+ *              algorithms created with ALG_create().
+ *
+ *  @param[out] statbuf     Location to store the statistics.
+ */
+extern Void ALG_getMemStat(ALG_MemStat *statbuf);
+
 /*
  *  ======== ALG_removeGroup ========
  */
@@ -48,7 +48,8 @@
 
 #include <xdc/std.h>
 
-#include <ti/sdo/ce/osal/SemMP.h>
+#include <ti/sdo/ce/osal/LockMP.h>
+#include <ti/sdo/ce/osal/Lock.h>
 
 #include <ti/sdo/ce/osal/Memory.h>
 
@@ -73,22 +74,52 @@ GT_Mask ti_sdo_ce_alg_GTMask;
 
 
 /*
- *  Base ID for semaphores in this module. This is auto-generated by
+ *  Base ID for the group locks of this module. This is auto-generated by
  *  Settings.xdt.
  */
 extern UInt32 ti_sdo_ce_alg_ipcKey;
 
+/*
+ *  Which memTabs _ALG_allocMemory2() clears (see ALG_ZeroMemPolicy), and how
+ *  many bytes of freed memTabs _ALG_freeMemory2() may keep, pre-zeroed, for
+ *  reuse by the next algorithm created.
+ */
+extern UInt32 ti_sdo_ce_alg_ALG_zeroMem;
+extern UInt32 ti_sdo_ce_alg_ALG_recycleSize;
+
+/*
+ *  ======== Recycled ========
+ *  A freed memTab block, zeroed and waiting for a memTab with the same size,
+ *  alignment and cache attribute.
+ */
+typedef struct Recycled {
+    struct Recycled    *next;
+    Ptr                 base;
+    Int                 size;
+    UInt                align;
+    UInt                flags;
+} Recycled;
 
 static Int curInit = 0;     /* module init counter */
 
+static Recycled *recycled = NULL;       /* freed blocks kept for reuse */
+static UInt32 recycledSize = 0;         /* total size of recycled blocks */
+static Lock_Handle recycleLock = NULL;  /* protects the recycled list */
+static ALG_MemStat memStat = {0, 0, 0};
+
+static Ptr getRecycled(Int size, Memory_AllocParams *params);
+static Bool putRecycled(Ptr base, Int size, Memory_AllocParams *params);
+static Void flushRecycled(Void);
+static Bool needsZero(IALG_MemRec *memRec, Int i);
+
 /*
  *  ======== ALG_releaseLock ========
  */
 Void ALG_releaseLock(Int groupId, IALG_Handle alg)
 {
     if ((0 <= groupId) && (groupId < _ALG_NUMGROUPS)) {
-        GT_assert(CURTRACE, _ALG_sems[groupId] != NULL);
-        SemMP_post(_ALG_sems[groupId]);
+        GT_assert(CURTRACE, _ALG_locks[groupId] != NULL);
+        LockMP_release(_ALG_locks[groupId]);
     }
 }
 
@@ -100,8 +131,8 @@ Void ALG_acquireLock(Int groupId, IALG_Handle alg)
     /* acquire lock */
     /* TODO:M what if groupId is out of range?  At least drop some trace? */
     if ((0 <= groupId) && (groupId < _ALG_NUMGROUPS)) {
-        GT_assert(CURTRACE, _ALG_sems[groupId] != NULL);
-        SemMP_pend(_ALG_sems[groupId], SemMP_FOREVER);
+        GT_assert(CURTRACE, _ALG_locks[groupId] != NULL);
+        LockMP_acquire(_ALG_locks[groupId]);
     }
 }
 
@@ -113,8 +144,8 @@ Void ALG_activate(Int groupId, ALG_Handle alg)
     /* acquire lock */
     /* TODO:M what if groupId is out of range?  At least drop some trace? */
     if ((0 <= groupId) && (groupId < _ALG_NUMGROUPS)) {
-        GT_assert(CURTRACE, _ALG_sems[groupId] != NULL);
-        SemMP_pend(_ALG_sems[groupId], SemMP_FOREVER);
+        GT_assert(CURTRACE, _ALG_locks[groupId] != NULL);
+        LockMP_acquire(_ALG_locks[groupId]);
     }
 
     /* restore all persistant shared memory */
@@ -144,13 +175,13 @@ Bool ALG_addGroup(Int groupId)
     }
 
     if (_ALG_groupRefCount[groupId] == 0) {
-        /* Create a semaphore for this groupId */
+        /* Create a lock for this groupId */
         key = (Int)ti_sdo_ce_alg_ipcKey + groupId;
-         _ALG_sems[groupId] = SemMP_create(key, 1);
+        _ALG_locks[groupId] = LockMP_create(key);
 
-        if (_ALG_sems[groupId] == NULL) {
+        if (_ALG_locks[groupId] == NULL) {
             GT_1trace(CURTRACE, GT_7CLASS, "ALG_addGroup> Failed to create "
-                    "semaphore for groupId %d\n", groupId);
+                    "lock for groupId %d\n", groupId);
             retVal = FALSE;
         }
     }
@@ -182,8 +213,8 @@ Void ALG_deactivate(Int groupId, ALG_Handle alg)
     /* TODO:M what if groupId is out of range?  At least drop some trace? */
 
     if ((0 <= groupId) && (groupId < _ALG_NUMGROUPS)) {
-        GT_assert(CURTRACE, _ALG_sems[groupId] != NULL);
-        SemMP_post(_ALG_sems[groupId]);
+        GT_assert(CURTRACE, _ALG_locks[groupId] != NULL);
+        LockMP_release(_ALG_locks[groupId]);
     }
 }
 
@@ -195,11 +226,19 @@ Void ALG_exit(Void)
     Int i;
 
     if (--curInit == 0) {
-        /* De-initialize semaphores */
+        /* Give recycled memTabs back to the allocator */
+        flushRecycled();
+
+        if (recycleLock != NULL) {
+            Lock_delete(recycleLock);
+            recycleLock = NULL;
+        }
+
+        /* De-initialize group locks */
         for (i = 0; i < _ALG_NUMGROUPS; i++) {
-            if (_ALG_sems[i]) {
-                SemMP_delete(_ALG_sems[i]);
-                _ALG_sems[i] = NULL;
+            if (_ALG_locks[i]) {
+                LockMP_delete(_ALG_locks[i]);
+                _ALG_locks[i] = NULL;
             }
         }
     }
@@ -217,14 +256,22 @@ Void ALG_init(Void)
         GT_create(&CURTRACE, ALG_GTNAME);
         GT_0trace(CURTRACE, GT_ENTER, "ALG_init> Enter\n");
 
-        /* Initialize semaphores with count 1 */
+        if (ti_sdo_ce_alg_ALG_recycleSize > 0) {
+            recycleLock = Lock_create(NULL);
+        }
+
+        /*
+         *  Initialize group locks. These are robust LockMP's rather than
+         *  SemMP's, so a process that dies while one of its algorithms is
+         *  active doesn't leave the group locked for everyone else.
+         */
         for (i = 0; i < _ALG_NUMGROUPS; i++) {
             if (_ALG_groupUsed[i]) {
-                _ALG_sems[i] = SemMP_create((Int)ti_sdo_ce_alg_ipcKey + i, 1);
+                _ALG_locks[i] = LockMP_create((Int)ti_sdo_ce_alg_ipcKey + i);
                 _ALG_groupRefCount[i] = 1;
             }
             else {
-                _ALG_sems[i] = NULL;
+                _ALG_locks[i] = NULL;
             }
         }
 
@@ -242,6 +289,14 @@ Void ALG_init(Void)
 }
 
 
+/*
+ *  ======== ALG_getMemStat ========
+ */
+Void ALG_getMemStat(ALG_MemStat *statbuf)
+{
+    *statbuf = memStat;
+}
+
 /*
  *  ======== ALG_removeGroup ========
  */
@@ -257,9 +312,9 @@ Void ALG_removeGroup(Int groupId)
     }
 
     if (--_ALG_groupRefCount[groupId] == 0) {
-        /* Delete semaphore for this groupId */
-        SemMP_delete(_ALG_sems[groupId]);
-        _ALG_sems[groupId] = NULL;
+        /* Delete the lock for this groupId */
+        LockMP_delete(_ALG_locks[groupId]);
+        _ALG_locks[groupId] = NULL;
     }
 
     GT_0trace(CURTRACE, GT_ENTER, "ALG_removeGroup> Exit.\n");
@@ -318,13 +373,33 @@ Bool _ALG_allocMemory2(IALG_MemRec memTab[], Int n, UInt32 useCachedMem)
 
     for (i = 0; i < n; i++) {
         params.align = memTab[i].alignment;
+
+        /* a recycled block was zeroed when it was freed */
+        memTab[i].base = getRecycled(memTab[i].size, &params);
+        if (memTab[i].base != NULL) {
+            continue;
+        }
+
         memTab[i].base = Memory_alloc(memTab[i].size, &params);
 
+        if ((memTab[i].base == NULL) && (recycled != NULL)) {
+            /* the recycled blocks may be what is keeping us from fitting */
+            flushRecycled();
+            memTab[i].base = Memory_alloc(memTab[i].size, &params);
+        }
+
         if (memTab[i].base == NULL) {
             _ALG_freeMemory2(memTab, i, useCachedMem);
             return (FALSE);
         }
-        memset(memTab[i].base, 0, memTab[i].size);
+
+        if (needsZero(&memTab[i], i)) {
+            memset(memTab[i].base, 0, memTab[i].size);
+            memStat.numBytesZeroed += memTab[i].size;
+        }
+        else {
+            memStat.numBytesSkipped += memTab[i].size;
+        }
     }
 
     GT_0trace(CURTRACE, GT_ENTER, "_ALG_allocMemory2> Returning (TRUE)\n");
@@ -379,11 +454,142 @@ Void _ALG_freeMemory2(IALG_MemRec memTab[], Int n, UInt32 useCachedMem)
     }
 
     for (i = 0; i < n; i++) {
-        if (memTab[i].base != NULL) {
+        params.align = memTab[i].alignment;
+        if ((memTab[i].base != NULL) &&
+                !putRecycled(memTab[i].base, memTab[i].size, &params)) {
             Memory_free(memTab[i].base, memTab[i].size, &params);
         }
     }
 }
+
+/*
+ *  ======== getRecycled ========
+ *  Take a recycled block matching the request off the list, or return NULL.
+ */
+static Ptr getRecycled(Int size, Memory_AllocParams *params)
+{
+    Recycled **prev;
+    Recycled *rec;
+    Ptr base = NULL;
+
+    if (recycleLock == NULL) {
+        return (NULL);
+    }
+
+    Lock_acquire(recycleLock);
+
+    for (prev = &recycled; (rec = *prev) != NULL; prev = &rec->next) {
+        if ((rec->size == size) && (rec->align == params->align) &&
+                (rec->flags == params->flags)) {
+            *prev = rec->next;
+            recycledSize -= size;
+            memStat.numBytesRecycled += size;
+            base = rec->base;
+            free(rec);
+            break;
+        }
+    }
+
+    Lock_release(recycleLock);
+
+    return (base);
+}
+
+/*
+ *  ======== putRecycled ========
+ *  Zero a freed block and keep it for reuse, if there is room for it.
+ */
+static Bool putRecycled(Ptr base, Int size, Memory_AllocParams *params)
+{
+    Recycled *rec;
+
+    if ((recycleLock == NULL) ||
+            (recycledSize + size > ti_sdo_ce_alg_ALG_recycleSize)) {
+        return (FALSE);
+    }
+
+    if ((rec = (Recycled *)malloc(sizeof(Recycled))) == NULL) {
+        return (FALSE);
+    }
+
+    /* zero it now, so the create that reuses it doesn't have to */
+    memset(base, 0, size);
+
+    rec->base = base;
+    rec->size = size;
+    rec->align = params->align;
+    rec->flags = params->flags;
+
+    Lock_acquire(recycleLock);
+
+    /* check again, another thread may have recycled a block meanwhile */
+    if (recycledSize + size > ti_sdo_ce_alg_ALG_recycleSize) {
+        Lock_release(recycleLock);
+        free(rec);
+        return (FALSE);
+    }
+
+    rec->next = recycled;
+    recycled = rec;
+    recycledSize += size;
+
+    Lock_release(recycleLock);
+
+    return (TRUE);
+}
+
+/*
+ *  ======== flushRecycled ========
+ *  Free all recycled blocks.
+ */
+static Void flushRecycled(Void)
+{
+    Recycled *list;
+    Recycled *rec;
+    Memory_AllocParams params;
+
+    if (recycleLock == NULL) {
+        return;
+    }
+
+    Lock_acquire(recycleLock);
+    list = recycled;
+    recycled = NULL;
+    recycledSize = 0;
+    Lock_release(recycleLock);
+
+    params = Memory_DEFAULTPARAMS;
+    params.type = ti_sdo_ce_alg_ALG_useHeap ? Memory_CONTIGHEAP :
+        Memory_CONTIGPOOL;
+
+    while ((rec = list) != NULL) {
+        list = rec->next;
+        params.align = rec->align;
+        params.flags = rec->flags;
+        Memory_free(rec->base, rec->size, &params);
+        free(rec);
+    }
+}
+
+/*
+ *  ======== needsZero ========
+ *  Whether memTab[i] must be cleared under the configured zeroing policy.
+ *  memTab[0] is the instance object, whose fields besides fxns the algorithm
+ *  may rely on being zero, so it is always cleared.
+ */
+static Bool needsZero(IALG_MemRec *memRec, Int i)
+{
+    switch (ti_sdo_ce_alg_ALG_zeroMem) {
+        case ALG_ZEROMEM_NONE:
+            return (i == 0);
+
+        case ALG_ZEROMEM_PERSIST:
+            return ((i == 0) || (memRec->attrs != IALG_SCRATCH));
+
+        default:
+            return (TRUE);
+    }
+}
 /*
  *  @(#) ti.sdo.ce.alg; 1, 0, 1,191; 12-2-2010 21:18:41; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
 
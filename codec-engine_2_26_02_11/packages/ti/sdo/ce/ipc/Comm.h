@@ -143,7 +143,9 @@ extern Int Comm_put(Comm_Queue queue, Comm_Msg msg);
 
 /*
  *  ======== Comm_get ========
- *  Recieve a message from the specified queue
+ *  Recieve a message from the specified queue.  Returns Comm_ETIMEOUT if
+ *  no message arrives within timeout, whose units depend on the transport
+ *  (microseconds for the Linux transport).
  */
 extern Int Comm_get(Comm_Queue queue, Comm_Msg *msg, UInt timeout);
 
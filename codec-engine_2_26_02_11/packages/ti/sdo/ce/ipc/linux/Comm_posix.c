@@ -32,6 +32,24 @@
  */
 /*
  *  ======== Comm_posix.c ========
+ *  Comm transport for GPP-side servers running in another Linux process.
+ *
+ *  All processes of a user attach to one shared memory segment holding a
+ *  pool of messages and a table of named queues.  A queue is a bounded
+ *  lock-free ring of message indices, so Comm_put() and Comm_get() pass
+ *  messages by reference without copying them, and allocate nothing.  A
+ *  receiver blocks on a futex in the queue, which is only woken by senders
+ *  when someone is waiting.  Timeouts are in microseconds, and are measured
+ *  against an absolute deadline on the monotonic clock.
+ *
+ *  Each attached process holds a read lock on the segment file.  The first
+ *  process to attach (i.e. the one that gets the write lock) initializes
+ *  the segment, sized by ti_sdo_ce_ipc_linux_Comm_numMsgs and
+ *  ti_sdo_ce_ipc_linux_Comm_numQueues, so state left over by processes
+ *  that died is discarded once they are all gone.  Until then, messages
+ *  and queues are tagged with the process that owns them, and those of
+ *  processes that died are reclaimed when the pool or the queue table runs
+ *  out.
  */
 
 #include <xdc/std.h>
@@ -41,10 +59,17 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
 
+#include <signal.h>
 #include <sys/types.h>
-#include <sys/ipc.h>
-#include <sys/msg.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include <ti/sdo/ce/osal/Memory.h>
 #include <ti/sdo/ce/ipc/Comm.h>
@@ -52,8 +77,64 @@
 #include <ti/sdo/utils/trace/gt.h>
 
 #define MSGSIZE     0x1000  /* maximum message size */
-#define MSGTYPE     43      /* must be > 0 */
+#define MAXNAMELEN  48      /* maximum queue name length, including '\0' */
 #define MAXRETRY    10      /* number of times to try to locate a queue */
+#define MAXMSGS     0x10000 /* upper bound of the message pool */
+
+#define SHMMAGIC    0x434f4d4d  /* 'COMM' */
+
+#define CACHEALIGN(x)   (((x) + 127) & ~(size_t)127)
+
+/*
+ *  Number of messages in the pool (rounded up to a power of 2) and of
+ *  queues in the segment.  They only apply to the process that creates the
+ *  segment; processes that attach later use the sizes of the existing one.
+ */
+extern UInt32 ti_sdo_ce_ipc_linux_Comm_numMsgs;
+extern UInt32 ti_sdo_ce_ipc_linux_Comm_numQueues;
+
+/*
+ *  Bounded multi-producer/multi-consumer ring of message indices.  Each
+ *  cell's sequence number tells whether it is ready to be written (seq ==
+ *  position) or read (seq == position + 1) for a given lap of the ring.
+ */
+typedef struct Comm_Cell {
+    volatile UInt32 seq;
+    UInt32          msgIdx;
+} Comm_Cell;
+
+typedef struct Comm_Ring {
+    volatile UInt32 tail;               /* next position to put to */
+    UInt32          pad0[15];           /* keep head and tail in separate
+                                         * cache lines */
+    volatile UInt32 head;               /* next position to get from */
+    UInt32          pad1[15];
+    UInt32          cells;              /* offset of the numMsgs cells in
+                                         * the segment */
+} Comm_Ring;
+
+typedef struct Comm_QueueObj {
+    Char            name[MAXNAMELEN];   /* "" if the queue is free */
+    pid_t           owner;              /* process that created it */
+    volatile Int    event;              /* futex, bumped on every put */
+    volatile Int    waiters;            /* number of blocked receivers */
+    Comm_Ring       ring;
+} Comm_QueueObj;
+
+/*
+ *  The header is followed by the queue table, the cells of all rings, the
+ *  owner of each message (0 while it is free or queued), and the messages,
+ *  the table and the messages aligned on a cache line.
+ */
+typedef struct Comm_Shm {
+    UInt32          magic;
+    UInt32          size;
+    UInt32          numMsgs;
+    UInt32          numQueues;
+    pthread_mutex_t lock;               /* serializes queue create/delete
+                                         * and reclaiming */
+    Comm_Ring       freeMsgs;
+} Comm_Shm;
 
 typedef struct Comm_Obj {
     Int             id;
@@ -70,18 +151,43 @@ Comm_Attrs Comm_ATTRS = {
     Comm_PEND
 };
 
-static Int nameToId(String name);
+static Bool attach(Void);
+static Void detach(Void);
+static Void drainQueue(Comm_QueueObj *q);
+static Void forkChild(Void);
+static Void initRing(Comm_Ring *ring, UInt32 cells, Bool full);
+static Bool isAlive(pid_t pid);
+static Void reclaim(Void);
+static Bool ringGet(Comm_Ring *ring, UInt32 *msgIdx);
+static Bool ringPut(Comm_Ring *ring, UInt32 msgIdx);
+static Int findQueue(String name);
+static Void layout(UInt32 nMsgs, UInt32 nQueues, size_t *cellsOff,
+    size_t *ownersOff, size_t *msgsOff, size_t *size);
+static Void lockShm(Void);
+static Void unlockShm(Void);
+
 static String userName = "";
 
 static Int curInit = 0;                 /* module init counter */
 static GT_Mask curTrace = {NULL,NULL};
 
+static Int shmFd = -1;
+static Comm_Shm *shm = NULL;
+static size_t shmSize = 0;
+static UInt32 numMsgs = 0;
+static UInt32 numQueues = 0;
+static Comm_QueueObj *queues = NULL;
+static volatile pid_t *owners = NULL;   /* owner of each message */
+static Char *msgs = NULL;               /* base of the message pool */
+static pid_t curPid = 0;
+
 /*
  *  ======== Comm_alloc ========
  */
 Int Comm_alloc(UInt16 poolId, Comm_Msg *msg, UInt16 size)
 {
     Comm_Msg   mbuf;
+    UInt32     msgIdx;
     Int        retVal = Comm_EFAIL;    /* pessimistic */
 
     GT_assert(curTrace, curInit > 0);
@@ -100,12 +206,28 @@ Int Comm_alloc(UInt16 poolId, Comm_Msg *msg, UInt16 size)
         return (Comm_EFAIL);
     }
 
-    if ((mbuf = (Comm_Msg)Memory_alloc(MSGSIZE, NULL)) != NULL) {
+    if (!ringGet(&shm->freeMsgs, &msgIdx)) {
+        /* take back what processes that died were holding, and retry */
+        lockShm();
+        reclaim();
+        unlockShm();
+
+        if (!ringGet(&shm->freeMsgs, &msgIdx)) {
+            msgIdx = numMsgs;
+        }
+    }
+
+    if (msgIdx < numMsgs) {
+        owners[msgIdx] = curPid;
+        mbuf = (Comm_Msg)(msgs + msgIdx * MSGSIZE);
         mbuf->size = MSGSIZE;
-        *((long *)mbuf) = MSGTYPE; /* must be > 0 */
         *msg = mbuf;
         retVal = Comm_EOK;
     }
+    else {
+        GT_1trace(curTrace, GT_7CLASS, "Comm_alloc> all %d messages are in "
+                "use\n", numMsgs);
+    }
 
     GT_2trace(curTrace, GT_ENTER, "Comm_alloc> msg=0x%x, returning (%d)\n",
         *msg, retVal);
@@ -119,8 +241,9 @@ Int Comm_alloc(UInt16 poolId, Comm_Msg *msg, UInt16 size)
 Comm_Handle Comm_create(String queueName, Comm_Queue *queue,
     Comm_Attrs *attrs)
 {
-    Comm_Obj *comm;
-    key_t key = nameToId(queueName);
+    Comm_Obj      *comm;
+    Comm_QueueObj *q;
+    Int            id;
 
     GT_assert(curTrace, curInit > 0);
 
@@ -132,6 +255,12 @@ Comm_Handle Comm_create(String queueName, Comm_Queue *queue,
         attrs = &Comm_ATTRS;
     }
 
+    if (strlen(queueName) >= MAXNAMELEN) {
+        GT_2trace(curTrace, GT_7CLASS, "Comm_create> queue name '%s' is "
+                "longer than %d characters\n", queueName, MAXNAMELEN - 1);
+        return (NULL);
+    }
+
     comm = (Comm_Obj *)Memory_alloc(sizeof(Comm_Obj), NULL);
     if (comm == NULL) {
         return (NULL);
@@ -150,16 +279,39 @@ Comm_Handle Comm_create(String queueName, Comm_Queue *queue,
         GT_assert(curTrace, FALSE);  /* unknown Comm type */
     }
 
+    lockShm();
+
     /*
-     * Create a new message queue id for the "name" key
+     * Reuse the queue if it was left behind by a process that didn't
+     * delete it, otherwise take a free one.
      */
-    if ((comm->id = msgget(key, IPC_CREAT | 0644)) < 0) {
-        fprintf(stderr, "msgget key = 0x%x\n", key);
-        perror("Comm_create:msgget");
+    if ((id = findQueue(queueName)) < 0) {
+        if ((id = findQueue("")) < 0) {
+            reclaim();
+            id = findQueue("");
+        }
+    }
+
+    if (id >= 0) {
+        q = &queues[id];
+
+        /* return messages still queued from a previous owner to the pool */
+        drainQueue(q);
+
+        strcpy(q->name, queueName);
+        q->owner = curPid;
+    }
+
+    unlockShm();
+
+    if (id < 0) {
+        GT_1trace(curTrace, GT_7CLASS, "Comm_create> all %d queues are in "
+                "use\n", numQueues);
         Memory_free(comm, sizeof(Comm_Obj), NULL);
         return (NULL);
     }
 
+    comm->id = id;
     *queue = comm->id;
 
     GT_1trace(curTrace, GT_ENTER, "Comm_create> return (0x%x)\n", comm);
@@ -172,6 +324,8 @@ Comm_Handle Comm_create(String queueName, Comm_Queue *queue,
  */
 Void Comm_delete(Comm_Handle comm)
 {
+    Comm_QueueObj *q;
+
     GT_assert(curTrace, curInit > 0);
 
     GT_1trace(curTrace, GT_ENTER, "Comm_delete> "
@@ -179,7 +333,15 @@ Void Comm_delete(Comm_Handle comm)
 
     if (comm != NULL) {
         if (comm->id >= 0) {
-            msgctl(comm->id, IPC_RMID, NULL);
+            q = &queues[comm->id];
+
+            lockShm();
+
+            drainQueue(q);
+            q->name[0] = '\0';
+            q->owner = 0;
+
+            unlockShm();
         }
         Memory_free(comm, sizeof(Comm_Obj), NULL);
     }
@@ -196,6 +358,7 @@ Void Comm_exit(Void)
     GT_assert(curTrace, curInit > 0);
 
     if (--curInit == 0) {
+        detach();
         Memory_exit();
     }
 }
@@ -206,11 +369,15 @@ Void Comm_exit(Void)
  */
 Int Comm_free(Comm_Msg msg)
 {
+    UInt32 msgIdx;
+
     GT_assert(curTrace, curInit > 0);
 
     GT_1trace(curTrace, GT_ENTER, "Comm_free> Enter (msg=0x%x)\n", msg);
 
-    Memory_free(msg, msg->size, NULL);
+    msgIdx = ((Char *)msg - msgs) / MSGSIZE;
+    owners[msgIdx] = 0;
+    ringPut(&shm->freeMsgs, msgIdx);
 
     return (Comm_EOK);
 }
@@ -221,8 +388,11 @@ Int Comm_free(Comm_Msg msg)
  */
 Int Comm_get(Comm_Queue queue, Comm_Msg *msg, UInt timeout)
 {
-    Comm_Msg tmp;
-    Int len;
+    Comm_QueueObj  *q;
+    UInt32          msgIdx;
+    Int             event;
+    struct timespec deadline;
+    struct timespec *dp = NULL;
 
     GT_assert(curTrace, curInit > 0);
 
@@ -231,21 +401,73 @@ Int Comm_get(Comm_Queue queue, Comm_Msg *msg, UInt timeout)
 
     *msg = NULL;
 
-    if (Comm_alloc(0, &tmp, MSGSIZE) == Comm_EOK) {
-        do {
-            len = msgrcv(queue, tmp, MSGSIZE - sizeof(long), MSGTYPE, 0);
-            if (len >= 0) {
-                tmp->size = MSGSIZE;
-                *msg = tmp;
-                return (Comm_EOK);
-            }
-        } while (errno == EINTR);
+    if (queue >= numQueues) {
+        return (Comm_EFAIL);
+    }
+
+    q = &queues[queue];
+
+    if (timeout != Comm_FOREVER && timeout != Comm_POLL) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout / 1000000;
+        deadline.tv_nsec += (timeout % 1000000) * 1000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        dp = &deadline;
+    }
+
+    while (!ringGet(&q->ring, &msgIdx)) {
+        if (timeout == Comm_POLL) {
+            return (Comm_ETIMEOUT);
+        }
+
+        /*
+         * Sample the event count, then announce ourselves and check the
+         * ring again; a put that our second check misses must bump the
+         * event count after we sampled it, so the wait returns at once.
+         */
+        event = q->event;
+        __sync_fetch_and_add(&q->waiters, 1);
+
+        if (ringGet(&q->ring, &msgIdx)) {
+            __sync_fetch_and_sub(&q->waiters, 1);
+            break;
+        }
 
-        perror("Comm_get");
-        Comm_free(tmp);
+        /*
+         * FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline, so
+         * spurious wakeups and signals don't extend the total wait.
+         */
+        if (syscall(SYS_futex, &q->event, FUTEX_WAIT_BITSET, event, dp,
+                NULL, FUTEX_BITSET_MATCH_ANY) < 0) {
+            __sync_fetch_and_sub(&q->waiters, 1);
+
+            if (errno == ETIMEDOUT) {
+                /* one last look, a put may have raced with the timeout */
+                if (ringGet(&q->ring, &msgIdx)) {
+                    break;
+                }
+                GT_1trace(curTrace, GT_2CLASS, "Comm_get> "
+                    "timed out on queue 0x%x\n", queue);
+                return (Comm_ETIMEOUT);
+            }
+            else if ((errno != EAGAIN) && (errno != EINTR)) {
+                GT_2trace(curTrace, GT_7CLASS, "Comm_get> waiting on queue "
+                    "0x%x failed (errno %d)\n", queue, errno);
+                return (Comm_EFAIL);
+            }
+        }
+        else {
+            __sync_fetch_and_sub(&q->waiters, 1);
+        }
     }
 
-    return (Comm_EFAIL);
+    owners[msgIdx] = curPid;
+    *msg = (Comm_Msg)(msgs + msgIdx * MSGSIZE);
+
+    return (Comm_EOK);
 }
 
 /*
@@ -286,6 +508,14 @@ Bool Comm_init(Void)
         if (userName == NULL) {
             userName = "";
         }
+
+        curPid = getpid();
+        pthread_atfork(NULL, NULL, forkChild);
+
+        if (!attach()) {
+            curInit--;
+            return (FALSE);
+        }
     }
 
     return (TRUE);
@@ -297,8 +527,7 @@ Bool Comm_init(Void)
  */
 Int Comm_locate(String queueName, Comm_Queue *queue)
 {
-    key_t key = nameToId(queueName);
-    Int qid;
+    Int id;
     Int i;
 
     GT_assert(curTrace, curInit > 0);
@@ -306,15 +535,23 @@ Int Comm_locate(String queueName, Comm_Queue *queue)
     GT_2trace(curTrace, GT_ENTER, "Comm_locate> "
         "Enter(queueName='%s', queue=0x%x)\n", queueName, queue);
 
-    for (i = 0; (qid = msgget(key, 0644)) < 0; i++) {
+    for (i = 0; ; i++) {
+        lockShm();
+        id = findQueue(queueName);
+        unlockShm();
+
+        if (id >= 0) {
+            break;
+        }
         if (i >= MAXRETRY) {
-            perror("Comm_locate:msgget");
+            GT_1trace(curTrace, GT_7CLASS, "Comm_locate> queue '%s' not "
+                    "found\n", queueName);
             return (Comm_EFAIL);
         }
         sleep(1);
     }
 
-    *queue = qid;
+    *queue = id;
 
     return (Comm_EOK);
 }
@@ -325,17 +562,32 @@ Int Comm_locate(String queueName, Comm_Queue *queue)
  */
 Int Comm_put(Comm_Queue queue, Comm_Msg msg)
 {
+    Comm_QueueObj *q;
+    UInt32         msgIdx;
+
     GT_assert(curTrace, curInit > 0);
 
     GT_2trace(curTrace, GT_ENTER, "Comm_put> "
         "Enter(queue=0x%x, msg=0x%x)\n", queue, msg);
 
-    if (msgsnd(queue, msg, msg->size - sizeof(long), IPC_NOWAIT) < 0) {
-        perror("Comm_put");
+    if (queue >= numQueues) {
         return (Comm_EFAIL);
     }
 
-    Comm_free(msg);
+    q = &queues[queue];
+
+    /* queued messages belong to the queue until they are taken off it */
+    msgIdx = ((Char *)msg - msgs) / MSGSIZE;
+    owners[msgIdx] = 0;
+
+    /* can't fail: the ring has room for every message in the pool */
+    ringPut(&q->ring, msgIdx);
+
+    __sync_fetch_and_add(&q->event, 1);
+    if (q->waiters > 0) {
+        syscall(SYS_futex, &q->event, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+
     return (Comm_EOK);
 }
 
@@ -364,37 +616,391 @@ Void Comm_setSrcQueue(Comm_Msg msg, Comm_Queue queue)
 }
 
 /*
- *  ======== nameToId ========
- *  This function must map name to an id, such that:
- *      1. the same name always results in the same id, and
- *      2. different names must result in different ids.
+ *  ======== attach ========
+ *  Maps the shared segment, initializing it if no other process has it
+ *  mapped.
  */
-static Int nameToId(String name)
+static Bool attach(Void)
 {
-    Int sum = 0;
-    Int id = 0;
-    Char *cp;
+    Char                shmName[NAME_MAX];
+    struct flock        lock;
+    struct stat         st;
+    pthread_mutexattr_t mattrs;
+    size_t              cellsOff;
+    size_t              ownersOff;
+    size_t              msgsOff;
+    size_t              size;
+    Bool                first;
+    UInt32              i;
+
+    /* add user name to allow multiple developers to run tests concurrently */
+    snprintf(shmName, sizeof(shmName), "/ti_sdo_ce_Comm_%s", userName);
+
+    if ((shmFd = shm_open(shmName, O_RDWR | O_CREAT, 0600)) < 0) {
+        GT_2trace(curTrace, GT_7CLASS, "Comm_init> shm_open of %s failed "
+                "(errno %d)\n", shmName, errno);
+        return (FALSE);
+    }
+
+    lock.l_whence = SEEK_SET;
+    lock.l_start = 0;
+    lock.l_len = 0;
+
+    /* a write lock is only granted if no other process is attached */
+    lock.l_type = F_WRLCK;
+    first = (fcntl(shmFd, F_SETLK, &lock) == 0);
 
-    GT_1trace(curTrace, GT_ENTER, "nameToId> Enter(name=%s)\n", name);
+    if (first) {
+        /* a power of 2, so ring positions can wrap around */
+        for (numMsgs = 1; (numMsgs < ti_sdo_ce_ipc_linux_Comm_numMsgs) &&
+                (numMsgs < MAXMSGS); numMsgs <<= 1) {
+        }
+        numQueues = ti_sdo_ce_ipc_linux_Comm_numQueues > 0 ?
+                ti_sdo_ce_ipc_linux_Comm_numQueues : 1;
+        layout(numMsgs, numQueues, &cellsOff, &ownersOff, &msgsOff,
+                &shmSize);
+
+        if (ftruncate(shmFd, shmSize) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "Comm_init> ftruncate of %s "
+                    "failed (errno %d)\n", shmName, errno);
+            goto fail;
+        }
+    }
+    else {
+        /* blocks until the first process is done initializing */
+        lock.l_type = F_RDLCK;
+        if (fcntl(shmFd, F_SETLKW, &lock) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "Comm_init> locking %s failed "
+                    "(errno %d)\n", shmName, errno);
+            goto fail;
+        }
 
-    if ((cp = strchr(name, '#')) != NULL) {
-        id = atoi(cp + 1) << 16;
+        if ((fstat(shmFd, &st) < 0) || (st.st_size < sizeof(Comm_Shm))) {
+            GT_1trace(curTrace, GT_7CLASS, "Comm_init> %s has an unexpected "
+                    "size\n", shmName);
+            goto fail;
+        }
+        shmSize = st.st_size;
     }
 
-    for (cp = name; *cp != '\0'; cp++) {
-        sum += (Int)*cp;
+    shm = mmap(NULL, shmSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    if (shm == MAP_FAILED) {
+        GT_2trace(curTrace, GT_7CLASS, "Comm_init> mmap of %s failed "
+                "(errno %d)\n", shmName, errno);
+        shm = NULL;
+        goto fail;
     }
-    id = (name - cp) + id;
 
-    /* add user name to allow multiple developers to run tests concurrently */
-    for (cp = userName; *cp != '\0'; cp++) {
-        sum += (Int)*cp;
+    if (!first) {
+        if (shm->magic != SHMMAGIC) {
+            GT_1trace(curTrace, GT_7CLASS, "Comm_init> %s is not "
+                    "initialized\n", shmName);
+            goto fail;
+        }
+
+        numMsgs = shm->numMsgs;
+        numQueues = shm->numQueues;
+        layout(numMsgs, numQueues, &cellsOff, &ownersOff, &msgsOff, &size);
+
+        if ((shm->size != shmSize) || (size != shmSize)) {
+            GT_1trace(curTrace, GT_7CLASS, "Comm_init> %s has an unexpected "
+                    "size\n", shmName);
+            goto fail;
+        }
+    }
+
+    queues = (Comm_QueueObj *)((Char *)shm + CACHEALIGN(sizeof(Comm_Shm)));
+    owners = (volatile pid_t *)((Char *)shm + ownersOff);
+    msgs = (Char *)shm + msgsOff;
+
+    if (first) {
+        GT_3trace(curTrace, GT_2CLASS, "Comm_init> initializing %s with %d "
+                "messages and %d queues\n", shmName, numMsgs, numQueues);
+
+        shm->size = shmSize;
+        shm->numMsgs = numMsgs;
+        shm->numQueues = numQueues;
+
+        pthread_mutexattr_init(&mattrs);
+        pthread_mutexattr_setpshared(&mattrs, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&mattrs, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&shm->lock, &mattrs);
+        pthread_mutexattr_destroy(&mattrs);
+
+        initRing(&shm->freeMsgs, cellsOff, TRUE);
+
+        for (i = 0; i < numQueues; i++) {
+            queues[i].name[0] = '\0';
+            queues[i].owner = 0;
+            queues[i].event = 0;
+            queues[i].waiters = 0;
+            initRing(&queues[i].ring,
+                    cellsOff + (i + 1) * numMsgs * sizeof(Comm_Cell), FALSE);
+        }
+
+        for (i = 0; i < numMsgs; i++) {
+            owners[i] = 0;
+        }
+
+        shm->magic = SHMMAGIC;
+
+        /* let the others in, and stay attached */
+        lock.l_type = F_RDLCK;
+        if (fcntl(shmFd, F_SETLK, &lock) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "Comm_init> locking %s failed "
+                    "(errno %d)\n", shmName, errno);
+            goto fail;
+        }
+    }
+
+    return (TRUE);
+
+fail:
+    detach();
+
+    return (FALSE);
+}
+
+/*
+ *  ======== detach ========
+ *  Unmaps the shared segment.  Closing the file drops our lock on it, so
+ *  the next process to attach after the last one detached starts afresh.
+ */
+static Void detach(Void)
+{
+    if (shm != NULL) {
+        munmap(shm, shmSize);
+        shm = NULL;
+        queues = NULL;
+        owners = NULL;
+        msgs = NULL;
+    }
+
+    if (shmFd >= 0) {
+        close(shmFd);
+        shmFd = -1;
+    }
+}
+
+/*
+ *  ======== drainQueue ========
+ *  Returns the messages left on a queue to the pool.  Called with the
+ *  segment locked.
+ */
+static Void drainQueue(Comm_QueueObj *q)
+{
+    UInt32 msgIdx;
+
+    while (ringGet(&q->ring, &msgIdx)) {
+        ringPut(&shm->freeMsgs, msgIdx);
+    }
+}
+
+/*
+ *  ======== findQueue ========
+ *  Returns the id of the queue named 'name', or -1.  Called with the
+ *  segment locked.
+ */
+static Int findQueue(String name)
+{
+    UInt32 i;
+
+    for (i = 0; i < numQueues; i++) {
+        if (strcmp(queues[i].name, name) == 0) {
+            return (i);
+        }
+    }
+
+    return (-1);
+}
+
+/*
+ *  ======== forkChild ========
+ *  The child of a fork() has a new process ID; messages and queues it
+ *  takes from now on are tagged with it.
+ */
+static Void forkChild(Void)
+{
+    curPid = getpid();
+}
+
+/*
+ *  ======== initRing ========
+ *  Initializes a ring either empty or holding every message of the pool.
+ */
+static Void initRing(Comm_Ring *ring, UInt32 cells, Bool full)
+{
+    Comm_Cell *cell = (Comm_Cell *)((Char *)shm + cells);
+    UInt32     i;
+
+    for (i = 0; i < numMsgs; i++) {
+        cell[i].msgIdx = i;
+        cell[i].seq = full ? i + 1 : i;
+    }
+
+    ring->cells = cells;
+    ring->head = 0;
+    ring->tail = full ? numMsgs : 0;
+}
+
+/*
+ *  ======== isAlive ========
+ *  A process we aren't allowed to signal still exists.
+ */
+static Bool isAlive(pid_t pid)
+{
+    return ((kill(pid, 0) == 0) || (errno != ESRCH));
+}
+
+/*
+ *  ======== layout ========
+ *  Computes the offsets of the parts of a segment, and its size.
+ */
+static Void layout(UInt32 nMsgs, UInt32 nQueues, size_t *cellsOff,
+    size_t *ownersOff, size_t *msgsOff, size_t *size)
+{
+    *cellsOff = CACHEALIGN(sizeof(Comm_Shm)) +
+            nQueues * sizeof(Comm_QueueObj);
+    *ownersOff = *cellsOff + (nQueues + 1) * nMsgs * sizeof(Comm_Cell);
+    *msgsOff = CACHEALIGN(*ownersOff + nMsgs * sizeof(pid_t));
+    *size = *msgsOff + nMsgs * MSGSIZE;
+}
+
+/*
+ *  ======== reclaim ========
+ *  Deletes the queues, and frees the messages, of processes that died
+ *  without doing so.  Called with the segment locked.
+ */
+static Void reclaim(Void)
+{
+    pid_t  deadPid = 0;
+    pid_t  pid;
+    UInt32 i;
+
+    for (i = 0; i < numQueues; i++) {
+        pid = queues[i].owner;
+
+        if ((queues[i].name[0] != '\0') && (pid != 0) && (pid != curPid) &&
+                !isAlive(pid)) {
+            GT_2trace(curTrace, GT_2CLASS, "Comm> process %d is gone, "
+                    "deleting its queue '%s'\n", pid, queues[i].name);
+            drainQueue(&queues[i]);
+            queues[i].name[0] = '\0';
+            queues[i].owner = 0;
+        }
+    }
+
+    for (i = 0; i < numMsgs; i++) {
+        pid = owners[i];
+
+        /* a process usually holds several messages, only look it up once */
+        if ((pid != 0) && (pid != curPid) &&
+                ((pid == deadPid) || !isAlive(pid))) {
+            deadPid = pid;
+            owners[i] = 0;
+            ringPut(&shm->freeMsgs, i);
+        }
+    }
+
+    if (deadPid != 0) {
+        GT_0trace(curTrace, GT_2CLASS, "Comm> freed the messages of "
+                "processes that are gone\n");
+    }
+}
+
+/*
+ *  ======== ringGet ========
+ */
+static Bool ringGet(Comm_Ring *ring, UInt32 *msgIdx)
+{
+    Comm_Cell *cells = (Comm_Cell *)((Char *)shm + ring->cells);
+    Comm_Cell *cell;
+    UInt32     pos = ring->head;
+    Int32      diff;
+
+    for (;;) {
+        cell = &cells[pos & (numMsgs - 1)];
+        diff = (Int32)(cell->seq - (pos + 1));
+
+        if (diff == 0) {
+            /* cell is full for this lap, try to claim it */
+            if (__sync_bool_compare_and_swap(&ring->head, pos, pos + 1)) {
+                break;
+            }
+            pos = ring->head;
+        }
+        else if (diff < 0) {
+            return (FALSE);                     /* empty */
+        }
+        else {
+            pos = ring->head;                   /* lost a race, retry */
+        }
+    }
+
+    *msgIdx = cell->msgIdx;
+
+    /* hand the cell to the producer of the next lap */
+    __sync_synchronize();
+    cell->seq = pos + numMsgs;
+
+    return (TRUE);
+}
+
+/*
+ *  ======== ringPut ========
+ */
+static Bool ringPut(Comm_Ring *ring, UInt32 msgIdx)
+{
+    Comm_Cell *cells = (Comm_Cell *)((Char *)shm + ring->cells);
+    Comm_Cell *cell;
+    UInt32     pos = ring->tail;
+    Int32      diff;
+
+    for (;;) {
+        cell = &cells[pos & (numMsgs - 1)];
+        diff = (Int32)(cell->seq - pos);
+
+        if (diff == 0) {
+            /* cell is empty for this lap, try to claim it */
+            if (__sync_bool_compare_and_swap(&ring->tail, pos, pos + 1)) {
+                break;
+            }
+            pos = ring->tail;
+        }
+        else if (diff < 0) {
+            return (FALSE);                     /* full */
+        }
+        else {
+            pos = ring->tail;                   /* lost a race, retry */
+        }
     }
-    id = (sum << 6) + (userName - cp) + id;
 
-    GT_1trace(curTrace, GT_ENTER, "nameToId> Exit(id=0x%x)\n", id);
+    cell->msgIdx = msgIdx;
+
+    /* publish the message to consumers */
+    __sync_synchronize();
+    cell->seq = pos + 1;
 
-    return (id);
+    return (TRUE);
+}
+
+/*
+ *  ======== lockShm ========
+ */
+static Void lockShm(Void)
+{
+    if (pthread_mutex_lock(&shm->lock) == EOWNERDEAD) {
+        /* the queue table is updated atomically enough to be reused */
+        pthread_mutex_consistent(&shm->lock);
+    }
+}
+
+/*
+ *  ======== unlockShm ========
+ */
+static Void unlockShm(Void)
+{
+    pthread_mutex_unlock(&shm->lock);
 }
 /*
  *  @(#) ti.sdo.ce.ipc.linux; 2, 0, 1,179; 12-2-2010 21:24:22; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
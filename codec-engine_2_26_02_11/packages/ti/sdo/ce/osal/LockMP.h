@@ -101,30 +101,33 @@ extern Void LockMP_acquire(LockMP_Handle lock);
  *
  *  @retval             Handle to a LockMP object.
  *
- *  @pre                For Linux OS, @c key is not IPC_PRIVATE (#define'd
- *                      to be 0 in <bits/ipc.h>).
+ *  @pre                For Linux OS, @c key is not 0.
  *
  *  @post               The return value is non-NULL on success, NULL on
  *                      failure.
  *
- *  @remarks    For Linux OS the LockMP objects are implemented with IPC
- *              semaphores and can be shared accross processes. The @c key is
- *              used to create or get the IPC semaphore, and hence should
- *              not be @c IPC_PRIVATE. If the IPC semaphore with the same key
- *              has already been created, @c LockMP_create() will increment its
- *              reference count. Care should be taken to ensure that the keys
- *              do not collide with keys used for other Linux IPC objects in
- *              the system.
+ *  @remarks    For Linux OS the LockMP objects are implemented with robust
+ *              process-shared mutexes in a POSIX shared memory segment, and
+ *              can be shared accross processes. The @c key identifies the
+ *              lock within the segment. If the lock with the same key has
+ *              already been created, @c LockMP_create() will increment its
+ *              reference count. Acquiring and releasing a lock that isn't
+ *              contended is done without a system call. If a process dies
+ *              while owning the lock, the next LockMP_acquire() takes it
+ *              over.
  *
  *  @remarks    For Linux OS, each process that creates a lock must
- *              also delete it. This ensures that the underlying Linux IPC
- *              semaphore's reference count goes to zero, at which point
- *              @c LockMP_delete() will free it. Failure to delete the lock
- *              will result in the Linux IPC semaphore remaining in the
- *              system even after all processes that created it have exited.
- *              In that case, the IPC semaphore will have to be deleted
- *              manually (through the Linux @c ipcrm command) or through a
- *              system reboot.
+ *              also delete it. This ensures that the lock's reference count
+ *              goes to zero, at which point @c LockMP_delete() will free it.
+ *              The references of a process that ends abnormally (eg, with
+ *              ^C) are dropped the next time a process creates a lock or
+ *              gets a lock's reference count.
+ *
+ *  @remarks    For Linux OS, the number of locks, and of processes whose
+ *              references are tracked, are set by the
+ *              ti_sdo_ce_osal_linux_LockMP_maxLocks and
+ *              ti_sdo_ce_osal_linux_LockMP_maxProcs variables, which the
+ *              application must define (see utils/rtcfg/rtcfg_linux.c).
  *
  *  @sa         LockMP_delete().
 */
@@ -139,8 +142,8 @@ extern LockMP_Handle LockMP_create(Int key);
  *  @param[in]  lock    Handle returned from LockMP_create().
  *
  *  @remarks    For Linux OS this call will decrement the reference count of
- *              the LockMP_Obj's IPC semaphore, and if the reference count goes
- *              to zero, the IPC semaphore will be removed from the system.
+ *              the lock, and if the reference count goes to zero, the lock
+ *              will be freed.
  *
  *  @sa         LockMP_create().
  */
@@ -177,6 +180,9 @@ extern Int LockMP_getCount(LockMP_Handle lock);
  *              to ensure that the value returned is consitent with the lock's
  *              reference count.
  *
+ *  @remarks    For Linux OS, references held by processes that have
+ *              exited without deleting the lock are not counted.
+ *
  *  @retval     Reference count of the lock.
  */
 extern Int LockMP_getRefCount(LockMP_Handle lock);
@@ -80,6 +80,17 @@ typedef struct Memory_Stat {
 
 /** @endcond */
 
+/**
+ *  @brief      Statistics of the virtual/physical address translation cache.
+ *
+ *  @sa         Memory_getTranslationStat()
+ */
+typedef struct Memory_TranslationStat {
+    UInt32 hits;     /**< Translations resolved from the cache. */
+    UInt32 misses;   /**< Translations not found in the cache. */
+    UInt32 numBufs;  /**< Number of buffers currently in the cache. */
+} Memory_TranslationStat;
+
 /**
  *  @brief      Enum values for Memory_AllocParams.type
  *
@@ -371,6 +382,29 @@ extern Bool Memory_free(Ptr addr, UInt size, Memory_AllocParams *params);
 extern Void Memory_dumpKnownContigBufsList(Void);
 
 
+/*
+ *  ======== Memory_getTranslationStat ========
+ */
+/**
+ *  @brief      Returns the statistics of the address translation cache
+ *              used by Memory_getBufferPhysicalAddress() and
+ *              Memory_getBufferVirtualAddress().
+ *
+ *  @param[out] statbuf     Buffer to fill with the statistics.
+ *
+ *  @remarks    A miss in Memory_getBufferPhysicalAddress() costs a query of
+ *              the contiguous memory driver, so a high miss count usually
+ *              means buffers should be registered with
+ *              Memory_registerContigBuf().
+ *
+ *  @remarks    The counters are zero on OSes without a translation cache.
+ *
+ *  @sa         Memory_registerContigBuf()
+ *  @sa         Memory_dumpKnownContigBufsList()
+ */
+extern Void Memory_getTranslationStat(Memory_TranslationStat *statbuf);
+
+
 /*
  *  ======== Memory_getBufferPhysicalAddress ========
  */
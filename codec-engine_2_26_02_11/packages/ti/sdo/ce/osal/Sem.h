@@ -154,7 +154,10 @@ extern Void Sem_init(Void);
  *  @brief      Wait on a semaphore.
  *
  *  @param[in]  sem         A semaphore handle returned from Sem_create().
- *  @param[in]  timeout     A timeout value to wait on the semaphore.
+ *  @param[in]  timeout     A timeout value to wait on the semaphore. On
+ *                          Linux this is in microseconds, on BIOS in system
+ *                          clock ticks. Sem_POLL and Sem_FOREVER are
+ *                          supported everywhere.
  *
  *  @retval     Sem_EOK         Success.
  *  @retval     Sem_ETIMEOUT    The call timed out before the semaphore could
@@ -90,32 +90,33 @@ typedef struct SemMP_Obj *SemMP_Handle;
  *
  *  @retval             Handle to a semaphore object.
  *
- *  @pre                For Linux OS, @c key is not IPC_PRIVATE (#define'd
- *                      to be 0 in <bits/ipc.h>).
+ *  @pre                For Linux OS, @c key is not 0.
  *
  *  @post               The return value is non-NULL on success, NULL on
  *                      failure.
  *
- *  @remarks    For Linux OS these semaphores are implemented with IPC
- *              semaphores and can be shared accross processes. The @c key is
- *              used to create or get the IPC semaphore, and hence should
- *              not be @c IPC_PRIVATE. If the IPC semaphore with the same key
- *              has already been created, @c SemMP_create() will increment its
- *              reference count. Care should be taken to ensure that the keys
- *              do not collide with keys used for other Linux IPC objects in
- *              the system.
+ *  @remarks    For Linux OS these semaphores are futexes in a POSIX shared
+ *              memory segment, and can be shared accross processes. The
+ *              @c key identifies the semaphore within the segment. If the
+ *              semaphore with the same key has already been created,
+ *              @c SemMP_create() will increment its reference count, and
+ *              @c count is ignored. Pending on a semaphore whose count is
+ *              non-zero, and posting one nobody is waiting on, are done
+ *              without a system call.
  *
  *  @remarks    For Linux OS, each process that creates a semaphore must
- *              also delete it. This ensures that the underlying Linux IPC
- *              semaphore's reference count goes to zero, at which point
- *              @c SemMP_delete() will free it. Failure to delete the semaphores
- *              will result in the Linux IPC semaphore remaining in the
- *              system even after all processes that created it have exited.
- *              In that case, the IPC semaphore will have to be deleted
- *              manually (through the Linux @c ipcrm command) or through a
- *              system reboot.
- *              Processes that end abnormally (eg, with ^C) may need to have
- *              a signal handler cleanup its semaphores.
+ *              also delete it. This ensures that the semaphore's reference
+ *              count goes to zero, at which point @c SemMP_delete() will
+ *              free it. Semaphores left behind by processes that end
+ *              abnormally (eg, with ^C) are reclaimed once every process
+ *              using the segment has exited. Note that, unlike IPC
+ *              semaphores, a count taken by a process that dies is not
+ *              given back; use a LockMP object to protect resources that
+ *              must survive that.
+ *
+ *  @remarks    For Linux OS, the number of semaphores is set by the
+ *              ti_sdo_ce_osal_linux_SemMP_maxSems variable, which the
+ *              application must define (see utils/rtcfg/rtcfg_linux.c).
  *
  *  @sa         SemMP_delete().
 */
@@ -130,8 +131,8 @@ extern SemMP_Handle SemMP_create(Int key, Int count);
  *  @param[in]  sem     Handle returned from SemMP_create().
  *
  *  @remarks    For Linux OS this call will decrement the reference count of
- *              the SemMP_Obj's IPC semaphore, and if the reference count goes
- *              to zero, the IPC semaphore will be removed from the system.
+ *              the semaphore, and if the reference count goes to zero, the
+ *              semaphore will be freed.
  *
  *  @sa         SemMP_create().
  */
@@ -179,7 +180,10 @@ extern Void SemMP_init(Void);
  *  @brief      Wait on a semaphore.
  *
  *  @param[in]  sem         A semaphore handle returned from SemMP_create().
- *  @param[in]  timeout     A timeout value to wait on the semaphore.
+ *  @param[in]  timeout     A timeout value to wait on the semaphore. On
+ *                          Linux this is in microseconds, on BIOS in system
+ *                          clock ticks. SemMP_POLL and SemMP_FOREVER are
+ *                          supported everywhere.
  *
  *  @retval     SemMP_EOK         Success.
  *  @retval     SemMP_ETIMEOUT    The call timed out before the semaphore could
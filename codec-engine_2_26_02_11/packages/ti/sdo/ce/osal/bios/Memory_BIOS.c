@@ -464,6 +464,16 @@ Void Memory_unregisterContigBuf( UInt32 virtualAddress, UInt32 sizeInBytes )
 Void Memory_dumpKnownContigBufsList()
 {
 }
+
+/*
+ *  ======== Memory_getTranslationStat ========
+ */
+Void Memory_getTranslationStat(Memory_TranslationStat *statbuf)
+{
+    statbuf->hits    = 0;
+    statbuf->misses  = 0;
+    statbuf->numBufs = 0;
+}
 /*
  *  @(#) ti.sdo.ce.osal.bios; 2, 0, 1,182; 12-2-2010 21:24:43; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
 
@@ -32,27 +32,97 @@
  */
 /*
  *  ======== LockMP_posix.c ========
+ *  Process-shared recursive locks.
+ *
+ *  All locks live in a table in one POSIX shared memory segment, whose name
+ *  is derived from the configured SemMP IPC key; a lock is a slot in that
+ *  table identified by the key passed to LockMP_create(), so every process
+ *  that creates a lock with the same key gets the same slot.
+ *
+ *  Each slot holds a robust process-shared mutex, which glibc implements
+ *  with a futex: acquiring and releasing an uncontended lock doesn't enter
+ *  the kernel, and if the owner dies holding the lock the next process to
+ *  acquire it takes it over.  Nesting is tracked in the (per-process)
+ *  LockMP object, as only the owner may touch it.
+ *
+ *  The segment also has a table of the processes attached to it, with the
+ *  number of references each one holds on each lock.  The references of a
+ *  process that died without deleting its locks are dropped the next time
+ *  a process creates a lock or asks for a lock's reference count, so they
+ *  don't keep slots allocated, or make a lock look shared.
+ *
+ *  Each process holds a read lock on the segment file while it's attached.
+ *  The first process to attach (i.e. the one that gets the write lock)
+ *  initializes the segment, and sizes its tables from the configuration.
  */
 
 #include <xdc/std.h>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
 
 #include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <ti/sdo/utils/trace/gt.h>
 #include <ti/sdo/ce/osal/Memory.h>
 #include <ti/sdo/ce/osal/Global.h>
-#include <ti/sdo/ce/osal/SemMP.h>
 
 #include <ti/sdo/ce/osal/LockMP.h>
 
+#define SHMMAGIC    0x4c4f434b  /* 'LOCK' */
+
+/*
+ *  Key used to name the shared memory segment holding the locks. This is
+ *  auto-generated by Global.xdt.
+ */
+extern UInt32 ti_sdo_ce_osal_linux_SemMP_ipcKey;
+
+/*
+ *  Number of lock slots, and of process table entries, of the segment.
+ *  Only the process that initializes the segment uses these; the others
+ *  use the sizes recorded in the segment. No configuration template
+ *  generates them: the application must define them, as
+ *  utils/rtcfg/rtcfg_linux.c does.
+ */
+extern UInt32 ti_sdo_ce_osal_linux_LockMP_maxLocks;
+extern UInt32 ti_sdo_ce_osal_linux_LockMP_maxProcs;
+
+/*
+ *  ======== LockMP_Slot ========
+ *  A lock, as it lives in the shared memory segment.
+ */
+typedef struct LockMP_Slot {
+    Int             key;        /* 0 if the slot is free */
+    Int             refCount;   /* number of LockMP_create() calls */
+    pthread_mutex_t mutex;      /* robust, process-shared */
+} LockMP_Slot;
+
+/*
+ *  ======== LockMP_Shm ========
+ *  Header of the shared memory segment. It is followed by numSlots
+ *  LockMP_Slot's, the numProcs process IDs of the process table (0 if the
+ *  entry is free), and for each process entry numSlots reference counts.
+ */
+typedef struct LockMP_Shm {
+    volatile UInt32 magic;      /* set once the segment is initialized */
+    UInt32          size;
+    UInt32          numSlots;
+    UInt32          numProcs;
+    pthread_mutex_t lock;       /* protects the tables */
+} LockMP_Shm;
+
 /*
  *  ======== LockMP_Obj ========
  */
 typedef struct LockMP_Obj {
-    SemMP_Handle  sem;    /*  IPC semaphore */
+    LockMP_Slot  *slot;   /*  The lock in the shared memory segment */
     Int           value;  /*  Number of times Lock has been acquired */
     pthread_t     owner;  /*  ID of owning thread */
     pid_t         pid;    /*  ID of owning process (in case thread id is not
@@ -67,8 +137,38 @@ typedef struct LockMP_Obj {
 static Bool curInit = FALSE;
 static GT_Mask curTrace = {NULL, NULL};
 
+static Int shmFd = -1;
+static LockMP_Shm *shm = NULL;
+static size_t shmSize = 0;
+
+/* the tables following the header */
+static LockMP_Slot *slots = NULL;
+static pid_t *procs = NULL;
+static Int *refs = NULL;
+static UInt32 numSlots = 0;
+static UInt32 numProcs = 0;
+
+/* our entry in the process table, -1 if it was full */
+static Int procId = -1;
+
+/* getpid() is a system call, so keep our own copy, updated on fork() */
+static pid_t curPid = 0;
+
 static Void    cleanup(Void);
 
+static Bool attach(Void);
+static Void claimProc(Void);
+static Void detach(Void);
+static Void dropRefs(Int slotId, Int count);
+static Void forkChild(Void);
+static Void initMutex(pthread_mutex_t *mutex);
+static Bool isAlive(pid_t pid);
+static Void reclaim(Void);
+static Void releaseProc(Int id);
+static size_t sizeOf(UInt32 nSlots, UInt32 nProcs);
+static Void lockShm(Void);
+static Void unlockShm(Void);
+
 /*
  *  ======== LockMP_acquire ========
  */
@@ -76,21 +176,33 @@ Void LockMP_acquire(LockMP_Handle lock)
 {
     pthread_t       self;
     pid_t           pid;
-    Int             status = SemMP_EOK;
+    Int             status = 0;
 
     GT_1trace(curTrace, GT_ENTER, "Entered LockMP_acquire> lock[0x%x]\n",
             lock);
 
     self = pthread_self();
-    pid = getpid();
+    pid = curPid;
 
     if ((lock->owner != self) || (lock->pid != pid)) {
         /* This thread does not currently own the lock */
-        status = SemMP_pend(lock->sem, SemMP_FOREVER);
-        GT_assert(curTrace, status == SemMP_EOK);
+        status = pthread_mutex_lock(&lock->slot->mutex);
+
+        if (status == EOWNERDEAD) {
+            /*
+             *  The previous owner died holding the lock; whatever it was
+             *  protecting may be inconsistent, but we can't tell, so take
+             *  it over rather than deadlock.
+             */
+            GT_1trace(curTrace, GT_6CLASS, "LockMP_acquire> owner of lock "
+                    "0x%x died, recovering it\n", lock->slot->key);
+            pthread_mutex_consistent(&lock->slot->mutex);
+            status = 0;
+        }
+        GT_assert(curTrace, status == 0);
     }
 
-    if (status == SemMP_EOK) {
+    if (status == 0) {
         lock->pid = pid;
         lock->owner = self;
         lock->value++;
@@ -105,10 +217,20 @@ Void LockMP_acquire(LockMP_Handle lock)
  */
 LockMP_Handle LockMP_create(Int key)
 {
-    LockMP_Obj *lock;
+    LockMP_Obj  *lock;
+    Int          slotId = -1;
+    Int          freeId = -1;
+    Int          i;
+
+    GT_1trace(curTrace, GT_ENTER, "LockMP_create> key: 0x%x\n", key);
+
+    GT_assert(curTrace, key != 0);
 
-    GT_1trace(curTrace, GT_ENTER,
-            "LockMP_create> key: 0x%x count: %d attrs: 0x%x\n", key);
+    if (shm == NULL) {
+        GT_0trace(curTrace, GT_7CLASS, "LockMP_create> not attached to the "
+                "shared memory segment\n");
+        return (NULL);
+    }
 
     lock = (LockMP_Obj *)Memory_alloc(sizeof(LockMP_Obj), NULL);
     if (lock == NULL) {
@@ -116,14 +238,51 @@ LockMP_Handle LockMP_create(Int key)
         return (NULL);
     }
 
-    /* Create IPC semaphore with count 1 */
-    lock->sem = SemMP_create(key, 1);
-    if (lock->sem == NULL) {
-        GT_0trace(curTrace, GT_7CLASS, "LockMP_create> SemMP_create failed\n");
-        LockMP_delete(lock);
+    lockShm();
+
+    /* free the slots held only by processes that are gone */
+    reclaim();
+
+    if (procId == -1) {
+        /* we were forked, or the process table was full */
+        claimProc();
+    }
+
+    for (i = 0; i < numSlots; i++) {
+        if (slots[i].key == key) {
+            /* Already created by this or another process */
+            slotId = i;
+            break;
+        }
+        if ((freeId == -1) && (slots[i].key == 0)) {
+            freeId = i;
+        }
+    }
+
+    if ((slotId == -1) && (freeId != -1)) {
+        slotId = freeId;
+        slots[slotId].key = key;
+        slots[slotId].refCount = 0;
+        initMutex(&slots[slotId].mutex);
+    }
+
+    if (slotId != -1) {
+        slots[slotId].refCount++;
+        if (procId != -1) {
+            refs[procId * numSlots + slotId]++;
+        }
+    }
+
+    unlockShm();
+
+    if (slotId == -1) {
+        GT_2trace(curTrace, GT_7CLASS, "LockMP_create> no free slot for key "
+                "0x%x, all %d are in use\n", key, numSlots);
+        Memory_free(lock, sizeof(LockMP_Obj), NULL);
         return (NULL);
     }
 
+    lock->slot = &slots[slotId];
     lock->value = 0;
     lock->owner = (pthread_t)NULL;
     lock->pid = (pid_t)NULL;
@@ -138,12 +297,23 @@ LockMP_Handle LockMP_create(Int key)
  */
 Void LockMP_delete(LockMP_Handle lock)
 {
+    Int slotId;
+
     GT_1trace(curTrace, GT_ENTER, "Entered LockMP_delete> lock[0x%x]\n", lock);
 
     if (lock != NULL) {
-        if (lock->sem != NULL) {
-            SemMP_delete(lock->sem);
+        slotId = lock->slot - slots;
+
+        lockShm();
+
+        GT_assert(curTrace, lock->slot->refCount > 0);
+
+        if ((procId != -1) && (refs[procId * numSlots + slotId] > 0)) {
+            refs[procId * numSlots + slotId]--;
         }
+        dropRefs(slotId, 1);
+
+        unlockShm();
 
         Memory_free(lock, sizeof(LockMP_Obj), NULL);
     }
@@ -164,7 +334,17 @@ Int LockMP_getCount(LockMP_Handle lock)
  */
 Int LockMP_getRefCount(LockMP_Handle lock)
 {
-    return (SemMP_getRefCount(lock->sem));
+    Int refCount;
+
+    lockShm();
+
+    /* don't count the references of processes that are gone */
+    reclaim();
+    refCount = lock->slot->refCount;
+
+    unlockShm();
+
+    return (refCount);
 }
 
 /*
@@ -175,6 +355,14 @@ Void LockMP_init(Void)
     if (curInit++ == 0) {
         GT_create(&curTrace, LockMP_GTNAME);
 
+        curPid = getpid();
+        pthread_atfork(NULL, NULL, forkChild);
+
+        if (!attach()) {
+            GT_0trace(curTrace, GT_7CLASS, "LockMP_init> failed to attach to "
+                    "the shared memory segment\n");
+        }
+
         Global_atexit((Fxn)cleanup);
     }
 }
@@ -187,7 +375,7 @@ Void LockMP_release(LockMP_Handle lock)
     GT_1trace(curTrace, GT_ENTER, "Entered LockMP_release>lock[0x%x]\n", lock);
 
     GT_assert(curTrace, lock->owner == pthread_self());
-    GT_assert(curTrace, lock->pid == getpid());
+    GT_assert(curTrace, lock->pid == curPid);
     GT_assert(curTrace, lock->value > 0);
 
     lock->value--;
@@ -195,12 +383,179 @@ Void LockMP_release(LockMP_Handle lock)
     if (lock->value == 0) {
         lock->owner = (pthread_t)NULL;
         lock->pid = (pid_t)NULL;
-        SemMP_post(lock->sem);
+        pthread_mutex_unlock(&lock->slot->mutex);
     }
 
     GT_1trace(curTrace, GT_ENTER, "Leaving LockMP_release>lock[0x%x]\n", lock);
 }
 
+/*
+ *  ======== attach ========
+ *  Map the shared memory segment, initializing it if we're the first
+ *  process to do so, and take an entry in its process table.
+ */
+static Bool attach(Void)
+{
+    Char                shmName[NAME_MAX];
+    struct flock        lock;
+    struct stat         st;
+    Bool                first;
+    Int                 i;
+
+    snprintf(shmName, sizeof(shmName), "/ti_sdo_ce_LockMP_%08x",
+            (unsigned int)ti_sdo_ce_osal_linux_SemMP_ipcKey);
+
+    if ((shmFd = shm_open(shmName, O_RDWR | O_CREAT, 0666)) < 0) {
+        GT_2trace(curTrace, GT_7CLASS, "LockMP_init> shm_open of %s failed "
+                "(errno %d)\n", shmName, errno);
+        return (FALSE);
+    }
+
+    /* like IPC semaphores, let other users share the segment */
+    fchmod(shmFd, 0666);
+
+    lock.l_whence = SEEK_SET;
+    lock.l_start = 0;
+    lock.l_len = 0;
+
+    /* a write lock is only granted if no other process is attached */
+    lock.l_type = F_WRLCK;
+    first = (fcntl(shmFd, F_SETLK, &lock) == 0);
+
+    if (first) {
+        numSlots = ti_sdo_ce_osal_linux_LockMP_maxLocks > 0 ?
+                ti_sdo_ce_osal_linux_LockMP_maxLocks : 1;
+        numProcs = ti_sdo_ce_osal_linux_LockMP_maxProcs > 0 ?
+                ti_sdo_ce_osal_linux_LockMP_maxProcs : 1;
+        shmSize = sizeOf(numSlots, numProcs);
+
+        if (ftruncate(shmFd, shmSize) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "LockMP_init> ftruncate of %s "
+                    "failed (errno %d)\n", shmName, errno);
+            goto fail;
+        }
+    }
+    else {
+        /* blocks until the first process is done initializing */
+        lock.l_type = F_RDLCK;
+        if (fcntl(shmFd, F_SETLKW, &lock) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "LockMP_init> fcntl of %s failed "
+                    "(errno %d)\n", shmName, errno);
+            goto fail;
+        }
+
+        if ((fstat(shmFd, &st) < 0) ||
+                ((size_t)st.st_size < sizeof(LockMP_Shm))) {
+            GT_1trace(curTrace, GT_7CLASS, "LockMP_init> %s has an "
+                    "unexpected size\n", shmName);
+            goto fail;
+        }
+        shmSize = st.st_size;
+    }
+
+    shm = mmap(NULL, shmSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    if (shm == MAP_FAILED) {
+        GT_2trace(curTrace, GT_7CLASS, "LockMP_init> mmap of %s failed "
+                "(errno %d)\n", shmName, errno);
+        shm = NULL;
+        goto fail;
+    }
+
+    if (first) {
+        GT_3trace(curTrace, GT_2CLASS, "LockMP_init> initializing %s, %d "
+                "locks, %d processes\n", shmName, numSlots, numProcs);
+
+        shm->size = shmSize;
+        shm->numSlots = numSlots;
+        shm->numProcs = numProcs;
+
+        initMutex(&shm->lock);
+    }
+    else {
+        if (shm->magic != SHMMAGIC) {
+            GT_1trace(curTrace, GT_7CLASS, "LockMP_init> %s is not "
+                    "initialized\n", shmName);
+            goto fail;
+        }
+
+        numSlots = shm->numSlots;
+        numProcs = shm->numProcs;
+
+        if ((shm->size != shmSize) || (sizeOf(numSlots, numProcs) !=
+                shmSize)) {
+            GT_1trace(curTrace, GT_7CLASS, "LockMP_init> %s has an "
+                    "unexpected size\n", shmName);
+            goto fail;
+        }
+    }
+
+    slots = (LockMP_Slot *)(shm + 1);
+    procs = (pid_t *)(slots + numSlots);
+    refs = (Int *)(procs + numProcs);
+
+    if (first) {
+        for (i = 0; i < numSlots; i++) {
+            slots[i].key = 0;
+            slots[i].refCount = 0;
+        }
+
+        for (i = 0; i < numProcs * numSlots; i++) {
+            refs[i] = 0;
+        }
+
+        for (i = 0; i < numProcs; i++) {
+            procs[i] = 0;
+        }
+
+        shm->magic = SHMMAGIC;
+
+        /* let the others in, and stay attached */
+        lock.l_type = F_RDLCK;
+        if (fcntl(shmFd, F_SETLK, &lock) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "LockMP_init> fcntl of %s failed "
+                    "(errno %d)\n", shmName, errno);
+            goto fail;
+        }
+    }
+
+    lockShm();
+
+    /* entries of processes that are gone can be reused */
+    reclaim();
+    claimProc();
+
+    unlockShm();
+
+    return (TRUE);
+
+fail:
+    detach();
+
+    return (FALSE);
+}
+
+/*
+ *  ======== claimProc ========
+ *  Take an entry in the process table. Must be called with the segment
+ *  locked.
+ */
+static Void claimProc(Void)
+{
+    Int i;
+
+    for (i = 0; i < numProcs; i++) {
+        if (procs[i] == 0) {
+            procs[i] = curPid;
+            procId = i;
+            return;
+        }
+    }
+
+    /* still usable, but our references can't be dropped if we die */
+    GT_1trace(curTrace, GT_6CLASS, "LockMP> all %d process entries are in "
+            "use\n", numProcs);
+}
+
 /*
  *  ======== cleanup ========
  */
@@ -209,9 +564,163 @@ static Void cleanup(Void)
     GT_assert(curTrace, curInit > 0);
 
     if (--curInit == 0) {
-        /* Nothing to do */
+        detach();
+    }
+}
+
+/*
+ *  ======== detach ========
+ */
+static Void detach(Void)
+{
+    if (shm != NULL) {
+        if (procId != -1) {
+            /* drop the references of locks we didn't delete */
+            lockShm();
+            releaseProc(procId);
+            unlockShm();
+
+            procId = -1;
+        }
+
+        munmap(shm, shmSize);
+        shm = NULL;
+    }
+
+    slots = NULL;
+    procs = NULL;
+    refs = NULL;
+    numSlots = 0;
+    numProcs = 0;
+    shmSize = 0;
+
+    if (shmFd >= 0) {
+        /* drops our read lock */
+        close(shmFd);
+        shmFd = -1;
+    }
+}
+
+/*
+ *  ======== dropRefs ========
+ *  Drop references on a lock, and free its slot if there are none left.
+ *  Must be called with the segment locked.
+ */
+static Void dropRefs(Int slotId, Int count)
+{
+    LockMP_Slot *slot = &slots[slotId];
+
+    slot->refCount -= count;
+
+    if (slot->refCount <= 0) {
+        /* Free the slot */
+        pthread_mutex_destroy(&slot->mutex);
+        slot->refCount = 0;
+        slot->key = 0;
     }
 }
+
+/*
+ *  ======== forkChild ========
+ *  The child of a fork() has a new process ID, and doesn't hold the
+ *  references recorded in its parent's process table entry; it takes its
+ *  own entry when it creates a lock.
+ */
+static Void forkChild(Void)
+{
+    curPid = getpid();
+    procId = -1;
+}
+
+/*
+ *  ======== initMutex ========
+ */
+static Void initMutex(pthread_mutex_t *mutex)
+{
+    pthread_mutexattr_t mattrs;
+
+    pthread_mutexattr_init(&mattrs);
+    pthread_mutexattr_setpshared(&mattrs, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mattrs, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(mutex, &mattrs);
+    pthread_mutexattr_destroy(&mattrs);
+}
+
+/*
+ *  ======== isAlive ========
+ *  A process we aren't allowed to signal still exists.
+ */
+static Bool isAlive(pid_t pid)
+{
+    return ((kill(pid, 0) == 0) || (errno != ESRCH));
+}
+
+/*
+ *  ======== lockShm ========
+ */
+static Void lockShm(Void)
+{
+    if (pthread_mutex_lock(&shm->lock) == EOWNERDEAD) {
+        /* the tables are updated atomically enough to be reused */
+        pthread_mutex_consistent(&shm->lock);
+    }
+}
+
+/*
+ *  ======== reclaim ========
+ *  Release the process table entries of processes that are gone.  Must be
+ *  called with the segment locked.
+ */
+static Void reclaim(Void)
+{
+    Int i;
+
+    for (i = 0; i < numProcs; i++) {
+        if ((procs[i] != 0) && (i != procId) && !isAlive(procs[i])) {
+            GT_1trace(curTrace, GT_2CLASS, "LockMP> process %d is gone, "
+                    "dropping its references\n", procs[i]);
+            releaseProc(i);
+        }
+    }
+}
+
+/*
+ *  ======== releaseProc ========
+ *  Drop all references held by a process table entry, and free it. Must be
+ *  called with the segment locked.
+ */
+static Void releaseProc(Int id)
+{
+    Int *procRefs = &refs[id * numSlots];
+    Int  i;
+
+    for (i = 0; i < numSlots; i++) {
+        if (procRefs[i] > 0) {
+            dropRefs(i, procRefs[i]);
+            procRefs[i] = 0;
+        }
+    }
+
+    procs[id] = 0;
+}
+
+/*
+ *  ======== sizeOf ========
+ *  Size of a segment with the given number of lock slots and processes.
+ */
+static size_t sizeOf(UInt32 nSlots, UInt32 nProcs)
+{
+    return (sizeof(LockMP_Shm) + nSlots * sizeof(LockMP_Slot) +
+            nProcs * sizeof(pid_t) + nProcs * nSlots * sizeof(Int));
+}
+
+/*
+ *  ======== unlockShm ========
+ */
+static Void unlockShm(Void)
+{
+    pthread_mutex_unlock(&shm->lock);
+}
 /*
  *  @(#) ti.sdo.ce.osal.linux; 2, 0, 1,181; 12-2-2010 21:24:46; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
 
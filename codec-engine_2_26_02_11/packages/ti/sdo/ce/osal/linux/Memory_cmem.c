@@ -39,6 +39,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 
 #include <ti/sdo/ce/osal/Global.h>
 #include <ti/sdo/utils/trace/gt.h>
@@ -76,11 +77,38 @@ typedef struct ContigBuf {
     struct ContigBuf *next;
 } ContigBuf;
 
+/*
+ * The list is the master copy; lookups go through two arrays of pointers to
+ * its elements, sorted by virtual and by physical start address, which are
+ * rebuilt whenever the list changes (allocations, frees and registrations,
+ * which are rare compared to the per-process-call translations).
+ * maxEnd[i] is the largest end address of elements 0..i, bounding the
+ * backward search when (stale) elements overlap.
+ *
+ * The list and the arrays are protected by transLock: translations only
+ * take it for reading, so codec threads don't serialize on each other.
+ * Lock order is moduleLock, then transLock.
+ */
+typedef struct ContigBufIndex {
+    ContigBuf **bufs;
+    UInt32     *maxEnd;
+} ContigBufIndex;
+
 /* REMINDER: if you add an initialized static var, reinitialize it at cleanup */
 static Bool curInit = FALSE;
 
 static ContigBuf  *contigBufList = NULL;
 
+static ContigBufIndex virtIndex = { NULL, NULL };
+static ContigBufIndex physIndex = { NULL, NULL };
+static Int numIndexed = 0;
+static Int indexCapacity = 0;
+static pthread_rwlock_t transLock = PTHREAD_RWLOCK_INITIALIZER;
+
+/* translation cache statistics, updated without holding transLock */
+static volatile UInt32 numHits = 0;
+static volatile UInt32 numMisses = 0;
+
 static Bool cmemInitialized = FALSE;
 static Lock_Handle moduleLock = NULL;
 static Int numCmemBlocks = 0;
@@ -120,6 +148,152 @@ static Ptr contigAlloc(UInt size, UInt align, Bool cacheable, Bool heap,
         Int blockId);
 static Bool contigFree(Ptr addr, UInt size, Int type);
 
+/*
+ *  ======== reserveIndex ========
+ *  Makes room in the index for numBufs elements; the caller holds transLock
+ *  for writing. Done before the list is changed so that a failure leaves
+ *  the list and the index consistent.
+ */
+static Bool reserveIndex(Int numBufs)
+{
+    ContigBuf **bufs;
+    UInt32     *maxEnd;
+    Int         i;
+    Int         capacity = indexCapacity > 0 ? indexCapacity : 16;
+
+    while (capacity < numBufs) {
+        capacity *= 2;
+    }
+
+    if (capacity == indexCapacity) {
+        return (TRUE);
+    }
+
+    for (i = 0; i < 2; i++) {
+        ContigBufIndex *index = (i == 0) ? &virtIndex : &physIndex;
+
+        bufs = realloc(index->bufs, capacity * sizeof(ContigBuf *));
+        if (bufs == NULL) {
+            return (FALSE);
+        }
+        index->bufs = bufs;
+
+        maxEnd = realloc(index->maxEnd, capacity * sizeof(UInt32));
+        if (maxEnd == NULL) {
+            return (FALSE);
+        }
+        index->maxEnd = maxEnd;
+    }
+
+    indexCapacity = capacity;
+
+    return (TRUE);
+}
+
+/*
+ *  ======== compareVirt ========
+ */
+static int compareVirt(const void *a, const void *b)
+{
+    UInt32 startA = (*(ContigBuf * const *)a)->virtualAddress;
+    UInt32 startB = (*(ContigBuf * const *)b)->virtualAddress;
+
+    return (startA < startB ? -1 : startA > startB ? 1 : 0);
+}
+
+/*
+ *  ======== comparePhys ========
+ */
+static int comparePhys(const void *a, const void *b)
+{
+    UInt32 startA = (*(ContigBuf * const *)a)->physicalAddress;
+    UInt32 startB = (*(ContigBuf * const *)b)->physicalAddress;
+
+    return (startA < startB ? -1 : startA > startB ? 1 : 0);
+}
+
+/*
+ *  ======== rebuildIndex ========
+ *  Re-sorts the index after the list has changed; the caller holds
+ *  transLock for writing and has reserved room for the list elements.
+ */
+static Void rebuildIndex(Void)
+{
+    ContigBuf *cb;
+    UInt32     end;
+    Int        i;
+
+    numIndexed = 0;
+
+    for (cb = contigBufList; cb != NULL; cb = cb->next) {
+        assert(numIndexed < indexCapacity);
+        virtIndex.bufs[numIndexed] = cb;
+        physIndex.bufs[numIndexed] = cb;
+        numIndexed++;
+    }
+
+    qsort(virtIndex.bufs, numIndexed, sizeof(ContigBuf *), compareVirt);
+    qsort(physIndex.bufs, numIndexed, sizeof(ContigBuf *), comparePhys);
+
+    for (i = 0; i < numIndexed; i++) {
+        end = virtIndex.bufs[i]->virtualAddress +
+            virtIndex.bufs[i]->sizeInBytes;
+        virtIndex.maxEnd[i] = (i > 0 && virtIndex.maxEnd[i - 1] > end) ?
+            virtIndex.maxEnd[i - 1] : end;
+
+        end = physIndex.bufs[i]->physicalAddress +
+            physIndex.bufs[i]->sizeInBytes;
+        physIndex.maxEnd[i] = (i > 0 && physIndex.maxEnd[i - 1] > end) ?
+            physIndex.maxEnd[i - 1] : end;
+    }
+}
+
+/*
+ *  ======== findContigBuf ========
+ *  Returns the element of the index containing [start, end), where start
+ *  is a virtual address if index is virtIndex and a physical one otherwise.
+ *  The caller holds transLock.
+ */
+static ContigBuf *findContigBuf(ContigBufIndex *index, UInt32 start,
+        UInt32 end)
+{
+    ContigBuf *cb;
+    UInt32     cbStart;
+    Int        lo = 0;
+    Int        hi = numIndexed - 1;
+    Int        mid;
+    Int        i = -1;
+
+    /* find the last element starting at or before 'start' */
+    while (lo <= hi) {
+        mid = (lo + hi) / 2;
+        cb = index->bufs[mid];
+        cbStart = (index == &virtIndex) ?
+            cb->virtualAddress : cb->physicalAddress;
+
+        if (cbStart <= start) {
+            i = mid;
+            lo = mid + 1;
+        }
+        else {
+            hi = mid - 1;
+        }
+    }
+
+    /* walk back while an element could still contain the range */
+    for (; (i >= 0) && (index->maxEnd[i] >= end); i--) {
+        cb = index->bufs[i];
+        cbStart = (index == &virtIndex) ?
+            cb->virtualAddress : cb->physicalAddress;
+
+        if (end <= cbStart + cb->sizeInBytes) {
+            return (cb);
+        }
+    }
+
+    return (NULL);
+}
+
 /*
  *  ======== addContigBuf ========
  */
@@ -300,8 +474,32 @@ static Int removeContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes)
 }
 
 
+/*
+ *  ======== insertContigBuf ========
+ *  addContigBuf() with the index kept in sync; the caller holds transLock
+ *  for writing.
+ */
+static ContigBuf *insertContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
+        UInt32 physicalAddress)
+{
+    ContigBuf *cb;
+
+    if (!reserveIndex(numIndexed + 1)) {
+        GT_0trace(curTrace, GT_7CLASS, "Memory__insertContigBuf> "
+                "out of Memory\n");
+        return (NULL);
+    }
+
+    cb = addContigBuf(virtualAddress, sizeInBytes, physicalAddress);
+    rebuildIndex();
+
+    return (cb);
+}
+
+
 /*
  *  ======== getPhysicalAddress ========
+ *  The caller holds transLock.
  */
 static UInt32 getPhysicalAddress(UInt32 virtualAddress, UInt32 sizeInBytes)
 {
@@ -311,27 +509,21 @@ static UInt32 getPhysicalAddress(UInt32 virtualAddress, UInt32 sizeInBytes)
     GT_2trace(curTrace, GT_1CLASS, "Memory__getPhysicalAddress> "
             "Enter(virtAddr=0x%x, size=%d)\n", virtualAddress, sizeInBytes);
 
-    for (cb = contigBufList; cb != NULL; cb = cb->next) {
-
-        UInt32 startCurrent   = cb->virtualAddress;
-        UInt32 endCurrent     = startCurrent + cb->sizeInBytes;
-        UInt32 startSubmitted = virtualAddress;
-        UInt32 endSubmitted   = virtualAddress + sizeInBytes;
-
-        /*
-         *  check if the submitted contigbuf is a subset of (or matches) the
-         *  current contigbuf.
-         */
-        if ((startCurrent <= startSubmitted) && (endSubmitted <= endCurrent)) {
-            /* case 1:  {[      ]} */
-            GT_5trace(curTrace, GT_1CLASS, "Memory__getPhysicalAddress> "
-                    "found in cb(Sc=0x%x, Ec=0x%x, Ss=0x%x, Es=0x%x, "
-                    "PSc=0x%x)\n", startCurrent, endCurrent,
-                    startSubmitted, endSubmitted, cb->physicalAddress);
-            physicalAddress = cb->physicalAddress + (startSubmitted -
-                    startCurrent);
-            break;
-        }
+    /*
+     *  check if the submitted contigbuf is a subset of (or matches) a
+     *  known contigbuf.
+     */
+    cb = findContigBuf(&virtIndex, virtualAddress,
+            virtualAddress + sizeInBytes);
+
+    if (cb != NULL) {
+        /* case 1:  {[      ]} */
+        GT_4trace(curTrace, GT_1CLASS, "Memory__getPhysicalAddress> "
+                "found in cb(Sc=0x%x, Ec=0x%x, Ss=0x%x, PSc=0x%x)\n",
+                cb->virtualAddress, cb->virtualAddress + cb->sizeInBytes,
+                virtualAddress, cb->physicalAddress);
+        physicalAddress = cb->physicalAddress + (virtualAddress -
+                cb->virtualAddress);
     }
 
     GT_1trace(curTrace, GT_1CLASS, "Memory__getPhysicalAddress> "
@@ -343,6 +535,7 @@ static UInt32 getPhysicalAddress(UInt32 virtualAddress, UInt32 sizeInBytes)
 
 /*
  *  ======== getVirtualAddress ========
+ *  The caller holds transLock.
  */
 static UInt32 getVirtualAddress(UInt32 physicalAddress, UInt32 sizeInBytes)
 {
@@ -352,24 +545,17 @@ static UInt32 getVirtualAddress(UInt32 physicalAddress, UInt32 sizeInBytes)
     GT_2trace(curTrace, GT_1CLASS, "Memory__getVirtualAddress> "
             "Enter(physAddr=0x%x, size=%d)\n", physicalAddress, sizeInBytes);
 
-    for (cb = contigBufList; cb != NULL; cb = cb->next) {
-
-        UInt32 startCurrent   = cb->physicalAddress;
-        UInt32 endCurrent     = startCurrent + cb->sizeInBytes;
-        UInt32 startSubmitted = physicalAddress;
-        UInt32 endSubmitted   = physicalAddress + sizeInBytes;
-
-        /* check if the submitted contigbuf is a subset of the current
-         * contigbuf.
-         */
-        if (startCurrent <= startSubmitted &&
-                endCurrent >= endSubmitted) {    /* case 1:  { [      ] } */
-            GT_4trace(curTrace, GT_1CLASS, "Memory__getVirtualAddress> "
-                    "found in cb(Sc=0x%x, Ec=0x%x, Ss=0x%x, Es=0x%x)\n",
-                    startCurrent, endCurrent, startSubmitted, endSubmitted);
-            virtualAddress = cb->virtualAddress + startSubmitted - startCurrent;
-            break;                             /* result:    ^          */
-        }
+    /* check if the submitted contigbuf is a subset of a known contigbuf */
+    cb = findContigBuf(&physIndex, physicalAddress,
+            physicalAddress + sizeInBytes);
+
+    if (cb != NULL) {                          /* case 1:  { [      ] } */
+        GT_4trace(curTrace, GT_1CLASS, "Memory__getVirtualAddress> "
+                "found in cb(Sc=0x%x, Ec=0x%x, Ss=0x%x, Es=0x%x)\n",
+                cb->physicalAddress, cb->physicalAddress + cb->sizeInBytes,
+                physicalAddress, physicalAddress + sizeInBytes);
+        virtualAddress = cb->virtualAddress + physicalAddress -
+            cb->physicalAddress;               /* result:    ^          */
     }
 
     if (virtualAddress == 0) {
@@ -671,7 +857,15 @@ static Ptr contigAlloc(UInt size, UInt align, Bool cacheable, Bool heap,
         if (physAddr != 0) {
             GT_2trace(curTrace, GT_4CLASS, "Memory_contigAlloc> "
                     "CMEM_getPhys(0x%x) = 0x%x.\n", addr, physAddr);
-            addContigBuf((Uint32)addr, size, physAddr);
+            pthread_rwlock_wrlock(&transLock);
+            if (insertContigBuf((Uint32)addr, size, physAddr) == NULL) {
+                GT_1trace(curTrace, GT_7CLASS, "Memory_contigAlloc> "
+                        "ERROR: failed to record 0x%x in the translation "
+                        "cache; releasing the block.\n", addr);
+                CMEM_free(addr, &cmemParams);
+                addr = NULL;
+            }
+            pthread_rwlock_unlock(&transLock);
         } else {
             GT_1trace(curTrace, GT_7CLASS, "Memory_contigAlloc> "
                     "ERROR: CMEM_getPhys(0x%x) (virt-to-phys) failed; "
@@ -709,6 +903,7 @@ Ptr Memory_contigAlloc(UInt size, UInt align)
 static Bool contigFree(Ptr addr, UInt size, Int type)
 {
     Bool retVal = FALSE;
+    Int  status;
     CMEM_AllocParams cmemParams;
 
     GT_2trace(curTrace, GT_ENTER, "Memory_contigFree> "
@@ -720,7 +915,12 @@ static Bool contigFree(Ptr addr, UInt size, Int type)
 
     Lock_acquire( moduleLock );
 
-    if (removeContigBuf((UInt32)addr, size) >= 0) {
+    pthread_rwlock_wrlock(&transLock);
+    status = removeContigBuf((UInt32)addr, size);
+    rebuildIndex();
+    pthread_rwlock_unlock(&transLock);
+
+    if (status >= 0) {
         /* CMEM_free uses just the 'type' param */
         cmemParams.type = type;
         if (CMEM_free(addr, &cmemParams) == 0) {
@@ -782,8 +982,6 @@ UInt32 Memory_getBufferPhysicalAddress(
     UInt32 physicalAddress = 0;
     UInt32 physicalAddressOfLastByte;
 
-    Lock_acquire(moduleLock);
-
     GT_2trace(curTrace, GT_ENTER, "Memory_getBufferPhysicalAddress> "
             "Enter(virtAddr=0x%x, size=%d)\n", virtualAddress, sizeInBytes);
 
@@ -804,14 +1002,20 @@ UInt32 Memory_getBufferPhysicalAddress(
     }
 
     /* first try to find the buffer in our tables */
+    pthread_rwlock_rdlock(&transLock);
     physicalAddress = getPhysicalAddress((UInt32)virtualAddress, sizeInBytes);
+    pthread_rwlock_unlock(&transLock);
 
     if (physicalAddress != 0) {
+        __sync_fetch_and_add(&numHits, 1);
+
         if (isContiguous != NULL) {
             *isContiguous = TRUE;
         }
     }
     else {
+        __sync_fetch_and_add(&numMisses, 1);
+
         /* ask CMEM to convert addresses of the first and the last byte */
         physicalAddress = CMEM_getPhys(virtualAddress);
         GT_2trace(curTrace, GT_1CLASS, "Memory_getBufferPhysicalAddress> "
@@ -850,8 +1054,6 @@ Memory_getBufferPhysicalAddress_return:
     GT_1trace(curTrace, GT_ENTER, "Memory_getBufferPhysicalAddress> "
             "return (0x%x)\n", physicalAddress);
 
-    Lock_release(moduleLock);
-
     return (physicalAddress);
 }
 
@@ -869,8 +1071,6 @@ Ptr Memory_getBufferVirtualAddress(UInt32 physicalAddress, Int sizeInBytes)
 
     UInt32 virtualAddress = 0;
 
-    Lock_acquire( moduleLock );
-
     GT_2trace(curTrace, GT_ENTER, "Memory_getBufferVirtualAddress> "
             "Enter(physAddr=0x%x, size=%d)\n", physicalAddress, sizeInBytes);
 
@@ -887,15 +1087,22 @@ Ptr Memory_getBufferVirtualAddress(UInt32 physicalAddress, Int sizeInBytes)
         goto Memory_getBufferVirtualAddress_return;
     }
 
+    pthread_rwlock_rdlock(&transLock);
     virtualAddress = getVirtualAddress(physicalAddress, sizeInBytes);
+    pthread_rwlock_unlock(&transLock);
+
+    if (virtualAddress != 0) {
+        __sync_fetch_and_add(&numHits, 1);
+    }
+    else {
+        __sync_fetch_and_add(&numMisses, 1);
+    }
 
 Memory_getBufferVirtualAddress_return:
 
     GT_1trace(curTrace, GT_ENTER, "Memory_getBufferVirtualAddress> "
             "return (0x%x)\n", virtualAddress);
 
-    Lock_release( moduleLock );
-
     return (Ptr)virtualAddress;
 }
 
@@ -958,11 +1165,23 @@ static Void cleanup(Void)
             cb = cb->next;
             free(elem);
         }
+        free(virtIndex.bufs);
+        free(virtIndex.maxEnd);
+        free(physIndex.bufs);
+        free(physIndex.maxEnd);
 
         /* reinit static vars */
-        contigBufList   = NULL;
-        cmemInitialized = FALSE;
-        moduleLock      = NULL;
+        contigBufList    = NULL;
+        virtIndex.bufs   = NULL;
+        virtIndex.maxEnd = NULL;
+        physIndex.bufs   = NULL;
+        physIndex.maxEnd = NULL;
+        numIndexed       = 0;
+        indexCapacity    = 0;
+        numHits          = 0;
+        numMisses        = 0;
+        cmemInitialized  = FALSE;
+        moduleLock       = NULL;
     }
 }
 
@@ -972,7 +1191,13 @@ static Void cleanup(Void)
 Void Memory_registerContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
         UInt32 physicalAddress)
 {
-    addContigBuf(virtualAddress, sizeInBytes, physicalAddress);
+    pthread_rwlock_wrlock(&transLock);
+    if (insertContigBuf(virtualAddress, sizeInBytes, physicalAddress) == NULL) {
+        GT_2trace(curTrace, GT_7CLASS, "Memory_registerContigBuf> "
+                  "ERROR: failed to register buffer (addr=0x%x, size=%d)\n",
+                  virtualAddress, sizeInBytes);
+    }
+    pthread_rwlock_unlock(&transLock);
 }
 
 
@@ -981,7 +1206,14 @@ Void Memory_registerContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
  */
 Void Memory_unregisterContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes)
 {
-    if (removeContigBuf(virtualAddress, sizeInBytes) < 0) {
+    Int status;
+
+    pthread_rwlock_wrlock(&transLock);
+    status = removeContigBuf(virtualAddress, sizeInBytes);
+    rebuildIndex();
+    pthread_rwlock_unlock(&transLock);
+
+    if (status < 0) {
         GT_2trace(curTrace, GT_6CLASS, "Memory_unregisterContigBuf> "
                   "Warning: buffer (addr=%d, size=%d) not found in "
                   "translation cache\n",
@@ -1000,6 +1232,8 @@ Void Memory_dumpKnownContigBufsList()
     GT_0trace(curTrace, GT_5CLASS, "Memory_dumpKnownContigBufsList> "
             "following buffers were translated/registered:\n");
 
+    pthread_rwlock_rdlock(&transLock);
+
     cb = contigBufList;
 
     while (cb != NULL) {
@@ -1008,6 +1242,22 @@ Void Memory_dumpKnownContigBufsList()
                 cb->physicalAddress );
         cb = cb->next;
     }
+
+    pthread_rwlock_unlock(&transLock);
+}
+
+
+/*
+ *  ======== Memory_getTranslationStat ========
+ */
+Void Memory_getTranslationStat(Memory_TranslationStat *statbuf)
+{
+    statbuf->hits   = numHits;
+    statbuf->misses = numMisses;
+
+    pthread_rwlock_rdlock(&transLock);
+    statbuf->numBufs = numIndexed;
+    pthread_rwlock_unlock(&transLock);
 }
 
 /*
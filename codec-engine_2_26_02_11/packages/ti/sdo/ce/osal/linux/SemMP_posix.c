@@ -32,15 +32,40 @@
  */
 /*
  *  ======== SemMP_posix.c ========
+ *  Process-shared counting semaphores.
+ *
+ *  All semaphores live in a table in one POSIX shared memory segment, whose
+ *  name is derived from the configured SemMP IPC key; a semaphore is a slot
+ *  in that table identified by the key passed to SemMP_create(), so every
+ *  process that creates a semaphore with the same key gets the same slot.
+ *
+ *  The count of a semaphore is a futex: SemMP_pend() and SemMP_post()
+ *  update it with atomic operations, and only enter the kernel when
+ *  SemMP_pend() has to block, or when SemMP_post() finds a waiter to wake.
+ *  The slot table itself is protected by a robust process-shared mutex.
+ *
+ *  Each process holds a read lock on the segment file while it's attached.
+ *  The first process to attach (i.e. the one that gets the write lock)
+ *  initializes the segment, and sizes its table from the configuration, so
+ *  state left over by processes that died is discarded once they are all
+ *  gone.
  */
 
 #include <xdc/std.h>
 
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
 #include <sys/types.h>
-#include <sys/ipc.h>
-#include <sys/sem.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include <ti/sdo/utils/trace/gt.h>
 #include <ti/sdo/ce/osal/Memory.h>
@@ -48,63 +73,51 @@
 
 #include <ti/sdo/ce/osal/SemMP.h>
 
-/*
- *  Linux IPC semaphores are identified by a 32 bit key, and the same semaphore
- *  can be obtained accross processes by calling semget() with the same key.
- *  These semaphores actually consist of an array of semaphores. We use a
- *  semaphore with an array of 2 semaphores to implement the SemMP_Obj. The
- *  first semaphore in the array will hold the semaphore count, and the second
- *  will hold a reference count of the number of times that the semaphore
- *  has been "created" (ie the number of times semget() has been called for
- *  the given key).
- */
-#define _SemMP_SEMCOUNT 0 /* Array index of semaphore holding the count */
-#define _SemMP_REFCOUNT 1 /* Array index of semaphore holding the ref count */
-
-#define NUMSEMS 2 /* Size of semaphore array */
+#define SHMMAGIC    0x53454d50  /* 'SEMP' */
 
 /*
- *  ID of semaphore for handling critical sections in this module. This is
- *  auto-generated by Global.xdt.
+ *  Key used to name the shared memory segment holding the semaphores. This
+ *  is auto-generated by Global.xdt.
  */
 extern UInt32 ti_sdo_ce_osal_linux_SemMP_ipcKey;
 
-/* Maximum tries to enter critical section before printing warning */
-#define MAXCOUNT 100000
+/*
+ *  Number of semaphore slots of the segment. Only the process that
+ *  initializes the segment uses this; the others use the size recorded in
+ *  the segment. No configuration template generates it: the application
+ *  must define it, as utils/rtcfg/rtcfg_linux.c does.
+ */
+extern UInt32 ti_sdo_ce_osal_linux_SemMP_maxSems;
 
+/*
+ *  ======== SemMP_Slot ========
+ *  A semaphore, as it lives in the shared memory segment.
+ */
+typedef struct SemMP_Slot {
+    Int             key;        /* 0 if the slot is free */
+    Int             refCount;   /* number of SemMP_create() calls */
+    volatile Int    count;      /* futex, the semaphore count */
+    volatile Int    waiters;    /* number of threads blocked on count */
+} SemMP_Slot;
 
+/*
+ *  ======== SemMP_Shm ========
+ *  Header of the shared memory segment, followed by numSlots SemMP_Slot's.
+ */
+typedef struct SemMP_Shm {
+    volatile UInt32 magic;      /* set once the segment is initialized */
+    UInt32          size;
+    UInt32          numSlots;
+    pthread_mutex_t lock;       /* protects the slot table */
+} SemMP_Shm;
 
 /*
  *  ======== SemMP_Obj ========
  */
 typedef struct SemMP_Obj {
-    Int id;     /* ID of IPC semaphore */
+    SemMP_Slot *slot;   /* the semaphore in the shared memory segment */
 } SemMP_Obj;
 
-/*
- *  ======== SemUnion ========
- *  Linux semctl() calls take as one of the arguments, a parameter of the
- *  following type:
- *
- *  union semun {
- *     int              val;    * Value for SETVAL *
- *     struct semid_ds *buf;    * Buffer for IPC_STAT, IPC_SET *
- *     unsigned short  *array;  * Array for GETALL, SETALL *
- *     struct seminfo  *__buf;  * Buffer for IPC_INFO (Linux specific) *
- * };
- *
- *  In some earlier versions of glibc, the semun union was defined in
- *  <sys/sem.h>, but POSIX.1-2001 requires that the caller define this union.
- *  On versions of glibc where this union is not defined, the macro
- *  _SEM_SEMUN_UNDEFINED is defined in <sys/sem.h>.
- */
-typedef union SemUnion {
-    Int val;
-    struct semid_ds *buf;
-    unsigned short *array;
-    struct seminfo  *__buf;
-} SemUnion;
-
 /*
  *  REMINDER: If you add an initialized static variable, reinitialize it at
  *  cleanup
@@ -112,125 +125,87 @@ typedef union SemUnion {
 static Int curInit = 0;
 static GT_Mask curTrace = {NULL, NULL};
 
+static Int shmFd = -1;
+static SemMP_Shm *shm = NULL;
+static size_t shmSize = 0;
+static SemMP_Slot *slots = NULL;     /* the table following the header */
+static UInt32 numSlots = 0;
+
 static Void    cleanup(Void);
 
-static Int enterCS(Int key);
-static Void exitCS(Int id);
+static Bool attach(Void);
+static Void detach(Void);
+static Void lockShm(Void);
+static Void unlockShm(Void);
 
 /*
  *  ======== SemMP_create ========
  */
 SemMP_Handle SemMP_create(Int key, Int count)
 {
-    Int     mutexId;
-    Int     semId;
-    SemMP_Obj *sem;
-    SemUnion semU;
-    struct sembuf semBuf;
+    SemMP_Obj  *sem;
+    SemMP_Slot *slot = NULL;
+    SemMP_Slot *freeSlot = NULL;
+    Int         i;
 
     GT_2trace(curTrace, GT_ENTER, "SemMP_create> key: 0x%x count: %d\n", key,
             count);
 
+    GT_assert(curTrace, key != 0);
+
+    if (shm == NULL) {
+        GT_0trace(curTrace, GT_7CLASS, "SemMP_create> not attached to the "
+                "shared memory segment\n");
+        return (NULL);
+    }
+
     if ((sem = (SemMP_Obj *)Memory_alloc(sizeof(SemMP_Obj), NULL)) == NULL) {
         GT_0trace(curTrace, GT_7CLASS, "SemMP_create> Memory_alloc failed\n");
         return (NULL);
     }
 
-    /* Enter critical section */
-    mutexId = enterCS(ti_sdo_ce_osal_linux_SemMP_ipcKey);
-
-    /*
-     *  First try to create semaphore with exclusive access, so we know
-     *  whether or not it has already been created.
-     */
-    semId = semget((key_t)key, NUMSEMS, 0666 | IPC_CREAT | IPC_EXCL);
+    lockShm();
 
-    if (semId == -1) {
-        /* Semaphore may have already been created */
-        semId = semget((key_t)key, NUMSEMS, 0666 | IPC_CREAT);
-        if (semId == -1) {
-            /* Error */
-
-            /* Leave critical section */
-            exitCS(mutexId);
-
-            GT_1trace(curTrace, GT_7CLASS, "SemMP_create> semget 0x%x failed\n",
-                    key);
-            Memory_free(sem, sizeof(SemMP_Obj), NULL);
-            return (NULL);
+    for (i = 0; i < numSlots; i++) {
+        if (slots[i].key == key) {
+            /* Already created by this or another process */
+            slot = &slots[i];
+            break;
+        }
+        if ((freeSlot == NULL) && (slots[i].key == 0)) {
+            freeSlot = &slots[i];
         }
-
-        /* Successfully attached to existing semaphore */
     }
-    else {
+
+    if ((slot == NULL) && (freeSlot != NULL)) {
         /*
          *  This is the first time this semaphore has been created, so
          *  we need to initialize its value.
          */
-        semU.val = count;
-        if (semctl(semId, _SemMP_SEMCOUNT, SETVAL, semU) == -1) {
-            GT_1trace(curTrace, GT_7CLASS,
-                    "SemMP_create> Failed to init count of 0x%x\n", semId);
-
-            /*
-             *  Failed to set value, try to delete semaphore. Note: the second
-             *  argument (semaphore number) will be ignored in this call.
-             */
-            if (semctl(semId, 0, IPC_RMID, semU) == -1) {
-                GT_1trace(curTrace, GT_7CLASS,
-                        "SemMP_create> semctl(0x%x, 0, IPC_RMID,...) failed\n",
-                        semId);
-            }
-
-            /* Leave critical section */
-            exitCS(mutexId);
-
-            Memory_free(sem, sizeof(SemMP_Obj), NULL);
-            return (NULL);
-        }
-
-        /* Use the second semaphore as a reference count, initialize to 0 */
-        semU.val = 0;
-        if (semctl(semId, _SemMP_REFCOUNT, SETVAL, semU) == -1) {
-            GT_1trace(curTrace, GT_7CLASS,
-                    "SemMP_create> Failed to init ref count of 0x%x\n", semId);
-
-            /*
-             *  Failed to set value, try to delete semaphore. Note: the second
-             *  argument (semaphore number) will be ignored in this call.
-             */
-            if (semctl(semId, 0, IPC_RMID, semU) == -1) {
-                GT_1trace(curTrace, GT_7CLASS,
-                        "SemMP_create> semctl(0x%x, 0, IPC_RMID,...) failed\n",
-                        semId);
-            }
+        slot = freeSlot;
+        slot->key = key;
+        slot->refCount = 0;
+        slot->count = count;
+        slot->waiters = 0;
+    }
 
-            /* Leave critical section */
-            exitCS(mutexId);
+    if (slot != NULL) {
+        slot->refCount++;
 
-            Memory_free(sem, sizeof(SemMP_Obj), NULL);
-            return (NULL);
-        }
+        GT_2trace(curTrace, GT_ENTER, "SemMP_create> key: 0x%x refCount: %d\n",
+                key, slot->refCount);
     }
 
-    sem->id = semId;
-
-    /* Increment reference count */
-    semBuf.sem_num = _SemMP_REFCOUNT;
-    semBuf.sem_op = 1;
-    semBuf.sem_flg = SEM_UNDO;
+    unlockShm();
 
-    if (semop(semId, &semBuf, 1) == -1) {
-        GT_1trace(curTrace, GT_7CLASS,
-                "SemMP_create> Failed to increment ref count on 0x%x\n", semId);
-        GT_assert(curTrace, 0 == 1);
+    if (slot == NULL) {
+        GT_2trace(curTrace, GT_7CLASS, "SemMP_create> no free slot for key "
+                "0x%x, all %d are in use\n", key, numSlots);
+        Memory_free(sem, sizeof(SemMP_Obj), NULL);
+        return (NULL);
     }
 
-    GT_2trace(curTrace, GT_ENTER, "SemMP_create> semId: 0x%x refCount: %d\n",
-            semId, semctl(semId, _SemMP_REFCOUNT, GETVAL, semU));
-
-    /* Leave critical section */
-    exitCS(mutexId);
+    sem->slot = slot;
 
     GT_1trace(curTrace, GT_ENTER, "Leaving SemMP_create> sem[0x%x]\n", sem);
 
@@ -242,54 +217,25 @@ SemMP_Handle SemMP_create(Int key, Int count)
  */
 Void SemMP_delete(SemMP_Handle sem)
 {
-    Int     mutexId;
-    Int     refCount;
-    SemUnion semU;
-    struct sembuf semBuf;
-
     GT_1trace(curTrace, GT_ENTER, "Entered SemMP_delete> sem[0x%x]\n", sem);
 
     if (sem != NULL) {
-        /* Enter critical section */
-        mutexId = enterCS(ti_sdo_ce_osal_linux_SemMP_ipcKey);
+        lockShm();
 
-        GT_2trace(curTrace, GT_ENTER, "SemMP_delete> sem: 0x%x, ref count: %d\n",
-                sem->id, semctl(sem->id, _SemMP_REFCOUNT, GETVAL, semU));
+        GT_2trace(curTrace, GT_ENTER, "SemMP_delete> key: 0x%x, ref count: "
+                "%d\n", sem->slot->key, sem->slot->refCount);
 
-        /* Decrement the reference count */
-        semBuf.sem_num = _SemMP_REFCOUNT;
-        semBuf.sem_op = -1;
-        semBuf.sem_flg = SEM_UNDO;
+        GT_assert(curTrace, sem->slot->refCount > 0);
 
-        if (semop(sem->id, &semBuf, 1) == -1) {
-            GT_1trace(curTrace, GT_7CLASS,
-                    "Failed to decrement reference count on sem 0x%x\n",
-                    sem->id);
-        }
-
-        refCount = semctl(sem->id, _SemMP_REFCOUNT, GETVAL, semU);
+        if (--sem->slot->refCount == 0) {
+            GT_1trace(curTrace, GT_1CLASS,
+                    "SemMP_delete> Deleted semaphore: 0x%x\n", sem->slot->key);
 
-        if (refCount == 0) {
-            /* Try to remove the semaphore */
-            if (semctl(sem->id, 0, IPC_RMID, semU) == -1) {
-                GT_1trace(curTrace, GT_7CLASS,
-                        "SemMP_delete> Failed to delete semaphore: 0x%x\n",
-                        sem->id);
-            }
-            else {
-                GT_1trace(curTrace, GT_1CLASS,
-                        "SemMP_delete> Deleted semaphore: 0x%x\n", sem->id);
-            }
-        }
-        else if (refCount < 0) {
-            GT_2trace(curTrace, GT_7CLASS,
-                    "SemMP_delete> semctl returned ref count %d on sem 0x%x\n",
-                    refCount, sem->id);
-            GT_assert(curTrace, refCount >= 0);
+            /* Free the slot */
+            sem->slot->key = 0;
         }
 
-        /* Leave critical section */
-        exitCS(mutexId);
+        unlockShm();
 
         Memory_free(sem, sizeof(SemMP_Obj), NULL);
     }
@@ -302,12 +248,7 @@ Void SemMP_delete(SemMP_Handle sem)
  */
 Int SemMP_getCount(SemMP_Handle sem)
 {
-    SemUnion semU;
-    Int      count;
-
-    count = semctl(sem->id, _SemMP_SEMCOUNT, GETVAL, semU);
-
-    return (count);
+    return (sem->slot->count);
 }
 
 /*
@@ -315,12 +256,7 @@ Int SemMP_getCount(SemMP_Handle sem)
  */
 Int SemMP_getRefCount(SemMP_Handle sem)
 {
-    SemUnion semU;
-    Int      count;
-
-    count = semctl(sem->id, _SemMP_REFCOUNT, GETVAL, semU);
-
-    return (count);
+    return (sem->slot->refCount);
 }
 
 /*
@@ -331,6 +267,11 @@ Void SemMP_init(Void)
     if (curInit++ == 0) {
         GT_create(&curTrace, SemMP_GTNAME);
 
+        if (!attach()) {
+            GT_0trace(curTrace, GT_7CLASS, "SemMP_init> failed to attach to "
+                    "the shared memory segment\n");
+        }
+
         Global_atexit((Fxn)cleanup);
     }
 }
@@ -340,24 +281,68 @@ Void SemMP_init(Void)
  */
 Int SemMP_pend(SemMP_Handle sem, UInt32 timeout)
 {
-    Int    status = SemMP_EOK;
-    struct sembuf semBuf;
+    SemMP_Slot     *slot = sem->slot;
+    Int             status = SemMP_EOK;
+    Int             count;
+    struct timespec deadline;
+    struct timespec *dp = NULL;
 
     GT_2trace(curTrace, GT_ENTER,
             "Entered SemMP_pend> sem[0x%x] timeout[0x%x]\n", sem, timeout);
 
-    /* Timeouts not supported yet */
-    GT_assert(curTrace, timeout == SemMP_FOREVER);
+    /* The timeout is in microseconds */
+    if ((timeout != SemMP_FOREVER) && (timeout != SemMP_POLL)) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout / 1000000;
+        deadline.tv_nsec += (timeout % 1000000) * 1000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        dp = &deadline;
+    }
 
-    semBuf.sem_num = _SemMP_SEMCOUNT;
-    semBuf.sem_op = -1;
-    semBuf.sem_flg = SEM_UNDO;
+    for (;;) {
+        /* Uncontended case, take a count without entering the kernel */
+        count = slot->count;
+        if (count > 0) {
+            if (__sync_bool_compare_and_swap(&slot->count, count, count - 1)) {
+                break;
+            }
+            continue;
+        }
+
+        if (timeout == SemMP_POLL) {
+            status = SemMP_ETIMEOUT;
+            break;
+        }
 
-    /* TODO: Figure out how to do timeout */
-    if (semop(sem->id, &semBuf, 1) == -1) {
-        status = SemMP_EFAIL;
-        GT_1trace(curTrace, GT_7CLASS, "SemMP_pend [0x%x] failed\n", sem->id);
-        GT_assert(curTrace, status == SemMP_EOK);
+        /*
+         *  Announce ourselves before sleeping; a post that doesn't see us
+         *  must have raised the count first, so the futex wait below
+         *  returns at once instead of sleeping.  FUTEX_WAIT_BITSET takes an
+         *  absolute CLOCK_MONOTONIC deadline, so signals and spurious
+         *  wakeups don't extend the total wait.
+         */
+        __sync_fetch_and_add(&slot->waiters, 1);
+
+        if ((syscall(SYS_futex, &slot->count, FUTEX_WAIT_BITSET, 0, dp, NULL,
+                FUTEX_BITSET_MATCH_ANY) < 0) && (errno != EAGAIN) &&
+                (errno != EINTR)) {
+            __sync_fetch_and_sub(&slot->waiters, 1);
+
+            if (errno == ETIMEDOUT) {
+                status = SemMP_ETIMEOUT;
+            }
+            else {
+                status = SemMP_EFAIL;
+                GT_1trace(curTrace, GT_7CLASS, "SemMP_pend [0x%x] failed\n",
+                        slot->key);
+            }
+            break;
+        }
+
+        __sync_fetch_and_sub(&slot->waiters, 1);
     }
 
     GT_2trace(curTrace, GT_ENTER, "Leaving SemMP_pend> sem[0x%x] status[%d]\n",
@@ -371,22 +356,154 @@ Int SemMP_pend(SemMP_Handle sem, UInt32 timeout)
  */
 Void SemMP_post(SemMP_Handle sem)
 {
-    struct sembuf semBuf;
+    SemMP_Slot *slot = sem->slot;
 
     GT_1trace(curTrace, GT_ENTER, "Entered SemMP_post> sem[0x%x]\n", sem);
 
-    semBuf.sem_num = _SemMP_SEMCOUNT;
-    semBuf.sem_op = 1;
-    semBuf.sem_flg = SEM_UNDO;
+    __sync_fetch_and_add(&slot->count, 1);
 
-    if (semop(sem->id, &semBuf, 1) == -1) {
-        /* Should never happen */
-        GT_1trace(curTrace, GT_7CLASS, "SemMP_post [0x%x] failed\n", sem->id);
+    /* Only enter the kernel if someone is blocked in SemMP_pend() */
+    if (slot->waiters > 0) {
+        if (syscall(SYS_futex, &slot->count, FUTEX_WAKE, 1, NULL, NULL, 0)
+                < 0) {
+            /* Should never happen */
+            GT_1trace(curTrace, GT_7CLASS, "SemMP_post [0x%x] failed\n",
+                    slot->key);
+        }
     }
 
     GT_1trace(curTrace, GT_ENTER, "Leaving SemMP_post> sem[0x%x]\n", sem);
 }
 
+/*
+ *  ======== attach ========
+ *  Map the shared memory segment, initializing it if we're the first
+ *  process to do so.
+ */
+static Bool attach(Void)
+{
+    Char                shmName[NAME_MAX];
+    struct flock        lock;
+    struct stat         st;
+    pthread_mutexattr_t mattrs;
+    Bool                first;
+    Int                 i;
+
+    snprintf(shmName, sizeof(shmName), "/ti_sdo_ce_SemMP_%08x",
+            (unsigned int)ti_sdo_ce_osal_linux_SemMP_ipcKey);
+
+    if ((shmFd = shm_open(shmName, O_RDWR | O_CREAT, 0666)) < 0) {
+        GT_2trace(curTrace, GT_7CLASS, "SemMP_init> shm_open of %s failed "
+                "(errno %d)\n", shmName, errno);
+        return (FALSE);
+    }
+
+    /* like IPC semaphores, let other users share the segment */
+    fchmod(shmFd, 0666);
+
+    lock.l_whence = SEEK_SET;
+    lock.l_start = 0;
+    lock.l_len = 0;
+
+    /* a write lock is only granted if no other process is attached */
+    lock.l_type = F_WRLCK;
+    first = (fcntl(shmFd, F_SETLK, &lock) == 0);
+
+    if (first) {
+        numSlots = ti_sdo_ce_osal_linux_SemMP_maxSems > 0 ?
+                ti_sdo_ce_osal_linux_SemMP_maxSems : 1;
+        shmSize = sizeof(SemMP_Shm) + numSlots * sizeof(SemMP_Slot);
+
+        if (ftruncate(shmFd, shmSize) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "SemMP_init> ftruncate of %s "
+                    "failed (errno %d)\n", shmName, errno);
+            goto fail;
+        }
+    }
+    else {
+        /* blocks until the first process is done initializing */
+        lock.l_type = F_RDLCK;
+        if (fcntl(shmFd, F_SETLKW, &lock) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "SemMP_init> fcntl of %s failed "
+                    "(errno %d)\n", shmName, errno);
+            goto fail;
+        }
+
+        if ((fstat(shmFd, &st) < 0) ||
+                ((size_t)st.st_size < sizeof(SemMP_Shm))) {
+            GT_1trace(curTrace, GT_7CLASS, "SemMP_init> %s has an "
+                    "unexpected size\n", shmName);
+            goto fail;
+        }
+        shmSize = st.st_size;
+    }
+
+    shm = mmap(NULL, shmSize, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    if (shm == MAP_FAILED) {
+        GT_2trace(curTrace, GT_7CLASS, "SemMP_init> mmap of %s failed "
+                "(errno %d)\n", shmName, errno);
+        shm = NULL;
+        goto fail;
+    }
+
+    slots = (SemMP_Slot *)(shm + 1);
+
+    if (first) {
+        GT_2trace(curTrace, GT_2CLASS, "SemMP_init> initializing %s, %d "
+                "semaphores\n", shmName, numSlots);
+
+        shm->size = shmSize;
+        shm->numSlots = numSlots;
+
+        pthread_mutexattr_init(&mattrs);
+        pthread_mutexattr_setpshared(&mattrs, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&mattrs, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&shm->lock, &mattrs);
+        pthread_mutexattr_destroy(&mattrs);
+
+        for (i = 0; i < numSlots; i++) {
+            slots[i].key = 0;
+            slots[i].refCount = 0;
+            slots[i].count = 0;
+            slots[i].waiters = 0;
+        }
+
+        shm->magic = SHMMAGIC;
+
+        /* let the others in, and stay attached */
+        lock.l_type = F_RDLCK;
+        if (fcntl(shmFd, F_SETLK, &lock) < 0) {
+            GT_2trace(curTrace, GT_7CLASS, "SemMP_init> fcntl of %s failed "
+                    "(errno %d)\n", shmName, errno);
+            goto fail;
+        }
+    }
+    else {
+        if (shm->magic != SHMMAGIC) {
+            GT_1trace(curTrace, GT_7CLASS, "SemMP_init> %s is not "
+                    "initialized\n", shmName);
+            goto fail;
+        }
+
+        numSlots = shm->numSlots;
+
+        if ((shm->size != shmSize) ||
+                (sizeof(SemMP_Shm) + numSlots * sizeof(SemMP_Slot) !=
+                shmSize)) {
+            GT_1trace(curTrace, GT_7CLASS, "SemMP_init> %s has an "
+                    "unexpected size\n", shmName);
+            goto fail;
+        }
+    }
+
+    return (TRUE);
+
+fail:
+    detach();
+
+    return (FALSE);
+}
+
 /*
  *  ======== cleanup ========
  */
@@ -395,76 +512,48 @@ static Void cleanup(Void)
     GT_assert(curTrace, curInit > 0);
 
     if (--curInit == 0) {
-        /* Nothing to do */
+        detach();
     }
 }
 
 /*
- *  ======== enterCS ========
- *  Enter critical section
- *  WARNING: Calls to this function with the same key cannot be nested!
+ *  ======== detach ========
  */
-static Int enterCS(Int key)
+static Void detach(Void)
 {
-    Int     count = 0;
-    Int     id = 0;
-
-    GT_1trace(curTrace, GT_ENTER, "Entered enterCS> key[0x%x]\n", key);
-
-    /*
-     *  Attempt to create a new semaphore with this key, for exclusive
-     *  access. If this call fails, we assume it's because another process
-     *  has created it. In that case we loop until we can create it.
-     */
-    id = semget((key_t)key, 1, 0666 | IPC_CREAT | IPC_EXCL);
-
-    while (id == -1) {
-        /* Yield */
-        count++;
-
-        if (count > MAXCOUNT) {
-            GT_1trace(curTrace, GT_6CLASS,
-                    "enterCS> Timing out trying to enter critical "
-                    "section, key = 0x%x\n", key);
-            count = 0;
-        }
-
-        usleep(1);
-
-        /*
-         *  Wait til the semaphore is removed by the other process so we
-         *  can get it for ourself.
-         */
-        id = semget((key_t)key, 1, 0666 | IPC_CREAT | IPC_EXCL);
+    if (shm != NULL) {
+        munmap(shm, shmSize);
+        shm = NULL;
     }
 
-    GT_1trace(curTrace, GT_ENTER, "Leaving enterCS> id[0x%x]\n", id);
+    slots = NULL;
+    numSlots = 0;
+    shmSize = 0;
 
-    return (id);
+    if (shmFd >= 0) {
+        /* drops our read lock */
+        close(shmFd);
+        shmFd = -1;
+    }
 }
 
 /*
- *  ======== exitCS ========
- *  Exit critical section
+ *  ======== lockShm ========
  */
-static Void exitCS(Int id)
+static Void lockShm(Void)
 {
-    SemUnion semU;
-
-    GT_1trace(curTrace, GT_ENTER, "Entered exitCS> id[0x%x]\n", id);
-
-    /*
-     *  Delete the semaphore  Note: the second argument (semaphore number)
-     *  will be ignored in this call.
-     */
-    if (semctl(id, 0, IPC_RMID, semU) == -1) {
-        /* Error that should never happen. */
-        GT_1trace(curTrace, GT_7CLASS,
-                "exitCS> semctl(%d, 0, IPC_RMID,...) failed!\n", id);
-        GT_assert(curTrace, 0 == 1);
+    if (pthread_mutex_lock(&shm->lock) == EOWNERDEAD) {
+        /* the slot table is updated atomically enough to be reused */
+        pthread_mutex_consistent(&shm->lock);
     }
+}
 
-    GT_0trace(curTrace, GT_ENTER, "Leaving exitCS\n");
+/*
+ *  ======== unlockShm ========
+ */
+static Void unlockShm(Void)
+{
+    pthread_mutex_unlock(&shm->lock);
 }
 /*
  *  @(#) ti.sdo.ce.osal.linux; 2, 0, 1,181; 12-2-2010 21:24:47; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
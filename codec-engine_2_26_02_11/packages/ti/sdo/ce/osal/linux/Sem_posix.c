@@ -36,6 +36,8 @@
 
 #include <xdc/std.h>
 
+#include <errno.h>
+#include <time.h>
 #include <semaphore.h>
 
 #include <ti/sdo/utils/trace/gt.h>
@@ -49,6 +51,13 @@
 
 #define NUMSEMS 2 /* Size of semaphore array */
 
+/* sem_clockwait() appeared in glibc 2.30 */
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC_MINOR__ >= 30))
+#define SEM_CLOCKWAIT
+#define SEM_CLOCK CLOCK_MONOTONIC
+#else
+#define SEM_CLOCK CLOCK_REALTIME
+#endif
 
 
 /*
@@ -142,14 +151,48 @@ Void Sem_init(Void)
 Int Sem_pend(Sem_Handle sem, UInt32 timeout)
 {
     Int    status = Sem_EOK;
+    Int    ret;
+    struct timespec deadline;
 
     GT_2trace(curTrace, GT_ENTER,
             "Entered Sem_pend> sem[0x%x] timeout[0x%x]\n", sem, timeout);
 
-    /* Timeouts not supported yet */
-    GT_assert(curTrace, timeout == Sem_FOREVER);
+    /* The timeout is in microseconds */
+    if (timeout == Sem_FOREVER) {
+        while ((ret = sem_wait(&(sem->sem))) != 0 && errno == EINTR) {
+        }
+    }
+    else if (timeout == Sem_POLL) {
+        ret = sem_trywait(&(sem->sem));
+    }
+    else {
+        /*
+         * Use an absolute deadline on the monotonic clock where possible,
+         * so neither interruptions nor wall-clock steps stretch the wait.
+         */
+        clock_gettime(SEM_CLOCK, &deadline);
+        deadline.tv_sec += timeout / 1000000;
+        deadline.tv_nsec += (timeout % 1000000) * 1000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+
+#ifdef SEM_CLOCKWAIT
+        while ((ret = sem_clockwait(&(sem->sem), SEM_CLOCK, &deadline)) != 0
+                && errno == EINTR) {
+        }
+#else
+        while ((ret = sem_timedwait(&(sem->sem), &deadline)) != 0 &&
+                errno == EINTR) {
+        }
+#endif
+    }
 
-    sem_wait(&(sem->sem)); /* TODO: can try sem_timedwait */
+    if (ret != 0) {
+        status = (errno == ETIMEDOUT || errno == EAGAIN) ? Sem_ETIMEOUT :
+                Sem_EFAIL;
+    }
 
     GT_2trace(curTrace, GT_ENTER, "Leaving Sem_pend> sem[0x%x] status[%d]\n",
             sem, status);
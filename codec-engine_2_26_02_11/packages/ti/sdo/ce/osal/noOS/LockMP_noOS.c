@@ -33,11 +33,14 @@
 /*
  *  ======== LockMP_noOS.c ========
  *  CERuntime_init() calls LockMP_init() so we need this for non-posix
- *  libraries (in non-posix case, Lock can be used instead).
+ *  libraries (in non-posix case, Lock can be used instead). The alg
+ *  module's scratch group locks are LockMPs, so these are real objects,
+ *  like the noOS SemMPs.
  */
 
 #include <xdc/std.h>
 
+#include <ti/sdo/ce/osal/Memory.h>
 #include <ti/sdo/ce/osal/LockMP.h>
 
 /*
@@ -52,6 +55,7 @@ typedef struct LockMP_Obj {
  */
 Void LockMP_acquire(LockMP_Handle lock)
 {
+    lock->count++;
 }
 
 /*
@@ -59,7 +63,16 @@ Void LockMP_acquire(LockMP_Handle lock)
  */
 LockMP_Handle LockMP_create(Int key)
 {
-    return (NULL);
+    LockMP_Handle lock;
+
+    if ((lock = (LockMP_Obj *)Memory_alloc(sizeof(LockMP_Obj), NULL)) ==
+            NULL) {
+        return (NULL);
+    }
+
+    lock->count = 0;
+
+    return (lock);
 }
 
 /*
@@ -67,6 +80,9 @@ LockMP_Handle LockMP_create(Int key)
  */
 Void LockMP_delete(LockMP_Handle lock)
 {
+    if (lock != NULL) {
+        Memory_free(lock, sizeof(LockMP_Obj), NULL);
+    }
 }
 
 /*
@@ -74,7 +90,7 @@ Void LockMP_delete(LockMP_Handle lock)
  */
 Int LockMP_getCount(LockMP_Handle lock)
 {
-    return (0);
+    return (lock->count);
 }
 
 /*
@@ -82,7 +98,7 @@ Int LockMP_getCount(LockMP_Handle lock)
  */
 Int LockMP_getRefCount(LockMP_Handle lock)
 {
-    return (0);
+    return (1);
 }
 
 /*
@@ -97,6 +113,7 @@ Void LockMP_init(Void)
  */
 Void LockMP_release(LockMP_Handle lock)
 {
+    lock->count--;
 }
 
 /*
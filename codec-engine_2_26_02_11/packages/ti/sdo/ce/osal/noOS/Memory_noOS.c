@@ -325,6 +325,16 @@ Void Memory_unregisterContigBuf( UInt32 virtualAddress, UInt32 sizeInBytes )
 Void Memory_dumpKnownContigBufsList()
 {
 }
+
+/*
+ *  ======== Memory_getTranslationStat ========
+ */
+Void Memory_getTranslationStat(Memory_TranslationStat *statbuf)
+{
+    statbuf->hits    = 0;
+    statbuf->misses  = 0;
+    statbuf->numBufs = 0;
+}
 /*
  *  @(#) ti.sdo.ce.osal.noOS; 2, 0, 1,181; 12-2-2010 21:24:50; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
 
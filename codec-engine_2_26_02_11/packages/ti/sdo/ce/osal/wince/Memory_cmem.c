@@ -1009,6 +1009,16 @@ Void Memory_dumpKnownContigBufsList()
     }
 }
 
+/*
+ *  ======== Memory_getTranslationStat ========
+ */
+Void Memory_getTranslationStat(Memory_TranslationStat *statbuf)
+{
+    statbuf->hits    = 0;
+    statbuf->misses  = 0;
+    statbuf->numBufs = 0;
+}
+
 /*
  *  @(#) ti.sdo.ce.osal.wince; 1, 0, 0,82; 12-2-2010 21:25:04; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
 
@@ -78,7 +78,7 @@ extern IALG_Fxns UNIVERSAL_STUBS;
 
 /*
  *  The following variable is the base value of a group of IDs for the up to 20
- *  multi-process semaphores created by the alg module. In the case of Linux,
+ *  multi-process locks created by the alg module. In the case of Linux,
  *  the 20 consecutive interger values starting with this base will be used
  *  for internal Linux IPC objects. In the case of WinCE, these values will
  *  be converted to strings for creating named semaphores.
@@ -88,18 +88,35 @@ extern IALG_Fxns UNIVERSAL_STUBS;
  */
 UInt32 ti_sdo_ce_alg_ipcKey = 0x4f474c41;
 
+/*
+ *  Which memory of locally created algorithms is cleared when it is
+ *  allocated: 0 (ALG_ZEROMEM_ALL) clears everything, 1 (ALG_ZEROMEM_PERSIST)
+ *  leaves scratch memory as allocated, and 2 (ALG_ZEROMEM_NONE) only clears
+ *  the instance object. XDAIS algorithms initialize their own memory in
+ *  algInit(), so clearing large scratch buffers only costs create time.
+ */
+UInt32 ti_sdo_ce_alg_ALG_zeroMem = 0;
+
+/*
+ *  Number of bytes of memory from deleted algorithms that may be kept,
+ *  cleared, to create the next algorithms with. This speeds up deleting and
+ *  re-creating a codec (e.g. on a resolution change), at the cost of holding
+ *  on to up to this much contiguous memory. 0 disables recycling.
+ */
+UInt32 ti_sdo_ce_alg_ALG_recycleSize = 0;
+
 /*
  *  ====================================================
  *  None of the code below this line should be modified!
  *  ====================================================
  */
 
-#include <ti/sdo/ce/osal/SemMP.h>
+#include <ti/sdo/ce/osal/LockMP.h>
 #include <ti/xdais/ialg.h>
 
 unsigned int ti_sdo_ce_alg_ALG_maxGroups = 20;
 
-SemMP_Handle _ALG_sems[20];
+LockMP_Handle _ALG_locks[20];
 
 IALG_Handle _Algorithm_lockOwner[20] = {
      NULL, NULL, NULL, NULL, NULL,
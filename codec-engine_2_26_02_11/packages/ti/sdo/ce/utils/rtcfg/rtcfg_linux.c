@@ -72,12 +72,35 @@ GT_Config *GT = &_ti_sdo_utils_trace_GT_params;
  */
 
 /*
- *  Linux IPC key used internally by SemMP module. This should not need to be
- *  changed, unless (in the remote chance) it conflicts with the key of
- *  another Linux IPC object in the system.
+ *  Key used internally by the SemMP and LockMP modules to name their shared
+ *  memory segments. This should not need to be changed, unless (in the
+ *  remote chance) it conflicts with another application's segments.
  */
 UInt32 ti_sdo_ce_osal_linux_SemMP_ipcKey = 0x4c41534f;
 
+/*
+ *  Number of semaphores and locks that all processes together can create,
+ *  and number of processes whose locks are tracked, so that the references
+ *  of a process that dies are dropped. These size the shared memory
+ *  segments when the first process attaches to them; processes that attach
+ *  later use the sizes of the existing segments.
+ */
+UInt32 ti_sdo_ce_osal_linux_SemMP_maxSems = 64;
+UInt32 ti_sdo_ce_osal_linux_LockMP_maxLocks = 64;
+UInt32 ti_sdo_ce_osal_linux_LockMP_maxProcs = 32;
+
+/*
+ *  ======== ti.sdo.ce.ipc.linux.Ipc Configuration ========
+ */
+
+/*
+ *  Number of messages (rounded up to a power of 2) and of queues shared by
+ *  all processes using the Linux Comm transport. Like the sizes above, they
+ *  are used by the process that creates the shared memory segment.
+ */
+UInt32 ti_sdo_ce_ipc_linux_Comm_numMsgs = 64;
+UInt32 ti_sdo_ce_ipc_linux_Comm_numQueues = 64;
+
 /*
  *  @(#) ti.sdo.ce.utils.rtcfg; 1, 0, 1,28; 12-2-2010 21:28:00; /db/atree/library/trees/ce/ce-r11x/src/ xlibrary
 
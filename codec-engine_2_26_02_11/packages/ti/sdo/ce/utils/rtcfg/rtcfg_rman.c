@@ -146,25 +146,44 @@ ti_sdo_fc_ires_grouputils_LockFxn ti_sdo_fc_ires_grouputils_lockGroup =
 ti_sdo_fc_ires_grouputils_LockFxn ti_sdo_fc_ires_grouputils_unlockGroup = 
         (ti_sdo_fc_ires_grouputils_LockFxn)(Algorithm_releaseLock);
 
-typedef struct SemMP_Obj *_GROUPUTILS_SemHandle;
- 
-extern _GROUPUTILS_SemHandle SemMP_create(Int key, Int count);
-extern Void SemMP_delete(_GROUPUTILS_SemHandle sem);
-extern Int SemMP_pend(_GROUPUTILS_SemHandle sem, UInt32 count);
-extern Void SemMP_post(_GROUPUTILS_SemHandle sem);
+/*
+ *  The GROUPUTILS resource lock is shared by all processes. It is a robust
+ *  LockMP, rather than a SemMP, so that a process killed while holding it
+ *  doesn't block the others: the next process to pend on it takes it over.
+ *  It is only ever used as a binary semaphore, pended and posted by the
+ *  same thread, so the count and timeout are ignored.
+ */
+typedef struct LockMP_Obj *_GROUPUTILS_SemHandle;
+
+extern _GROUPUTILS_SemHandle LockMP_create(Int key);
+extern Void LockMP_delete(_GROUPUTILS_SemHandle lock);
+extern Void LockMP_acquire(_GROUPUTILS_SemHandle lock);
+extern Void LockMP_release(_GROUPUTILS_SemHandle lock);
+
+static _GROUPUTILS_SemHandle semCreate(Int key, Int count)
+{
+    return (LockMP_create(key));
+}
+
+static Int semPend(_GROUPUTILS_SemHandle sem, UInt32 timeout)
+{
+    LockMP_acquire(sem);
+
+    return (0);
+}
 
 __FAR__ ti_sdo_fc_ires_grouputils_GROUPUTILS_SemCreateFxn 
         ti_sdo_fc_ires_grouputils_GROUPUTILS_semCreateFxn = 
-        (ti_sdo_fc_ires_grouputils_GROUPUTILS_SemCreateFxn)SemMP_create;
+        (ti_sdo_fc_ires_grouputils_GROUPUTILS_SemCreateFxn)semCreate;
 __FAR__ ti_sdo_fc_ires_grouputils_GROUPUTILS_SemDeleteFxn 
         ti_sdo_fc_ires_grouputils_GROUPUTILS_semDeleteFxn = 
-        (ti_sdo_fc_ires_grouputils_GROUPUTILS_SemDeleteFxn)SemMP_delete;
+        (ti_sdo_fc_ires_grouputils_GROUPUTILS_SemDeleteFxn)LockMP_delete;
 __FAR__ ti_sdo_fc_ires_grouputils_GROUPUTILS_SemPendFxn  
         ti_sdo_fc_ires_grouputils_GROUPUTILS_semPendFxn = 
-        (ti_sdo_fc_ires_grouputils_GROUPUTILS_SemPendFxn)SemMP_pend;
+        (ti_sdo_fc_ires_grouputils_GROUPUTILS_SemPendFxn)semPend;
 __FAR__ ti_sdo_fc_ires_grouputils_GROUPUTILS_SemPostFxn 
         ti_sdo_fc_ires_grouputils_GROUPUTILS_semPostFxn = 
-        (ti_sdo_fc_ires_grouputils_GROUPUTILS_SemPostFxn)SemMP_post;
+        (ti_sdo_fc_ires_grouputils_GROUPUTILS_SemPostFxn)LockMP_release;
 
 
 /* Extern declarations for IRES resources */
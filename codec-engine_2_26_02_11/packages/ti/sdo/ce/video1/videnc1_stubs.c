@@ -160,8 +160,8 @@ static XDAS_Int32 marshallMsg(IVIDENC1_Handle h, IVIDEO1_BufDescIn *inBufs,
                 inBufs->bufDesc[i].bufSize;
 
             msg->cmd.process.inBufs.bufDesc[i].buf = (XDAS_Int8 *)
-                Memory_getBufferPhysicalAddress(inBufs->bufDesc[i].buf,
-                    inBufs->bufDesc[i].bufSize, NULL);
+                VISA_getBufferPhysicalAddress(visa, inBufs->bufDesc[i].buf,
+                    inBufs->bufDesc[i].bufSize);
 
             if (msg->cmd.process.inBufs.bufDesc[i].buf == NULL) {
                 retVal = IVIDENC1_EFAIL;
@@ -197,8 +197,8 @@ static XDAS_Int32 marshallMsg(IVIDENC1_Handle h, IVIDEO1_BufDescIn *inBufs,
             msg->cmd.process.outBufSizes[i] = outBufs->bufSizes[i];
 
             msg->cmd.process.outBufs[i] = (XDAS_Int8 *)
-                Memory_getBufferPhysicalAddress(outBufs->bufs[i],
-                    outBufs->bufSizes[i], NULL);
+                VISA_getBufferPhysicalAddress(visa, outBufs->bufs[i],
+                    outBufs->bufSizes[i]);
 
             if (msg->cmd.process.outBufs[i] == NULL) {
                 /* TODO:M - should add at least a trace statement when trace
@@ -160,8 +160,8 @@ static XDAS_Int32 marshallMsg(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
             msg->cmd.process.inBufs.descs[i].bufSize = inBufs->descs[i].bufSize;
 
             msg->cmd.process.inBufs.descs[i].buf = (XDAS_Int8 *)
-                Memory_getBufferPhysicalAddress(inBufs->descs[i].buf,
-                    inBufs->descs[i].bufSize, NULL);
+                VISA_getBufferPhysicalAddress(visa, inBufs->descs[i].buf,
+                    inBufs->descs[i].bufSize);
 
             if (msg->cmd.process.inBufs.descs[i].buf == NULL) {
                 retVal = IVIDDEC2_EFAIL;
@@ -205,8 +205,8 @@ static XDAS_Int32 marshallMsg(IVIDDEC2_Handle h, XDM1_BufDesc *inBufs,
             msg->cmd.process.outBufSizes[i] = outBufs->bufSizes[i];
 
             msg->cmd.process.outBufs[i] = (XDAS_Int8 *)
-                Memory_getBufferPhysicalAddress(outBufs->bufs[i],
-                    outBufs->bufSizes[i], NULL);
+                VISA_getBufferPhysicalAddress(visa, outBufs->bufs[i],
+                    outBufs->bufSizes[i]);
 
             if (msg->cmd.process.outBufs[i] == NULL) {
                 /* TODO:M - should add at least a trace statement when trace
@@ -763,6 +763,15 @@ Void VISA_getContext(VISA_Handle visa, UInt32 * pContext)
     *pContext = visa->context;
 }
 
+/*
+ *  ======== VISA_getBufferPhysicalAddress ========
+ */
+UInt32 VISA_getBufferPhysicalAddress(VISA_Handle visa, Ptr buf, Int size)
+{
+    return (Engine_getBufferPhysicalAddress(Engine_getEngine(visa->node), buf,
+        size));
+}
+
 /*
  *  ======== VISA_getMaxMsgSize ========
  */
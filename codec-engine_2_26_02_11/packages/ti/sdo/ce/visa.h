@@ -548,6 +548,33 @@ extern Void VISA_getContext(VISA_Handle visa, UInt32 * pContext);
 extern Ptr VISA_getCodecClassConfig(VISA_Handle visa);
 
 
+/*
+ *  ======== VISA_getBufferPhysicalAddress ========
+ */
+/**
+ *  @brief      Converts the address of a buffer passed to a remote algorithm
+ *              to a physical address.
+ *
+ *  @ingroup    ti_sdo_ce_VISA_STUB
+ *
+ *  @param[in]  visa        Handle to a remote algorithm instance.
+ *  @param[in]  buf         Address of the buffer.
+ *  @param[in]  size        Size of the buffer, in bytes.
+ *
+ *  @retval     0           The buffer is not physically contiguous.
+ *  @retval     non-zero    The physical address of the buffer.
+ *
+ *  @remarks    This is typically called by an algorithm class' stub when
+ *              marshalling buffers.  Buffers registered with
+ *              Engine_registerBufs() are resolved without calling
+ *              Memory_getBufferPhysicalAddress().
+ *
+ *  @sa         Engine_registerBufs()
+ */
+extern UInt32 VISA_getBufferPhysicalAddress(VISA_Handle visa, Ptr buf,
+    Int size);
+
+
 /*
  *  ======== VISA_getMaxMsgSize ========
  */
@@ -34,8 +34,13 @@
  * @defgroup   ti_sdo_dmai_Blend        Blend
  *
  * @brief This module implements the blending of a bitmap buffer with a video
- *        buffer. Typical usage (2 bit in place blending of a 120x240 bitmap
- *        to a VGA sized 420Psemi buffer, no error checking):
+ *        buffer. On platforms without a blending peripheral the blending is
+ *        done in software, where ARGB8888, RGB565 and 2 bit bitmaps can be
+ *        blended on to 420Psemi, 422Psemi and UYVY video buffers. The
+ *        software implementation converts the bitmap to YCbCr once and only
+ *        converts it again when its contents change. Typical usage (2 bit
+ *        in place blending of a 120x240 bitmap to a VGA sized 420Psemi
+ *        buffer, no error checking):
  *
  * @code
  *   #include <xdc/std.h>
@@ -112,6 +117,14 @@ typedef struct Blend_Config_Params {
 
     /** @brief The VDCE palette to use for the bitmap */
     Int8    palette[4][4];
+
+    /**
+     * @brief RGB565 bitmaps carry no alpha of their own. Pixels of this
+     *        value are fully transparent while all other pixels are opaque.
+     *        Set to -1 to blend the whole bitmap opaquely. Only used by the
+     *        software implementation.
+     */
+    Int32   colorKey;
 } Blend_Config_Params;
 
 /**
@@ -124,7 +137,8 @@ typedef struct Blend_Config_Params {
  *          { 0x22, 0x36, 0x91, 0xc0, },
  *          { 0x6e, 0xf0, 0x29, 0x80, },
  *          { 0xde, 0xca, 0x6a, 0x40, },
- *     }
+ *     },
+ *     colorKey     = -1
  * @endcode
  */
 extern const Blend_Config_Params Blend_Config_Params_DEFAULT;
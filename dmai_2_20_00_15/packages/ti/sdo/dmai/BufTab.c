@@ -35,23 +35,142 @@
 
 #include <xdc/std.h>
 
+#include <ti/sdo/ce/osal/Sem.h>
+
 #include <ti/sdo/dmai/Buffer.h>
 #include <ti/sdo/dmai/BufTab.h>
 #include <ti/sdo/dmai/BufferGfx.h>
 
 #include "priv/_Buffer.h"
+#include "priv/_BufTab.h"
+#include "priv/_Sync.h"
+#include "priv/_Time.h"
 
 #define MODULE_NAME     "BufTab"
 
 #define PAGE_ALIGN      4096
 
+/* Number of buffers tracked per word of the free map */
+#define BITS_PER_WORD   32
+
 typedef struct BufTab_Object {
     Buffer_Handle *hBufs;       /* Array of buffers in the BufTab. */
     Int            numBufs;     /* The number of buffers in the BufTab. */
     Buffer_Handle *hOrigBufs;
     Int            origNumBufs;
+    volatile UInt32 *freeMap;   /* Bit set for each free buffer in hBufs. */
+    Int            numFreeWords;
+    Sem_Handle     hFreeSem;    /* Posted on release when numWaiters > 0. */
+    volatile Int32 numWaiters;  /* Threads in BufTab_getFreeBufWait. */
+    BufTab_Stats   stats;
 } BufTab_Object;
 
+/******************************************************************************
+ * buildFreeMap
+ ******************************************************************************/
+static Int buildFreeMap(BufTab_Handle hBufTab)
+{
+    Int numWords = (hBufTab->numBufs + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    Int bufIdx;
+
+    free((Ptr) hBufTab->freeMap);
+
+    hBufTab->freeMap = (volatile UInt32 *) calloc(numWords > 0 ? numWords : 1,
+                                                  sizeof(UInt32));
+
+    if (hBufTab->freeMap == NULL) {
+        Dmai_err0("Failed to allocate space for BufTab free map\n");
+        hBufTab->numFreeWords = 0;
+        return Dmai_ENOMEM;
+    }
+
+    hBufTab->numFreeWords = numWords;
+
+    for (bufIdx = 0; bufIdx < hBufTab->numBufs; bufIdx++) {
+        if (Buffer_getUseMask(hBufTab->hBufs[bufIdx]) == 0) {
+            hBufTab->freeMap[bufIdx / BITS_PER_WORD] |=
+                (UInt32) 1 << (bufIdx % BITS_PER_WORD);
+        }
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * findBuf
+ ******************************************************************************/
+static Int findBuf(BufTab_Handle hBufTab, Buffer_Handle hBuf)
+{
+    Int bufIdx = hBuf->id;
+
+    /* The id is the index, except for buffers kept in use across a chunk */
+    if (bufIdx >= 0 && bufIdx < hBufTab->numBufs &&
+        hBufTab->hBufs[bufIdx] == hBuf) {
+
+        return bufIdx;
+    }
+
+    for (bufIdx = 0; bufIdx < hBufTab->numBufs; bufIdx++) {
+        if (hBufTab->hBufs[bufIdx] == hBuf) {
+            return bufIdx;
+        }
+    }
+
+    return -1;
+}
+
+/******************************************************************************
+ * releaseWaiter
+ ******************************************************************************/
+static Bool releaseWaiter(BufTab_Handle hBufTab)
+{
+    Int32 numWaiters;
+
+    /* Decrement the waiter count unless it already dropped to 0 */
+    do {
+        numWaiters = hBufTab->numWaiters;
+
+        if (numWaiters <= 0) {
+            return FALSE;
+        }
+    } while (!_Sync_cas(&hBufTab->numWaiters, numWaiters, numWaiters - 1));
+
+    return TRUE;
+}
+
+/******************************************************************************
+ * _BufTab_setFree (INTERNAL)
+ ******************************************************************************/
+Void _BufTab_setFree(BufTab_Handle hBufTab, Buffer_Handle hBuf, Bool isFree)
+{
+    Int bufIdx;
+    UInt32 bit;
+
+    assert(hBufTab);
+    assert(hBuf);
+
+    /* Copies of a buffer (see Buffer_copy) point to the BufTab too */
+    bufIdx = findBuf(hBufTab, hBuf);
+
+    if (bufIdx < 0 || hBufTab->freeMap == NULL) {
+        return;
+    }
+
+    bit = (UInt32) 1 << (bufIdx % BITS_PER_WORD);
+
+    if (isFree) {
+        _Sync_fetchAndOr(&hBufTab->freeMap[bufIdx / BITS_PER_WORD], bit);
+
+        /* Wake up one thread blocked in BufTab_getFreeBufWait, if any */
+        if (hBufTab->numWaiters > 0 && releaseWaiter(hBufTab)) {
+            Sem_post(hBufTab->hFreeSem);
+        }
+    }
+    else {
+        _Sync_fetchAndAnd(&hBufTab->freeMap[bufIdx / BITS_PER_WORD], ~bit);
+    }
+}
+
 /******************************************************************************
  * cleanupBufs
  ******************************************************************************/
@@ -105,6 +224,11 @@ static Int cleanup(BufTab_Handle hBufTab)
         free(hBufTab->hBufs);
     }
 
+    if (hBufTab->hFreeSem) {
+        Sem_delete(hBufTab->hFreeSem);
+    }
+
+    free((Ptr) hBufTab->freeMap);
     free(hBufTab);
 
     return ret;
@@ -160,6 +284,11 @@ BufTab_Handle BufTab_create(Int numBufs, Int32 size, Buffer_Attrs *attrs)
         _Buffer_setBufTab(hBufTab->hBufs[bufIdx], hBufTab);
     }
 
+    if (buildFreeMap(hBufTab) < 0) {
+        cleanup(hBufTab);
+        return NULL;
+    }
+
     return hBufTab;
 }
   
@@ -215,7 +344,7 @@ Int BufTab_expand(BufTab_Handle hBufTab, Int numBufs)
 
     free(hOldBufs);
 
-    return Dmai_EOK;
+    return buildFreeMap(hBufTab);
 }
 
 /******************************************************************************
@@ -322,6 +451,10 @@ Int BufTab_chunk(BufTab_Handle hBufTab, Int numBufs, Int32 bufSize)
 
     hBufTab->numBufs = bufIdxNew;
 
+    if (buildFreeMap(hBufTab) < 0) {
+        return Dmai_ENOMEM;
+    }
+
     return numBufs - bufIdxNew;
 }
 
@@ -360,6 +493,8 @@ Int BufTab_collapse(BufTab_Handle hBufTab)
         hBufTab->numBufs = hBufTab->origNumBufs;
         hBufTab->hOrigBufs = NULL;
         hBufTab->origNumBufs = 0;
+
+        return buildFreeMap(hBufTab);
     }
 
     return Dmai_EOK;
@@ -402,24 +537,146 @@ Void BufTab_freeAll(BufTab_Handle hBufTab)
  ******************************************************************************/
 Buffer_Handle BufTab_getFreeBuf(BufTab_Handle hBufTab)
 {
-    Int bufIdx;
-    UInt16 useMask;
+    Buffer_Handle hBuf;
+    UInt32 freeBits, bit;
+    Int wordIdx, bitIdx;
 
     assert(hBufTab);
 
-    for (bufIdx = 0; bufIdx < hBufTab->numBufs; bufIdx++) {
-        useMask = Buffer_getUseMask(hBufTab->hBufs[bufIdx]);
-        if (!useMask) {
-            Buffer_resetUseMask(hBufTab->hBufs[bufIdx]);
-            break;
+    for (wordIdx = 0; wordIdx < hBufTab->numFreeWords; wordIdx++) {
+        freeBits = hBufTab->freeMap[wordIdx];
+
+        while (freeBits) {
+            bitIdx = _Sync_ffs(freeBits) - 1;
+            bit = (UInt32) 1 << bitIdx;
+
+            /* Claim the slot, retry if another thread changed the word */
+            if (!_Sync_cas(&hBufTab->freeMap[wordIdx], freeBits,
+                           freeBits & ~bit)) {
+                freeBits = hBufTab->freeMap[wordIdx];
+                continue;
+            }
+
+            hBuf = hBufTab->hBufs[wordIdx * BITS_PER_WORD + bitIdx];
+
+            /*
+             * Mark the buffer as used. If the use mask was set behind our
+             * back the buffer isn't free after all; its slot is published
+             * again when the use mask drops back to 0.
+             */
+            if (_Sync_cas(&hBuf->usedState.useMask, 0,
+                          hBuf->origState.useMask)) {
+
+                /* A buffer with an empty original use mask stays free */
+                if (hBuf->origState.useMask == 0) {
+                    _Sync_fetchAndOr(&hBufTab->freeMap[wordIdx], bit);
+                }
+
+                return hBuf;
+            }
+
+            freeBits = hBufTab->freeMap[wordIdx];
         }
     }
 
-    if (bufIdx == hBufTab->numBufs) {
-        return NULL;
+    return NULL;
+}
+
+/******************************************************************************
+ * BufTab_getFreeBufWait
+ ******************************************************************************/
+Buffer_Handle BufTab_getFreeBufWait(BufTab_Handle hBufTab, UInt32 timeout)
+{
+    Buffer_Handle hBuf;
+    Sem_Handle hSem;
+    UInt32 start = 0;
+    UInt32 elapsed;
+    UInt32 remaining = timeout;
+
+    assert(hBufTab);
+
+    hBuf = BufTab_getFreeBuf(hBufTab);
+
+    if (hBuf || timeout == BufTab_POLL) {
+        return hBuf;
+    }
+
+    /* Waking up for a buffer somebody else took mustn't restart the wait */
+    if (timeout != BufTab_FOREVER) {
+        start = _Time_getSemTicks();
+    }
+
+    /* The semaphore is only needed once somebody has to wait */
+    if (hBufTab->hFreeSem == NULL) {
+        hSem = Sem_create(0, 0);
+
+        if (hSem == NULL) {
+            Dmai_err0("Failed to create BufTab semaphore\n");
+            return NULL;
+        }
+
+        if (!_Sync_cas(&hBufTab->hFreeSem, NULL, hSem)) {
+            Sem_delete(hSem);
+        }
     }
 
-    return BufTab_getBuf(hBufTab, bufIdx);
+    _Sync_addAndFetch(&hBufTab->stats.numStalls, 1);
+
+    for (;;) {
+        /*
+         * Register as a waiter before looking again, so that a buffer
+         * released in between is either seen here or posts the semaphore.
+         */
+        _Sync_addAndFetch(&hBufTab->numWaiters, 1);
+
+        hBuf = BufTab_getFreeBuf(hBufTab);
+
+        if (hBuf) {
+            /* If a releaser already took our count it left a stray post */
+            releaseWaiter(hBufTab);
+            break;
+        }
+
+        if (Sem_pend(hBufTab->hFreeSem, remaining) != Sem_EOK) {
+            releaseWaiter(hBufTab);
+            hBuf = BufTab_getFreeBuf(hBufTab);
+            break;
+        }
+
+        /* Another thread may have grabbed the buffer first, wait again */
+        hBuf = BufTab_getFreeBuf(hBufTab);
+
+        if (hBuf) {
+            break;
+        }
+
+        /* Only for what is left of the original timeout */
+        if (timeout != BufTab_FOREVER) {
+            elapsed = _Time_getSemTicks() - start;
+
+            if (elapsed >= timeout) {
+                break;
+            }
+
+            remaining = timeout - elapsed;
+        }
+    }
+
+    _Sync_addAndFetch(hBuf ? &hBufTab->stats.numWakeups :
+                             &hBufTab->stats.numTimeouts, 1);
+
+    return hBuf;
+}
+
+/******************************************************************************
+ * BufTab_getStats
+ ******************************************************************************/
+Void BufTab_getStats(BufTab_Handle hBufTab, BufTab_Stats *stats)
+{
+    assert(hBufTab);
+    assert(stats);
+
+    *stats = hBufTab->stats;
 }
 
 /******************************************************************************
@@ -449,7 +706,8 @@ Void BufTab_freeBuf(Buffer_Handle hBuf)
 {
     assert(hBuf);
 
-    Buffer_setUseMask(hBuf, 0);
+    /* Live views keep the Buffer busy until the last one is released */
+    Buffer_freeUseMask(hBuf, (UInt16) ~Buffer_USEMASK_VIEW);
 }
 
 /******************************************************************************
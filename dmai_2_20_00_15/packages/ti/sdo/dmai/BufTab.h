@@ -75,6 +75,33 @@ typedef struct BufTab_Object *BufTab_Handle;
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Buffer.h>
 
+/**
+ * @brief       Timeout value for #BufTab_getFreeBufWait to block until a
+ *              buffer is released.
+ */
+#define BufTab_FOREVER  ((UInt32) -1)
+
+/**
+ * @brief       Timeout value for #BufTab_getFreeBufWait to return
+ *              immediately, like #BufTab_getFreeBuf.
+ */
+#define BufTab_POLL     ((UInt32) 0)
+
+/**
+ * @brief       Statistics on blocking acquires from a BufTab.
+ * @see         BufTab_getStats
+ */
+typedef struct BufTab_Stats {
+    /** @brief Calls to #BufTab_getFreeBufWait that found no free buffer. */
+    Int32 numStalls;
+
+    /** @brief Stalled calls that got a buffer released by another thread. */
+    Int32 numWakeups;
+
+    /** @brief Stalled calls that returned NULL after the timeout. */
+    Int32 numTimeouts;
+} BufTab_Stats;
+
 #if defined (__cplusplus)
 extern "C" {
 #endif
@@ -214,6 +241,13 @@ extern Void BufTab_freeAll(BufTab_Handle hBufTab);
  * @param[in]   hBuf        The #Buffer_Handle of the Buffer to free.
  *
  * @remarks     #BufTab_create must be called before this function.
+ *
+ * @remarks     This function may be called concurrently with
+ *              #BufTab_getFreeBuf and the Buffer use mask functions from
+ *              other threads.
+ *
+ * @remarks     If the Buffer has live views (see #Buffer_createView) it is
+ *              not freed until the last view is released.
  */
 extern Void BufTab_freeBuf(Buffer_Handle hBuf);
 
@@ -226,9 +260,52 @@ extern Void BufTab_freeBuf(Buffer_Handle hBuf);
  * @retval      NULL for failure.
  *
  * @remarks     #BufTab_create must be called before this function.
+ *
+ * @remarks     Free buffers are tracked in a bitmap updated whenever a use
+ *              mask drops to or rises from 0, so the lookup does not scan
+ *              the buffers. The lowest indexed free buffer is returned.
+ *
+ * @remarks     This function may be called concurrently with
+ *              #BufTab_freeBuf and the Buffer use mask functions from other
+ *              threads without external locking. #BufTab_chunk,
+ *              #BufTab_collapse and #BufTab_expand must not run
+ *              concurrently with any other call on the same BufTab.
  */
 extern Buffer_Handle BufTab_getFreeBuf(BufTab_Handle hBufTab);
 
+/**
+ * @brief       Return a free buffer from the BufTab and mark it as used,
+ *              sleeping until another thread releases one (using
+ *              #BufTab_freeBuf, #Buffer_freeUseMask or #Buffer_setUseMask)
+ *              if none is free.
+ *
+ * @param[in]   hBufTab     The #BufTab_Handle from which to get a buffer.
+ * @param[in]   timeout     Maximum time to wait, #BufTab_POLL or
+ *                          #BufTab_FOREVER. The unit is the one of the
+ *                          Codec Engine OSAL Sem_pend (microseconds on
+ *                          Linux).
+ *
+ * @retval      Handle to a free buffer (see #BufTab_Handle).
+ * @retval      NULL if no buffer was released within timeout, or failure.
+ *
+ * @remarks     #BufTab_create must be called before this function.
+ *
+ * @remarks     Calls that have to wait are counted in the BufTab statistics,
+ *              see #BufTab_getStats.
+ */
+extern Buffer_Handle BufTab_getFreeBufWait(BufTab_Handle hBufTab,
+                                           UInt32 timeout);
+
+/**
+ * @brief       Get the statistics of blocking acquires from a BufTab.
+ *
+ * @param[in]   hBufTab     The #BufTab_Handle to get the statistics of.
+ * @param[out]  stats       The #BufTab_Stats structure to fill in.
+ *
+ * @remarks     #BufTab_create must be called before this function.
+ */
+extern Void BufTab_getStats(BufTab_Handle hBufTab, BufTab_Stats *stats);
+
 #if defined (__cplusplus)
 }
 #endif
@@ -38,8 +38,11 @@
 #include <ti/sdo/dmai/BufTab.h>
 
 #include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/ce/osal/Sem.h>
 
 #include "priv/_Buffer.h"
+#include "priv/_BufTab.h"
+#include "priv/_Sync.h"
 
 #define MODULE_NAME     "Buffer"
 
@@ -53,6 +56,134 @@ const Buffer_Attrs Buffer_Attrs_DEFAULT = {
     FALSE
 };
 
+/* Cache maintenance counters, shared by all Buffers */
+static volatile Int32 numWb         = 0;
+static volatile Int32 numWbElided   = 0;
+static volatile Int32 numInv        = 0;
+static volatile Int32 numInvElided  = 0;
+
+/* Serializes the first and last view of any Buffer */
+static Sem_Handle     viewSem       = NULL;
+
+/******************************************************************************
+ * updateUseMask
+ ******************************************************************************/
+static Void updateUseMask(Buffer_Handle hBuf, UInt16 setMask, UInt16 keepMask)
+{
+    UInt32 oldMask, newMask;
+    Bool isFree;
+
+    /* Atomically replace the use mask with (useMask & keepMask) | setMask */
+    do {
+        oldMask = hBuf->usedState.useMask;
+        newMask = (oldMask & keepMask) | setMask;
+    } while (!_Sync_cas(&hBuf->usedState.useMask, oldMask, newMask));
+
+    /*
+     * Keep the free index of the owning BufTab in sync on transitions.
+     * Another thread may make the opposite transition before the index is
+     * updated, so publish the use mask as it is now, and do it again if it
+     * has crossed 0 in the meantime.
+     */
+    if (hBuf->hBufTab && !oldMask != !newMask) {
+        do {
+            isFree = hBuf->usedState.useMask == 0;
+            _BufTab_setFree(hBuf->hBufTab, hBuf, isFree);
+        } while ((hBuf->usedState.useMask == 0) != isFree);
+    }
+}
+
+/******************************************************************************
+ * getViewSem
+ ******************************************************************************/
+static Sem_Handle getViewSem(Void)
+{
+    Sem_Handle hSem;
+
+    /* Only created once somebody makes a view */
+    if (viewSem == NULL) {
+        hSem = Sem_create(0, 1);
+
+        if (hSem == NULL) {
+            Dmai_err0("Failed to create Buffer view semaphore\n");
+            return NULL;
+        }
+
+        if (!_Sync_cas(&viewSem, NULL, hSem)) {
+            Sem_delete(hSem);
+        }
+    }
+
+    return viewSem;
+}
+
+/******************************************************************************
+ * acquireView
+ ******************************************************************************/
+static Int acquireView(Buffer_Handle hBuf)
+{
+    Int32 oldCount;
+    Sem_Handle hSem;
+
+    /* Buffers which already have views only need their count raised */
+    for (oldCount = hBuf->refCount; oldCount > 0; oldCount = hBuf->refCount) {
+        if (_Sync_cas(&hBuf->refCount, oldCount, oldCount + 1)) {
+            return Dmai_EOK;
+        }
+    }
+
+    hSem = getViewSem();
+
+    if (hSem == NULL) {
+        return Dmai_ENOMEM;
+    }
+
+    /* The first view keeps the Buffer busy in its BufTab */
+    Sem_pend(hSem, Sem_FOREVER);
+
+    if (hBuf->refCount == 0) {
+        updateUseMask(hBuf, Buffer_USEMASK_VIEW, 0xFFFF);
+    }
+
+    _Sync_addAndFetch(&hBuf->refCount, 1);
+
+    Sem_post(hSem);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * releaseView
+ ******************************************************************************/
+static Int releaseView(Buffer_Handle hBuf)
+{
+    Int32 oldCount;
+
+    for (oldCount = hBuf->refCount; oldCount > 1; oldCount = hBuf->refCount) {
+        if (_Sync_cas(&hBuf->refCount, oldCount, oldCount - 1)) {
+            return Dmai_EOK;
+        }
+    }
+
+    if (oldCount <= 0) {
+        return Dmai_EINVAL;
+    }
+
+    /*
+     * Possibly the last view. Serialize with acquireView so that a view
+     * created meanwhile does not have its bit cleared under it.
+     */
+    Sem_pend(viewSem, Sem_FOREVER);
+
+    if (_Sync_addAndFetch(&hBuf->refCount, -1) == 0) {
+        updateUseMask(hBuf, 0, (UInt16) ~Buffer_USEMASK_VIEW);
+    }
+
+    Sem_post(viewSem);
+
+    return Dmai_EOK;
+}
+
 /******************************************************************************
  * _Buffer_init
  ******************************************************************************/
@@ -206,7 +337,8 @@ Void Buffer_freeUseMask(Buffer_Handle hBuf, UInt16 useMask)
 {
     assert(hBuf);
 
-    hBuf->usedState.useMask &= ~useMask;
+    /* The view bit is only cleared when the last view is released */
+    updateUseMask(hBuf, 0, (UInt16) ~useMask | Buffer_USEMASK_VIEW);
 }
 
 /******************************************************************************
@@ -216,7 +348,7 @@ Void Buffer_setUseMask(Buffer_Handle hBuf, UInt16 useMask)
 {
     assert(hBuf);
 
-    hBuf->usedState.useMask = useMask;
+    updateUseMask(hBuf, useMask, Buffer_USEMASK_VIEW);
 }
 
 /******************************************************************************
@@ -226,7 +358,7 @@ Void Buffer_resetUseMask(Buffer_Handle hBuf)
 {
     assert(hBuf);
 
-    hBuf->usedState.useMask = hBuf->origState.useMask;
+    updateUseMask(hBuf, hBuf->origState.useMask, Buffer_USEMASK_VIEW);
 }
 
 /******************************************************************************
@@ -236,7 +368,7 @@ UInt16 Buffer_getUseMask(Buffer_Handle hBuf)
 {
     assert(hBuf);
 
-    return hBuf->usedState.useMask;
+    return (UInt16) hBuf->usedState.useMask;
 }
 
 /******************************************************************************
@@ -352,6 +484,7 @@ Int Buffer_setUserPtr(Buffer_Handle hBuf, Int8 *ptr)
     }
 
     hBuf->userPtr = ptr;
+    hBuf->coherency = Buffer_Coherency_CLEAN;
 
     if (ptr) {
         hBuf->physPtr = Memory_getBufferPhysicalAddress(hBuf->userPtr, 4, NULL);
@@ -366,6 +499,20 @@ Int Buffer_setUserPtr(Buffer_Handle hBuf, Int8 *ptr)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * _Buffer_setVirtualPtr (INTERNAL)
+ ******************************************************************************/
+Void _Buffer_setVirtualPtr(Buffer_Handle hBuf, Int8 *ptr)
+{
+    assert(hBuf);
+    assert(hBuf->reference);
+
+    /* Not CMEM memory, so there is no physical address to look up */
+    hBuf->userPtr = ptr;
+    hBuf->physPtr = 0;
+    hBuf->coherency = Buffer_Coherency_CLEAN;
+}
+
 /******************************************************************************
  * Buffer_setSize
  ******************************************************************************/
@@ -422,6 +569,16 @@ Int Buffer_delete(Buffer_Handle hBuf)
     Int ret = Dmai_EOK;
 
     if (hBuf) {
+        /* Views still point into the memory of this Buffer */
+        if (hBuf->hParent == NULL && hBuf->refCount > 0) {
+            Dmai_err1("Buffer %d still has views, not deleted\n", hBuf->id);
+            return Dmai_EINVAL;
+        }
+
+        if (hBuf->hParent) {
+            ret = releaseView(hBuf->hParent);
+        }
+
         if (!hBuf->reference && hBuf->userPtr) {
             Dmai_dbg3("Free Buffer of size %u at 0x%x (0x%x phys)\n",
                       (Uns) hBuf->origState.numBytes,
@@ -475,6 +632,250 @@ Int Buffer_copy(Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 
     hDstBuf->reference = TRUE;
 
+    /* The copy is an untracked alias, it does not hold a view reference */
+    hDstBuf->refCount = 0;
+    hDstBuf->hParent = NULL;
+
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * Buffer_createView
+ ******************************************************************************/
+Buffer_Handle Buffer_createView(Buffer_Handle hBuf, Int32 offset, Int32 size)
+{
+    Buffer_Handle hView;
+    UInt32        objSize;
+    Int32         numBytes;
+
+    assert(hBuf);
+
+    if (hBuf->hParent) {
+        offset += hBuf->userPtr - hBuf->hParent->userPtr;
+        hBuf = hBuf->hParent;
+    }
+
+    if (offset < 0 || size < 0 || offset + size > hBuf->origState.numBytes) {
+        Dmai_err3("View %d bytes at offset %d outside Buffer of size %d\n",
+                  (Int) size, (Int) offset, (Int) hBuf->origState.numBytes);
+        return NULL;
+    }
+
+    objSize = hBuf->type == Buffer_Type_GRAPHICS ? sizeof(_BufferGfx_Object) :
+                                                   sizeof(_Buffer_Object);
+
+    hView = (Buffer_Handle) malloc(objSize);
+
+    if (hView == NULL) {
+        Dmai_err0("Failed to allocate space for Buffer view\n");
+        return NULL;
+    }
+
+    memcpy(hView, hBuf, objSize);
+
+    hView->userPtr              = hBuf->userPtr + offset;
+    hView->physPtr              = hBuf->physPtr ? hBuf->physPtr + offset : 0;
+    hView->origState.numBytes   = size;
+    hView->origState.useMask    = 0;
+    hView->usedState.useMask    = 0;
+    hView->reference            = TRUE;
+    hView->hBufTab              = NULL;
+    hView->virtualBufferSize    = 0;
+    hView->refCount             = 1;
+    hView->hParent              = hBuf;
+    hView->coherency            = Buffer_Coherency_CLEAN;
+
+    numBytes = hBuf->usedState.numBytes - offset;
+    hView->usedState.numBytes   = numBytes < 0 ? 0 :
+                                  numBytes > size ? size : numBytes;
+
+    if (acquireView(hBuf) < 0) {
+        free(hView);
+        return NULL;
+    }
+
+    Dmai_dbg3("Created view of %d bytes at offset %d of Buffer %d\n",
+              (Int) size, (Int) offset, hBuf->id);
+
+    return hView;
+}
+
+/******************************************************************************
+ * Buffer_ref
+ ******************************************************************************/
+Int Buffer_ref(Buffer_Handle hBuf)
+{
+    assert(hBuf);
+
+    if (hBuf->hParent) {
+        /* The caller already holds a reference, so the view is alive */
+        _Sync_addAndFetch(&hBuf->refCount, 1);
+
+        return Dmai_EOK;
+    }
+
+    return acquireView(hBuf);
+}
+
+/******************************************************************************
+ * Buffer_unref
+ ******************************************************************************/
+Int Buffer_unref(Buffer_Handle hBuf)
+{
+    Buffer_Handle hParent;
+
+    assert(hBuf);
+
+    hParent = hBuf->hParent;
+
+    if (hParent == NULL) {
+        return releaseView(hBuf);
+    }
+
+    if (_Sync_addAndFetch(&hBuf->refCount, -1) > 0) {
+        return Dmai_EOK;
+    }
+
+    free(hBuf);
+
+    return releaseView(hParent);
+}
+
+/******************************************************************************
+ * Buffer_getParent
+ ******************************************************************************/
+Buffer_Handle Buffer_getParent(Buffer_Handle hBuf)
+{
+    assert(hBuf);
+
+    return hBuf->hParent;
+}
+
+/******************************************************************************
+ * Buffer_setCpuDirty
+ ******************************************************************************/
+Void Buffer_setCpuDirty(Buffer_Handle hBuf, Int32 offset, Int32 numBytes)
+{
+    Int32 end;
+
+    assert(hBuf);
+
+    if (offset < 0) {
+        numBytes += offset;
+        offset = 0;
+    }
+
+    end = offset + numBytes;
+
+    if (end > hBuf->origState.numBytes) {
+        end = hBuf->origState.numBytes;
+    }
+
+    if (end <= offset) {
+        return;
+    }
+
+    /* Coalesce with the range still waiting to be written back */
+    if (hBuf->coherency == Buffer_Coherency_CPU_DIRTY) {
+        if (offset < hBuf->dirtyStart) {
+            hBuf->dirtyStart = offset;
+        }
+
+        if (end > hBuf->dirtyEnd) {
+            hBuf->dirtyEnd = end;
+        }
+    }
+    else {
+        hBuf->coherency = Buffer_Coherency_CPU_DIRTY;
+        hBuf->dirtyStart = offset;
+        hBuf->dirtyEnd = end;
+    }
+}
+
+/******************************************************************************
+ * Buffer_setDeviceDirty
+ ******************************************************************************/
+Void Buffer_setDeviceDirty(Buffer_Handle hBuf)
+{
+    assert(hBuf);
+
+    hBuf->coherency = Buffer_Coherency_DEVICE_DIRTY;
+}
+
+/******************************************************************************
+ * Buffer_getCoherency
+ ******************************************************************************/
+Buffer_Coherency Buffer_getCoherency(Buffer_Handle hBuf)
+{
+    assert(hBuf);
+
+    return hBuf->coherency;
+}
+
+/******************************************************************************
+ * Buffer_cacheWb
+ ******************************************************************************/
+Int Buffer_cacheWb(Buffer_Handle hBuf)
+{
+    assert(hBuf);
+
+    if (hBuf->coherency != Buffer_Coherency_CPU_DIRTY ||
+        (hBuf->memParams.flags & Memory_CACHEDMASK) != Memory_CACHED) {
+
+        if (hBuf->coherency == Buffer_Coherency_CPU_DIRTY) {
+            hBuf->coherency = Buffer_Coherency_CLEAN;
+        }
+
+        _Sync_addAndFetch(&numWbElided, 1);
+        return Dmai_EOK;
+    }
+
+    Memory_cacheWb(hBuf->userPtr + hBuf->dirtyStart,
+                   hBuf->dirtyEnd - hBuf->dirtyStart);
+
+    hBuf->coherency = Buffer_Coherency_CLEAN;
+
+    _Sync_addAndFetch(&numWb, 1);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Buffer_cacheInv
+ ******************************************************************************/
+Int Buffer_cacheInv(Buffer_Handle hBuf)
+{
+    assert(hBuf);
+
+    if (hBuf->coherency != Buffer_Coherency_DEVICE_DIRTY ||
+        (hBuf->memParams.flags & Memory_CACHEDMASK) != Memory_CACHED) {
+
+        if (hBuf->coherency == Buffer_Coherency_DEVICE_DIRTY) {
+            hBuf->coherency = Buffer_Coherency_CLEAN;
+        }
+
+        _Sync_addAndFetch(&numInvElided, 1);
+        return Dmai_EOK;
+    }
+
+    Memory_cacheInv(hBuf->userPtr, hBuf->origState.numBytes);
+
+    hBuf->coherency = Buffer_Coherency_CLEAN;
+
+    _Sync_addAndFetch(&numInv, 1);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Buffer_getCacheStats
+ ******************************************************************************/
+Void Buffer_getCacheStats(Buffer_CacheStats *stats)
+{
+    assert(stats);
+
+    stats->numWb        = numWb;
+    stats->numWbElided  = numWbElided;
+    stats->numInv       = numInv;
+    stats->numInvElided = numInvElided;
+}
@@ -115,6 +115,49 @@ typedef struct Buffer_Attrs {
     Bool                    reference;
 } Buffer_Attrs;
 
+/**
+ * @brief Use mask bit reserved by DMAI to mark a Buffer which has live views
+ * (see #Buffer_createView). Applications must not use this bit in their own
+ * use masks.
+ */
+#define Buffer_USEMASK_VIEW     0x8000
+
+/**
+ * @brief Cache coherency state of a Buffer (see #Buffer_cacheWb and
+ * #Buffer_cacheInv).
+ */
+typedef enum {
+    /** @brief The cache and the memory agree */
+    Buffer_Coherency_CLEAN          = 0,
+
+    /** @brief The CPU wrote through the cache, a write back is needed
+     *  before a device reads the buffer */
+    Buffer_Coherency_CPU_DIRTY      = 1,
+
+    /** @brief A device wrote the memory, an invalidate is needed before
+     *  the CPU reads the buffer */
+    Buffer_Coherency_DEVICE_DIRTY   = 2,
+
+    Buffer_Coherency_COUNT
+} Buffer_Coherency;
+
+/**
+ * @brief Cache maintenance counters (see #Buffer_getCacheStats).
+ */
+typedef struct Buffer_CacheStats {
+    /** @brief Number of cache write backs performed */
+    UInt32                  numWb;
+
+    /** @brief Number of cache write backs found unnecessary */
+    UInt32                  numWbElided;
+
+    /** @brief Number of cache invalidates performed */
+    UInt32                  numInv;
+
+    /** @brief Number of cache invalidates found unnecessary */
+    UInt32                  numInvElided;
+} Buffer_CacheStats;
+
 /**
  * @brief Handle through which to reference a Buffer instance.
  */
@@ -195,6 +238,7 @@ extern Void Buffer_print(Buffer_Handle hBuf);
  * @param[in]   hBuf        The #Buffer_Handle of the Buffer to delete.
  *
  * @retval      Dmai_EOK for success.
+ * @retval      Dmai_EINVAL if views of the Buffer are still alive.
  * @retval      "Negative value" for failure, see Dmai.h.
  *
  * @remarks     #Buffer_create or #BufTab_create must be called
@@ -221,6 +265,9 @@ extern Void Buffer_getAttrs(Buffer_Handle hBuf, Buffer_Attrs *attrs);
  *
  * @remarks     #Buffer_create or #BufTab_create must be called
  *              before this function.
+ *
+ * @remarks     The use mask is updated atomically, and the owning BufTab
+ *              (if any) is told when the Buffer becomes free or busy.
  */
 extern Void Buffer_setUseMask(Buffer_Handle hBuf, UInt16 useMask);
 
@@ -234,6 +281,9 @@ extern Void Buffer_setUseMask(Buffer_Handle hBuf, UInt16 useMask);
  *
  * @remarks     #Buffer_create or #BufTab_create must be called
  *              before this function.
+ *
+ * @remarks     The use mask is updated atomically, and the owning BufTab
+ *              (if any) is told when the Buffer becomes free or busy.
  */
 extern Void Buffer_freeUseMask(Buffer_Handle hBuf, UInt16 useMask);
 
@@ -245,6 +295,9 @@ extern Void Buffer_freeUseMask(Buffer_Handle hBuf, UInt16 useMask);
  *
  * @remarks     #Buffer_create or #BufTab_create must be called
  *              before this function.
+ *
+ * @remarks     The use mask is updated atomically, and the owning BufTab
+ *              (if any) is told when the Buffer becomes free or busy.
  */
 extern Void Buffer_resetUseMask(Buffer_Handle hBuf);
 
@@ -446,6 +499,136 @@ extern BufTab_Handle Buffer_getBufTab(Buffer_Handle hBuf);
  */
 extern Int Buffer_copy(Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf);
 
+/**
+ * @brief       Creates a reference counted view of a window of an existing
+ *              Buffer. No data is copied, the view points into the memory
+ *              of the parent Buffer.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle of the parent Buffer. If this
+ *                          is itself a view, the new view is created on
+ *                          its parent.
+ * @param[in]   offset      Offset in bytes of the view into the parent.
+ * @param[in]   size        Size in bytes of the view.
+ *
+ * @retval      Handle for use in subsequent operations (see #Buffer_Handle).
+ * @retval      NULL for failure.
+ *
+ * @remarks     The view is returned holding one reference, which is dropped
+ *              using #Buffer_unref.
+ * @remarks     While the parent Buffer has live views, the
+ *              #Buffer_USEMASK_VIEW bit is set in its use mask. The bit is
+ *              cleared when the last view is released, which returns the
+ *              parent to its BufTab once all other owners have freed it.
+ * @remarks     A view of a graphics Buffer inherits the dimensions and
+ *              color space of its parent.
+ */
+extern Buffer_Handle Buffer_createView(Buffer_Handle hBuf, Int32 offset,
+                                       Int32 size);
+
+/**
+ * @brief       Takes an additional reference on a Buffer.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle to reference.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     On a view, the view stays valid until every reference has
+ *              been dropped using #Buffer_unref. On any other Buffer, the
+ *              reference counts as an anonymous view of the whole Buffer.
+ * @remarks     References may be taken and dropped from different threads.
+ */
+extern Int Buffer_ref(Buffer_Handle hBuf);
+
+/**
+ * @brief       Drops a reference on a Buffer. When the last reference on a
+ *              view is dropped the view is deleted, and when the last view
+ *              of a parent Buffer is released the parent is freed back to
+ *              its BufTab.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle to drop a reference on.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      Dmai_EINVAL if the Buffer holds no references.
+ */
+extern Int Buffer_unref(Buffer_Handle hBuf);
+
+/**
+ * @brief       Get the parent Buffer of a view.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle of the view.
+ *
+ * @retval      Buffer_Handle of the parent Buffer.
+ * @retval      NULL if the Buffer is not a view.
+ */
+extern Buffer_Handle Buffer_getParent(Buffer_Handle hBuf);
+
+/**
+ * @brief       Records that the CPU wrote a range of a Buffer. Ranges
+ *              recorded before the next #Buffer_cacheWb are coalesced, so
+ *              they are written back with a single cache operation.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle the CPU wrote to.
+ * @param[in]   offset      Offset of the first byte written.
+ * @param[in]   numBytes    Number of bytes written.
+ *
+ * @remarks     DMAI modules writing a Buffer with the CPU call this function.
+ *              Applications writing through #Buffer_getUserPtr need to call
+ *              it themselves for the write back to happen.
+ */
+extern Void Buffer_setCpuDirty(Buffer_Handle hBuf, Int32 offset,
+                               Int32 numBytes);
+
+/**
+ * @brief       Records that a device (e.g. a remote codec) wrote a Buffer.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle the device wrote to.
+ *
+ * @remarks     Any write back which is still pending is dropped, so
+ *              #Buffer_cacheWb must be called before handing the Buffer
+ *              to the device.
+ */
+extern Void Buffer_setDeviceDirty(Buffer_Handle hBuf);
+
+/**
+ * @brief       Get the cache coherency state of a Buffer.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle to get the state of.
+ *
+ * @retval      Cache coherency state (see #Buffer_Coherency).
+ */
+extern Buffer_Coherency Buffer_getCoherency(Buffer_Handle hBuf);
+
+/**
+ * @brief       Writes back the cache for a Buffer before a device reads it.
+ *              Only the range recorded by #Buffer_setCpuDirty is written
+ *              back, and nothing is done unless the Buffer is CPU dirty and
+ *              allocated with Memory_CACHED.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle to write back.
+ *
+ * @retval      Dmai_EOK for success.
+ */
+extern Int Buffer_cacheWb(Buffer_Handle hBuf);
+
+/**
+ * @brief       Invalidates the cache for a Buffer before the CPU reads it.
+ *              Nothing is done unless the Buffer is device dirty and
+ *              allocated with Memory_CACHED.
+ *
+ * @param[in]   hBuf        The #Buffer_Handle to invalidate.
+ *
+ * @retval      Dmai_EOK for success.
+ */
+extern Int Buffer_cacheInv(Buffer_Handle hBuf);
+
+/**
+ * @brief       Get the cache maintenance counters of all Buffers.
+ *
+ * @param[out]  stats       Filled in with the performed and elided counts.
+ */
+extern Void Buffer_getCacheStats(Buffer_CacheStats *stats);
+
 
 #if defined (__cplusplus)
 }
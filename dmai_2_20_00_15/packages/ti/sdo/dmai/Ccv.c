@@ -40,6 +40,14 @@
 
 #include "priv/_Ccv.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CCV_SIMD        "NEON"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CCV_SIMD        "SSE2"
+#endif
+
 #define MODULE_NAME     "Ccv"
 
 /* Accelerated function prototypes */
@@ -54,25 +62,47 @@ const Ccv_Attrs Ccv_Attrs_DEFAULT = {
     FALSE,
 };
 
-static Void ycbcr422p_rgb565
+/*
+ * The software conversions are split in a per-frame part (the ccv_* functions
+ * walking the lines of the buffers) and kernels converting a run of pixels.
+ * The kernels come in a scalar and a SIMD flavor selected at create time.
+ */
+struct _Ccv_Kernels {
+    /* YCbCr (planar, semi planar or UYVY) to RGB565, RGB888 or ARGB8888 */
+    Void (*ycbcrRgb)(const Int16 coeff[5], const UInt8 *yData,
+                     const UInt8 *cbData, const UInt8 *crData,
+                     ColorSpace_Type srcColorSpace, Ptr dstData,
+                     ColorSpace_Type dstColorSpace, UInt32 numPixels);
+
+    /* One line of Y and interleaved CbCr to UYVY */
+    Void (*semiUyvy)(const UInt8 *yData, const UInt8 *cbcrData,
+                     UInt8 *uyvyData, UInt32 numPixels);
+
+    /* One line of UYVY to Y and, unless cbcrData is NULL, CbCr */
+    Void (*uyvySemi)(const UInt8 *uyvyData, UInt8 *yData, UInt8 *cbcrData,
+                     UInt32 numPixels);
+};
+
+/* ITU-R BT.601 matrix coefficients in signed Q13 */
+static const Int16 ccvCoeff[5] = { 0x2543, 0x3313, -0x0C8A, -0x1A04, 0x408D };
+
+static Void ycbcr_rgb
 (
     const Int16             coeff[5],   /* Matrix coefficients.             */
     const UInt8             *yData,     /* Luminence data        (Y')       */
     const UInt8             *cbData,    /* Blue color-difference (B'-Y')    */
     const UInt8             *crData,    /* Red color-difference  (R'-Y')    */
-    UInt16                  *rgbData,   /* RGB 5:6:5 packed pixel output.   */
+    ColorSpace_Type         srcColorSpace, /* Layout of the YCbCr data.     */
+    Ptr                     dstData,    /* Packed RGB pixel output.         */
+    ColorSpace_Type         dstColorSpace, /* Format of the RGB output.     */
     UInt32                  numPixels   /* # of luma pixels to process.     */
 );
 
-static Void ycbcr420p_rgb565(
-    const Int16             coeff[5],   /* Matrix coefficients.             */
-    const UInt8             *yData,     /* Luminence data        (Y')       */
-    const UInt8             *cbData,    /* Blue color-difference (B'-Y')    */
-    const UInt8             *crData,    /* Red color-difference  (R'-Y')    */
-    UInt16                  *rgbData,   /* RGB 5:6:5 packed pixel output.   */
-    UInt32                  width,      /* Width of the buffer.             */
-    UInt32                  height      /* Height of the buffer.            */
-);
+static Void semi_uyvy(const UInt8 *yData, const UInt8 *cbcrData,
+                      UInt8 *uyvyData, UInt32 numPixels);
+
+static Void uyvy_semi(const UInt8 *uyvyData, UInt8 *yData, UInt8 *cbcrData,
+                      UInt32 numPixels);
 
 /******************************************************************************
  * cleanup
@@ -95,49 +125,50 @@ static Int cleanup(Ccv_Handle hCcv)
  ******************************************************************************/
 static Void ccv_Yuv420semi_Yuv422semi(Ccv_Handle hCcv,
                                       Buffer_Handle hSrcBuf,
-                                      Buffer_Handle hDstBuf)
+                                      BufferGfx_Dimensions *srcDim,
+                                      Buffer_Handle hDstBuf,
+                                      BufferGfx_Dimensions *dstDim)
 {
-    BufferGfx_Dimensions srcDim;
-    BufferGfx_Dimensions dstDim;
     UInt32 srcOffset, dstOffset;
     Int8 *src, *dst;
+    Int width, height;
     Int i;
 
-    BufferGfx_getDimensions(hSrcBuf, &srcDim);
-    BufferGfx_getDimensions(hDstBuf, &dstDim);
+    assert((srcDim->x & 0x1) == 0);
+    assert((dstDim->x & 0x1) == 0);
 
-    assert((srcDim.x & 0x1) == 0);
-    assert((dstDim.x & 0x1) == 0);
+    width = srcDim->width < dstDim->width ? srcDim->width : dstDim->width;
+    height = srcDim->height < dstDim->height ? srcDim->height : dstDim->height;
 
-    srcOffset = srcDim.y * srcDim.lineLength + srcDim.x;
-    dstOffset = dstDim.y * dstDim.lineLength + dstDim.x;
+    srcOffset = srcDim->y * srcDim->lineLength + srcDim->x;
+    dstOffset = dstDim->y * dstDim->lineLength + dstDim->x;
 
     src = Buffer_getUserPtr(hSrcBuf) + srcOffset;
     dst = Buffer_getUserPtr(hDstBuf) + dstOffset;
 
     /* Copy Y if necessary */
     if (dst != src) {
-        for(i = 0; i < srcDim.height; i++) {
-            memcpy(dst, src, srcDim.width);
-            dst += dstDim.lineLength;
-            src += srcDim.lineLength;
+        for(i = 0; i < height; i++) {
+            memcpy(dst, src, width);
+            dst += dstDim->lineLength;
+            src += srcDim->lineLength;
         }
     }
 
     dst = Buffer_getUserPtr(hDstBuf) + dstOffset + Buffer_getSize(hDstBuf) / 2;
     src = Buffer_getUserPtr(hSrcBuf) +
-          srcDim.y * srcDim.lineLength / 2 + srcDim.x +
+          srcDim->y * srcDim->lineLength / 2 + srcDim->x +
           Buffer_getSize(hSrcBuf) * 2 / 3;
 
-    for(i = 0; i < srcDim.height; i += 2) {
-        memcpy(dst, src, srcDim.width);
-        dst += dstDim.lineLength;
-        memcpy(dst, src, srcDim.width);
-        src += srcDim.lineLength;
-        dst += dstDim.lineLength;
+    for(i = 0; i < height; i += 2) {
+        memcpy(dst, src, width);
+        dst += dstDim->lineLength;
+        memcpy(dst, src, width);
+        src += srcDim->lineLength;
+        dst += dstDim->lineLength;
     }
 
-    Buffer_setNumBytesUsed(hDstBuf, srcDim.width * srcDim.height * 2);
+    Buffer_setNumBytesUsed(hDstBuf, width * height * 2);
 }
 
 /******************************************************************************
@@ -145,70 +176,69 @@ static Void ccv_Yuv420semi_Yuv422semi(Ccv_Handle hCcv,
  ******************************************************************************/
 static Void ccv_Yuv422semi_Yuv420semi(Ccv_Handle hCcv,
                                       Buffer_Handle hSrcBuf,
-                                      Buffer_Handle hDstBuf)
+                                      BufferGfx_Dimensions *srcDim,
+                                      Buffer_Handle hDstBuf,
+                                      BufferGfx_Dimensions *dstDim)
 {
-    BufferGfx_Dimensions srcDim;
-    BufferGfx_Dimensions dstDim;
     UInt32 srcOffset, dstOffset;
     Int8 *src, *dst;
+    Int width, height;
     Int i;
 
-    BufferGfx_getDimensions(hSrcBuf, &srcDim);
-    BufferGfx_getDimensions(hDstBuf, &dstDim);
+    assert((srcDim->x & 0x1) == 0);
+    assert((dstDim->x & 0x1) == 0);
 
-    assert((srcDim.x & 0x1) == 0);
-    assert((dstDim.x & 0x1) == 0);
+    width = srcDim->width < dstDim->width ? srcDim->width : dstDim->width;
+    height = srcDim->height < dstDim->height ? srcDim->height : dstDim->height;
 
-    srcOffset = srcDim.y * srcDim.lineLength + srcDim.x;
-    dstOffset = dstDim.y * dstDim.lineLength + dstDim.x;
+    srcOffset = srcDim->y * srcDim->lineLength + srcDim->x;
+    dstOffset = dstDim->y * dstDim->lineLength + dstDim->x;
 
     src = Buffer_getUserPtr(hSrcBuf) + srcOffset;
     dst = Buffer_getUserPtr(hDstBuf) + dstOffset;
 
     /* Copy Y if necessary */
     if (dst != src) {
-        for(i = 0; i < srcDim.height; i++) {
-            memcpy(dst, src, srcDim.width);
-            dst += dstDim.lineLength;
-            src += srcDim.lineLength;
+        for(i = 0; i < height; i++) {
+            memcpy(dst, src, width);
+            dst += dstDim->lineLength;
+            src += srcDim->lineLength;
         }
     }
 
     src = Buffer_getUserPtr(hSrcBuf) + srcOffset + Buffer_getSize(hSrcBuf) / 2;
     dst = Buffer_getUserPtr(hDstBuf) +
-          dstDim.y * dstDim.lineLength / 2 + dstDim.x +
+          dstDim->y * dstDim->lineLength / 2 + dstDim->x +
           Buffer_getSize(hDstBuf) * 2 / 3;
 
-    for(i = 0; i < srcDim.height; i += 2) {
-        memcpy(dst, src, srcDim.width);
-        src += srcDim.lineLength * 2;
-        dst += dstDim.lineLength;
+    for(i = 0; i < height; i += 2) {
+        memcpy(dst, src, width);
+        src += srcDim->lineLength * 2;
+        dst += dstDim->lineLength;
     }
 
-    Buffer_setNumBytesUsed(hDstBuf, srcDim.width * srcDim.height * 3 / 2);
+    Buffer_setNumBytesUsed(hDstBuf, width * height * 3 / 2);
 }
 
 /******************************************************************************
  * ccv_Yuv420p_Rgb565,
  ******************************************************************************/
 static Void ccv_Yuv420p_Rgb565(Ccv_Handle hCcv,
-                               Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
+                               Buffer_Handle hSrcBuf,
+                               BufferGfx_Dimensions *srcDim,
+                               Buffer_Handle hDstBuf,
+                               BufferGfx_Dimensions *dstDim)
 {
     Int8 *src, *dst;
-    BufferGfx_Dimensions srcDim;
-    BufferGfx_Dimensions dstDim;
     UInt32 crOffset, cbOffset, frameSizeLuma, frameSizeChroma;
     UInt16 *rgbData;
-    const Int16 coeff[5] = {0x2543, 0x3313, -0x0C8A, -0x1A04, 0x408D };
     UInt8 *yData, *cbData, *crData;
-
-    BufferGfx_getDimensions(hSrcBuf, &srcDim);
-    BufferGfx_getDimensions(hDstBuf, &dstDim);
+    Int i;
 
     src = Buffer_getUserPtr(hSrcBuf);
     dst = Buffer_getUserPtr(hDstBuf);
 
-    frameSizeLuma = srcDim.width * srcDim.height;
+    frameSizeLuma = srcDim->width * srcDim->height;
     frameSizeChroma = frameSizeLuma/4;
     cbOffset = frameSizeLuma;
     crOffset = frameSizeLuma + frameSizeChroma;
@@ -218,33 +248,41 @@ static Void ccv_Yuv420p_Rgb565(Ccv_Handle hCcv,
     crData = (UInt8 *)src + crOffset;
     rgbData = (UInt16 *) dst;
 
-    ycbcr420p_rgb565(coeff, yData, cbData, crData, rgbData,
-        (UInt32)srcDim.width, (UInt32)srcDim.height);
+    /* Each chroma line is shared by two luma lines */
+    for (i = 0; i < srcDim->height; i++) {
+        hCcv->kernels->ycbcrRgb(ccvCoeff, yData, cbData, crData,
+                                ColorSpace_YUV420P, rgbData,
+                                ColorSpace_RGB565, srcDim->width);
+        yData += srcDim->width;
+        rgbData += srcDim->width;
+
+        if (i & 1) {
+            cbData += srcDim->width >> 1;
+            crData += srcDim->width >> 1;
+        }
+    }
 
-    Buffer_setNumBytesUsed(hDstBuf, srcDim.width * srcDim.height * 3/2);
+    Buffer_setNumBytesUsed(hDstBuf, srcDim->width * srcDim->height * 3/2);
 }
 
 /******************************************************************************
  * ccv_Yuv422p_Rgb565,
  ******************************************************************************/
 static Void ccv_Yuv422p_Rgb565(Ccv_Handle hCcv,
-                               Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
+                               Buffer_Handle hSrcBuf,
+                               BufferGfx_Dimensions *srcDim,
+                               Buffer_Handle hDstBuf,
+                               BufferGfx_Dimensions *dstDim)
 {
     Int8 *src, *dst;
-    BufferGfx_Dimensions srcDim;
-    BufferGfx_Dimensions dstDim;
     UInt32 crOffset, cbOffset, frameSizeLuma, frameSizeChroma;
     UInt16 *rgbData;
-    const Int16 coeff[5] = {0x2543, 0x3313, -0x0C8A, -0x1A04, 0x408D };
     UInt8 *yData, *cbData, *crData;
 
-    BufferGfx_getDimensions(hSrcBuf, &srcDim);
-    BufferGfx_getDimensions(hDstBuf, &dstDim);
-
     src = Buffer_getUserPtr(hSrcBuf);
     dst = Buffer_getUserPtr(hDstBuf);
 
-    frameSizeLuma = srcDim.width * srcDim.height;
+    frameSizeLuma = srcDim->width * srcDim->height;
     frameSizeChroma = frameSizeLuma/4;
     cbOffset = frameSizeLuma;
     crOffset = frameSizeLuma + frameSizeChroma;
@@ -254,22 +292,193 @@ static Void ccv_Yuv422p_Rgb565(Ccv_Handle hCcv,
     crData = (UInt8 *)src + crOffset;
     rgbData = (UInt16 *) dst;
 
-    ycbcr422p_rgb565(coeff, yData, cbData, crData, rgbData,
-        (UInt32)srcDim.width * (UInt32)srcDim.height);
+    hCcv->kernels->ycbcrRgb(ccvCoeff, yData, cbData, crData,
+                            ColorSpace_YUV422P, rgbData, ColorSpace_RGB565,
+                            (UInt32)srcDim->width * (UInt32)srcDim->height);
+
+    Buffer_setNumBytesUsed(hDstBuf, srcDim->width * srcDim->height * 3/2);
+}
+
+/******************************************************************************
+ * ccv_Yuv420semi_Rgb
+ ******************************************************************************/
+static Void ccv_Yuv420semi_Rgb(Ccv_Handle hCcv,
+                               Buffer_Handle hSrcBuf,
+                               BufferGfx_Dimensions *srcDim,
+                               Buffer_Handle hDstBuf,
+                               BufferGfx_Dimensions *dstDim)
+{
+    ColorSpace_Type dstColorSpace;
+    UInt8 *yData, *cbcrData, *dst;
+    Int width, height, bpp;
+    Int i;
+
+    assert((srcDim->x & 0x1) == 0);
+    assert((srcDim->y & 0x1) == 0);
+
+    dstColorSpace = BufferGfx_getColorSpace(hDstBuf);
+    bpp = ColorSpace_getBpp(dstColorSpace);
+
+    width = srcDim->width < dstDim->width ? srcDim->width : dstDim->width;
+    height = srcDim->height < dstDim->height ? srcDim->height : dstDim->height;
+
+    yData = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+            srcDim->y * srcDim->lineLength + srcDim->x;
+    cbcrData = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+               Buffer_getSize(hSrcBuf) * 2 / 3 +
+               srcDim->y / 2 * srcDim->lineLength + srcDim->x;
+    dst = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+          dstDim->y * dstDim->lineLength + dstDim->x * (bpp >> 3);
+
+    /* Each chroma line is shared by two luma lines */
+    for (i = 0; i < height; i++) {
+        hCcv->kernels->ycbcrRgb(ccvCoeff, yData, cbcrData, cbcrData + 1,
+                                ColorSpace_YUV420PSEMI, dst, dstColorSpace,
+                                width);
+        yData += srcDim->lineLength;
+        dst += dstDim->lineLength;
+
+        if (i & 1) {
+            cbcrData += srcDim->lineLength;
+        }
+    }
+
+    Buffer_setNumBytesUsed(hDstBuf, width * height * (bpp >> 3));
+}
+
+/******************************************************************************
+ * ccv_Uyvy_Rgb
+ ******************************************************************************/
+static Void ccv_Uyvy_Rgb(Ccv_Handle hCcv,
+                         Buffer_Handle hSrcBuf,
+                         BufferGfx_Dimensions *srcDim,
+                         Buffer_Handle hDstBuf,
+                         BufferGfx_Dimensions *dstDim)
+{
+    ColorSpace_Type dstColorSpace;
+    UInt8 *src, *dst;
+    Int width, height, bpp;
+    Int i;
+
+    assert((srcDim->x & 0x1) == 0);
+
+    dstColorSpace = BufferGfx_getColorSpace(hDstBuf);
+    bpp = ColorSpace_getBpp(dstColorSpace);
 
-    Buffer_setNumBytesUsed(hDstBuf, srcDim.width * srcDim.height * 3/2);
+    width = srcDim->width < dstDim->width ? srcDim->width : dstDim->width;
+    height = srcDim->height < dstDim->height ? srcDim->height : dstDim->height;
+
+    src = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+          srcDim->y * srcDim->lineLength + srcDim->x * 2;
+    dst = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+          dstDim->y * dstDim->lineLength + dstDim->x * (bpp >> 3);
+
+    /* UYVY is laid out as Cb0 Y0 Cr0 Y1 */
+    for (i = 0; i < height; i++) {
+        hCcv->kernels->ycbcrRgb(ccvCoeff, src + 1, src, src + 2,
+                                ColorSpace_UYVY, dst, dstColorSpace, width);
+        src += srcDim->lineLength;
+        dst += dstDim->lineLength;
+    }
+
+    Buffer_setNumBytesUsed(hDstBuf, width * height * (bpp >> 3));
 }
 
 /******************************************************************************
- * ycbcr422p_rgb565
+ * ccv_Yuv420semi_Uyvy
  ******************************************************************************/
-static Void ycbcr422p_rgb565
+static Void ccv_Yuv420semi_Uyvy(Ccv_Handle hCcv,
+                                Buffer_Handle hSrcBuf,
+                                BufferGfx_Dimensions *srcDim,
+                                Buffer_Handle hDstBuf,
+                                BufferGfx_Dimensions *dstDim)
+{
+    UInt8 *yData, *cbcrData, *dst;
+    Int width, height;
+    Int i;
+
+    assert((srcDim->x & 0x1) == 0);
+    assert((srcDim->y & 0x1) == 0);
+    assert((dstDim->x & 0x1) == 0);
+
+    width = srcDim->width < dstDim->width ? srcDim->width : dstDim->width;
+    height = srcDim->height < dstDim->height ? srcDim->height : dstDim->height;
+
+    yData = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+            srcDim->y * srcDim->lineLength + srcDim->x;
+    cbcrData = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+               Buffer_getSize(hSrcBuf) * 2 / 3 +
+               srcDim->y / 2 * srcDim->lineLength + srcDim->x;
+    dst = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+          dstDim->y * dstDim->lineLength + dstDim->x * 2;
+
+    for (i = 0; i < height; i++) {
+        hCcv->kernels->semiUyvy(yData, cbcrData, dst, width);
+        yData += srcDim->lineLength;
+        dst += dstDim->lineLength;
+
+        if (i & 1) {
+            cbcrData += srcDim->lineLength;
+        }
+    }
+
+    Buffer_setNumBytesUsed(hDstBuf, width * height * 2);
+}
+
+/******************************************************************************
+ * ccv_Uyvy_Yuv420semi
+ ******************************************************************************/
+static Void ccv_Uyvy_Yuv420semi(Ccv_Handle hCcv,
+                                Buffer_Handle hSrcBuf,
+                                BufferGfx_Dimensions *srcDim,
+                                Buffer_Handle hDstBuf,
+                                BufferGfx_Dimensions *dstDim)
+{
+    UInt8 *src, *yData, *cbcrData;
+    Int width, height;
+    Int i;
+
+    assert((srcDim->x & 0x1) == 0);
+    assert((dstDim->x & 0x1) == 0);
+    assert((dstDim->y & 0x1) == 0);
+
+    width = srcDim->width < dstDim->width ? srcDim->width : dstDim->width;
+    height = srcDim->height < dstDim->height ? srcDim->height : dstDim->height;
+
+    src = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+          srcDim->y * srcDim->lineLength + srcDim->x * 2;
+    yData = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+            dstDim->y * dstDim->lineLength + dstDim->x;
+    cbcrData = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+               Buffer_getSize(hDstBuf) * 2 / 3 +
+               dstDim->y / 2 * dstDim->lineLength + dstDim->x;
+
+    /* The chroma of the odd lines is dropped */
+    for (i = 0; i < height; i++) {
+        hCcv->kernels->uyvySemi(src, yData, i & 1 ? NULL : cbcrData, width);
+        src += srcDim->lineLength;
+        yData += dstDim->lineLength;
+
+        if (i & 1) {
+            cbcrData += dstDim->lineLength;
+        }
+    }
+
+    Buffer_setNumBytesUsed(hDstBuf, width * height * 3 / 2);
+}
+
+/******************************************************************************
+ * ycbcr_rgb
+ ******************************************************************************/
+static Void ycbcr_rgb
 (
     const Int16             coeff[5],   /* Matrix coefficients.             */
     const UInt8             *yData,     /* Luminence data        (Y')       */
     const UInt8             *cbData,    /* Blue color-difference (B'-Y')    */
     const UInt8             *crData,    /* Red color-difference  (R'-Y')    */
-    UInt16                  *rgbData,   /* RGB 5:6:5 packed pixel output.   */
+    ColorSpace_Type         srcColorSpace, /* Layout of the YCbCr data.     */
+    Ptr                     dstData,    /* Packed RGB pixel output.         */
+    ColorSpace_Type         dstColorSpace, /* Format of the RGB output.     */
     UInt32                   numPixels  /* # of luma pixels to process.     */
 )
 {
@@ -292,6 +501,29 @@ static Void ycbcr422p_rgb565
     Int16 b_cb = coeff[4];        /* Cb's contribution to Blue.       */
 
     Int16 rgb0, rgb1;             /* Packed RGB pixel data            */
+    UInt32 alpha;                 /* Alpha of 32 bit RGB pixel data   */
+
+    Int yStep, cStep;             /* Distance between Y and C samples */
+    UInt16 *rgbData = dstData;
+    UInt32 *rgb32Data = dstData;
+
+    switch (srcColorSpace) {
+        case ColorSpace_UYVY:
+            yStep = 2;
+            cStep = 4;
+            break;
+        case ColorSpace_YUV420PSEMI:
+        case ColorSpace_YUV422PSEMI:
+            yStep = 1;
+            cStep = 2;
+            break;
+        default:
+            yStep = 1;
+            cStep = 1;
+            break;
+    }
+
+    alpha = dstColorSpace == ColorSpace_ARGB8888 ? 0xFF000000 : 0;
 
     /* -------------------------------------------------------------------- */
     /*  Iterate for numPixels/2 iters, since we process pixels in pairs.   */
@@ -308,10 +540,14 @@ static Void ycbcr422p_rgb565
         /*  bias of 16 here.                                                */
         /* ---------------------------------------------------------------- */
 
-        y0 = *yData++  - 16;
-        y1 = *yData++  - 16;
-        cb = *cbData++ - 128;
-        cr = *crData++ - 128;
+        y0 = yData[0]     - 16;
+        y1 = yData[yStep] - 16;
+        cb = *cbData      - 128;
+        cr = *crData      - 128;
+
+        yData  += yStep << 1;
+        cbData += cStep;
+        crData += cStep;
 
         /* ================================================================ */
         /*  Convert YCrCb data to RGB format using the following matrix:    */
@@ -377,6 +613,29 @@ static Void ycbcr422p_rgb565
         /*  different Q-point.                                              */
         /* ================================================================ */
 
+        /* ---------------------------------------------------------------- */
+        /*  For 32 bit output the 8-bit components are in bits 20..13.      */
+        /* ---------------------------------------------------------------- */
+        if (dstColorSpace != ColorSpace_RGB565) {
+            r0t = r0 >> 13;
+            g0t = g0 >> 13;
+            b0t = b0 >> 13;
+            r1t = r1 >> 13;
+            g1t = g1 >> 13;
+            b1t = b1 >> 13;
+
+            r0s = r0t < 0 ? 0 : r0t > 255 ? 255 : r0t;
+            g0s = g0t < 0 ? 0 : g0t > 255 ? 255 : g0t;
+            b0s = b0t < 0 ? 0 : b0t > 255 ? 255 : b0t;
+            r1s = r1t < 0 ? 0 : r1t > 255 ? 255 : r1t;
+            g1s = g1t < 0 ? 0 : g1t > 255 ? 255 : g1t;
+            b1s = b1t < 0 ? 0 : b1t > 255 ? 255 : b1t;
+
+            *rgb32Data++ = alpha | (r0s << 16) | (g0s << 8) | b0s;
+            *rgb32Data++ = alpha | (r1s << 16) | (g1s << 8) | b1s;
+            continue;
+        }
+
         /* ---------------------------------------------------------------- */
         /*  Shift away the fractional portion, and then saturate to the     */
         /*  RGB 5:6:5 gamut.                                                */
@@ -411,44 +670,534 @@ static Void ycbcr422p_rgb565
 }
 
 /******************************************************************************
- * ycbcr420p_rgb565
+ * semi_uyvy
  ******************************************************************************/
-static Void ycbcr420p_rgb565(
-    const Int16             coeff[5],   /* Matrix coefficients.             */
-    const UInt8             *yData,     /* Luminence data        (Y')       */
-    const UInt8             *cbData,    /* Blue color-difference (B'-Y')    */
-    const UInt8             *crData,    /* Red color-difference  (R'-Y')    */
-    UInt16                  *rgbData,   /* RGB 5:6:5 packed pixel output.   */
-    UInt32                  width,      /* Width of the buffer.             */
-    UInt32                  height      /* Height of the buffer.            */
-)
+static Void semi_uyvy(const UInt8 *yData, const UInt8 *cbcrData,
+                      UInt8 *uyvyData, UInt32 numPixels)
 {
     Int32 i;
 
-    for(i=0; i<height; i+=2) {
-        ycbcr422p_rgb565(coeff, yData, cbData, crData, rgbData, width);
-         yData += width;
-         rgbData += width;
+    for (i = numPixels >> 1; i > 0; i--) {
+        *uyvyData++ = *cbcrData++;
+        *uyvyData++ = *yData++;
+        *uyvyData++ = *cbcrData++;
+        *uyvyData++ = *yData++;
+    }
+}
+
+/******************************************************************************
+ * uyvy_semi
+ ******************************************************************************/
+static Void uyvy_semi(const UInt8 *uyvyData, UInt8 *yData, UInt8 *cbcrData,
+                      UInt32 numPixels)
+{
+    Int32 i;
+
+    for (i = numPixels >> 1; i > 0; i--) {
+        if (cbcrData) {
+            *cbcrData++ = uyvyData[0];
+            *cbcrData++ = uyvyData[2];
+        }
 
-         ycbcr422p_rgb565(coeff, yData, cbData, crData, rgbData, width);
-         rgbData += width;
-         yData += width;
-         cbData += width >> 1;
-         crData += width >> 1;
+        *yData++ = uyvyData[1];
+        *yData++ = uyvyData[3];
+        uyvyData += 4;
     }
+}
 
-    return;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+/******************************************************************************
+ * ycbcr_rgb_simd (NEON)
+ ******************************************************************************/
+static Void ycbcr_rgb_simd(const Int16 coeff[5], const UInt8 *yData,
+                           const UInt8 *cbData, const UInt8 *crData,
+                           ColorSpace_Type srcColorSpace, Ptr dstData,
+                           ColorSpace_Type dstColorSpace, UInt32 numPixels)
+{
+    const int16x8_t zero = vdupq_n_s16(0);
+    const uint8x8_t alpha = vdup_n_u8(dstColorSpace == ColorSpace_ARGB8888 ?
+                                      0xFF : 0);
+    UInt8 *dst = dstData;
+    UInt32 cb4, cr4;
+    UInt32 n;
+
+    /*
+     * Same arithmetic as ycbcr_rgb on 8 pixels at a time: the products are
+     * widened to 32 bits and the results truncated before saturation, so the
+     * output is bit exact with the scalar kernel.
+     */
+    for (n = numPixels >> 3; n > 0; n--) {
+        uint8x8_t y8, c8;
+        int16x8_t y, c;
+        int16x4x2_t cbcr;
+        int32x4_t yLo, yHi, rt, gt, bt;
+        int32x4x2_t r, g, b;
+
+        switch (srcColorSpace) {
+            case ColorSpace_UYVY: {
+                uint8x8x2_t uyvy = vld2_u8(cbData);
+
+                c8 = uyvy.val[0];
+                y8 = uyvy.val[1];
+                yData += 16;
+                cbData += 16;
+                crData += 16;
+                break;
+            }
+            case ColorSpace_YUV420PSEMI:
+            case ColorSpace_YUV422PSEMI:
+                y8 = vld1_u8(yData);
+                c8 = vld1_u8(cbData);
+                yData += 8;
+                cbData += 8;
+                crData += 8;
+                break;
+            default:
+                memcpy(&cb4, cbData, sizeof(cb4));
+                memcpy(&cr4, crData, sizeof(cr4));
+                y8 = vld1_u8(yData);
+                c8 = vzip_u8(vcreate_u8(cb4), vcreate_u8(cr4)).val[0];
+                yData += 8;
+                cbData += 4;
+                crData += 4;
+                break;
+        }
+
+        y = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y8)), vdupq_n_s16(16));
+        c = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c8)), vdupq_n_s16(128));
+        cbcr = vuzp_s16(vget_low_s16(c), vget_high_s16(c));
+
+        /* Chroma contribution, one per pixel pair */
+        rt = vmull_n_s16(cbcr.val[1], coeff[1]);
+        gt = vmlal_n_s16(vmull_n_s16(cbcr.val[0], coeff[2]),
+                         cbcr.val[1], coeff[3]);
+        bt = vmull_n_s16(cbcr.val[0], coeff[4]);
+
+        yLo = vmull_n_s16(vget_low_s16(y), coeff[0]);
+        yHi = vmull_n_s16(vget_high_s16(y), coeff[0]);
+
+        r = vzipq_s32(rt, rt);
+        g = vzipq_s32(gt, gt);
+        b = vzipq_s32(bt, bt);
+
+        r.val[0] = vaddq_s32(yLo, r.val[0]);
+        r.val[1] = vaddq_s32(yHi, r.val[1]);
+        g.val[0] = vaddq_s32(yLo, g.val[0]);
+        g.val[1] = vaddq_s32(yHi, g.val[1]);
+        b.val[0] = vaddq_s32(yLo, b.val[0]);
+        b.val[1] = vaddq_s32(yHi, b.val[1]);
+
+        if (dstColorSpace == ColorSpace_RGB565) {
+            int16x8_t r16, g16, b16;
+            uint16x8_t rgb;
+
+            r16 = vcombine_s16(vqshrn_n_s32(r.val[0], 16),
+                               vqshrn_n_s32(r.val[1], 16));
+            g16 = vcombine_s16(vqshrn_n_s32(g.val[0], 15),
+                               vqshrn_n_s32(g.val[1], 15));
+            b16 = vcombine_s16(vqshrn_n_s32(b.val[0], 16),
+                               vqshrn_n_s32(b.val[1], 16));
+
+            r16 = vminq_s16(vmaxq_s16(r16, zero), vdupq_n_s16(31));
+            g16 = vminq_s16(vmaxq_s16(g16, zero), vdupq_n_s16(63));
+            b16 = vminq_s16(vmaxq_s16(b16, zero), vdupq_n_s16(31));
+
+            rgb = vorrq_u16(vshlq_n_u16(vreinterpretq_u16_s16(r16), 11),
+                            vshlq_n_u16(vreinterpretq_u16_s16(g16), 5));
+            rgb = vorrq_u16(rgb, vreinterpretq_u16_s16(b16));
+
+            vst1q_u16((UInt16 *) dst, rgb);
+            dst += 16;
+        }
+        else {
+            uint8x8x4_t bgra;
+
+            bgra.val[0] = vqmovun_s16(vcombine_s16(vqshrn_n_s32(b.val[0], 13),
+                                                   vqshrn_n_s32(b.val[1], 13)));
+            bgra.val[1] = vqmovun_s16(vcombine_s16(vqshrn_n_s32(g.val[0], 13),
+                                                   vqshrn_n_s32(g.val[1], 13)));
+            bgra.val[2] = vqmovun_s16(vcombine_s16(vqshrn_n_s32(r.val[0], 13),
+                                                   vqshrn_n_s32(r.val[1], 13)));
+            bgra.val[3] = alpha;
+
+            vst4_u8(dst, bgra);
+            dst += 32;
+        }
+    }
+
+    if (numPixels & 7) {
+        ycbcr_rgb(coeff, yData, cbData, crData, srcColorSpace, dst,
+                  dstColorSpace, numPixels & 7);
+    }
+}
+
+/******************************************************************************
+ * semi_uyvy_simd (NEON)
+ ******************************************************************************/
+static Void semi_uyvy_simd(const UInt8 *yData, const UInt8 *cbcrData,
+                           UInt8 *uyvyData, UInt32 numPixels)
+{
+    uint8x16x2_t uyvy;
+    UInt32 n;
+
+    for (n = numPixels >> 4; n > 0; n--) {
+        uyvy.val[0] = vld1q_u8(cbcrData);
+        uyvy.val[1] = vld1q_u8(yData);
+        vst2q_u8(uyvyData, uyvy);
+
+        yData += 16;
+        cbcrData += 16;
+        uyvyData += 32;
+    }
+
+    semi_uyvy(yData, cbcrData, uyvyData, numPixels & 15);
+}
+
+/******************************************************************************
+ * uyvy_semi_simd (NEON)
+ ******************************************************************************/
+static Void uyvy_semi_simd(const UInt8 *uyvyData, UInt8 *yData,
+                           UInt8 *cbcrData, UInt32 numPixels)
+{
+    uint8x16x2_t uyvy;
+    UInt32 n;
+
+    for (n = numPixels >> 4; n > 0; n--) {
+        uyvy = vld2q_u8(uyvyData);
+        vst1q_u8(yData, uyvy.val[1]);
+
+        if (cbcrData) {
+            vst1q_u8(cbcrData, uyvy.val[0]);
+            cbcrData += 16;
+        }
+
+        uyvyData += 32;
+        yData += 16;
+    }
+
+    uyvy_semi(uyvyData, yData, cbcrData, numPixels & 15);
 }
 
+#elif defined(__SSE2__)
+/******************************************************************************
+ * ycbcr_rgb_simd (SSE2)
+ ******************************************************************************/
+static Void ycbcr_rgb_simd(const Int16 coeff[5], const UInt8 *yData,
+                           const UInt8 *cbData, const UInt8 *crData,
+                           ColorSpace_Type srcColorSpace, Ptr dstData,
+                           ColorSpace_Type dstColorSpace, UInt32 numPixels)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i luma = _mm_set1_epi16(coeff[0]);
+    /* Coefficients applied to (Cb, Cr) pairs by _mm_madd_epi16 */
+    const __m128i rCoeff = _mm_set1_epi32((UInt32)(UInt16) coeff[1] << 16);
+    const __m128i gCoeff = _mm_set1_epi32((UInt32)(UInt16) coeff[3] << 16 |
+                                          (UInt16) coeff[2]);
+    const __m128i bCoeff = _mm_set1_epi32((UInt16) coeff[4]);
+    const __m128i alpha = _mm_set1_epi8(dstColorSpace == ColorSpace_ARGB8888 ?
+                                        0xFF : 0);
+    UInt8 *dst = dstData;
+    Int32 cb4, cr4;
+    UInt32 n;
+
+    /*
+     * Same arithmetic as ycbcr_rgb on 8 pixels at a time: the products are
+     * widened to 32 bits and the results truncated before saturation, so the
+     * output is bit exact with the scalar kernel.
+     */
+    for (n = numPixels >> 3; n > 0; n--) {
+        __m128i y, c, lo, hi, yLo, yHi, rt, gt, bt;
+        __m128i r0, r1, g0, g1, b0, b1;
+
+        switch (srcColorSpace) {
+            case ColorSpace_UYVY:
+                c = _mm_loadu_si128((const __m128i *) cbData);
+                y = _mm_srli_epi16(c, 8);
+                c = _mm_and_si128(c, _mm_set1_epi16(0xFF));
+                yData += 16;
+                cbData += 16;
+                crData += 16;
+                break;
+            case ColorSpace_YUV420PSEMI:
+            case ColorSpace_YUV422PSEMI:
+                y = _mm_loadl_epi64((const __m128i *) yData);
+                c = _mm_loadl_epi64((const __m128i *) cbData);
+                y = _mm_unpacklo_epi8(y, zero);
+                c = _mm_unpacklo_epi8(c, zero);
+                yData += 8;
+                cbData += 8;
+                crData += 8;
+                break;
+            default:
+                memcpy(&cb4, cbData, sizeof(cb4));
+                memcpy(&cr4, crData, sizeof(cr4));
+                y = _mm_loadl_epi64((const __m128i *) yData);
+                y = _mm_unpacklo_epi8(y, zero);
+                c = _mm_unpacklo_epi8(_mm_cvtsi32_si128(cb4),
+                                      _mm_cvtsi32_si128(cr4));
+                c = _mm_unpacklo_epi8(c, zero);
+                yData += 8;
+                cbData += 4;
+                crData += 4;
+                break;
+        }
+
+        y = _mm_sub_epi16(y, _mm_set1_epi16(16));
+        c = _mm_sub_epi16(c, _mm_set1_epi16(128));
+
+        /* Chroma contribution, one per pixel pair */
+        rt = _mm_madd_epi16(c, rCoeff);
+        gt = _mm_madd_epi16(c, gCoeff);
+        bt = _mm_madd_epi16(c, bCoeff);
+
+        lo = _mm_mullo_epi16(y, luma);
+        hi = _mm_mulhi_epi16(y, luma);
+        yLo = _mm_unpacklo_epi16(lo, hi);
+        yHi = _mm_unpackhi_epi16(lo, hi);
+
+        r0 = _mm_add_epi32(yLo, _mm_unpacklo_epi32(rt, rt));
+        r1 = _mm_add_epi32(yHi, _mm_unpackhi_epi32(rt, rt));
+        g0 = _mm_add_epi32(yLo, _mm_unpacklo_epi32(gt, gt));
+        g1 = _mm_add_epi32(yHi, _mm_unpackhi_epi32(gt, gt));
+        b0 = _mm_add_epi32(yLo, _mm_unpacklo_epi32(bt, bt));
+        b1 = _mm_add_epi32(yHi, _mm_unpackhi_epi32(bt, bt));
+
+        if (dstColorSpace == ColorSpace_RGB565) {
+            __m128i r, g, b;
+
+            r = _mm_packs_epi32(_mm_srai_epi32(r0, 16), _mm_srai_epi32(r1, 16));
+            g = _mm_packs_epi32(_mm_srai_epi32(g0, 15), _mm_srai_epi32(g1, 15));
+            b = _mm_packs_epi32(_mm_srai_epi32(b0, 16), _mm_srai_epi32(b1, 16));
+
+            r = _mm_min_epi16(_mm_max_epi16(r, zero), _mm_set1_epi16(31));
+            g = _mm_min_epi16(_mm_max_epi16(g, zero), _mm_set1_epi16(63));
+            b = _mm_min_epi16(_mm_max_epi16(b, zero), _mm_set1_epi16(31));
+
+            r = _mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5));
+            _mm_storeu_si128((__m128i *) dst, _mm_or_si128(r, b));
+            dst += 16;
+        }
+        else {
+            __m128i r, g, b, bg, ra;
+
+            r = _mm_packs_epi32(_mm_srai_epi32(r0, 13), _mm_srai_epi32(r1, 13));
+            g = _mm_packs_epi32(_mm_srai_epi32(g0, 13), _mm_srai_epi32(g1, 13));
+            b = _mm_packs_epi32(_mm_srai_epi32(b0, 13), _mm_srai_epi32(b1, 13));
+
+            r = _mm_packus_epi16(r, r);
+            g = _mm_packus_epi16(g, g);
+            b = _mm_packus_epi16(b, b);
+
+            bg = _mm_unpacklo_epi8(b, g);
+            ra = _mm_unpacklo_epi8(r, alpha);
+
+            _mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi16(bg, ra));
+            _mm_storeu_si128((__m128i *) (dst + 16),
+                             _mm_unpackhi_epi16(bg, ra));
+            dst += 32;
+        }
+    }
+
+    if (numPixels & 7) {
+        ycbcr_rgb(coeff, yData, cbData, crData, srcColorSpace, dst,
+                  dstColorSpace, numPixels & 7);
+    }
+}
+
+/******************************************************************************
+ * semi_uyvy_simd (SSE2)
+ ******************************************************************************/
+static Void semi_uyvy_simd(const UInt8 *yData, const UInt8 *cbcrData,
+                           UInt8 *uyvyData, UInt32 numPixels)
+{
+    __m128i y, c;
+    UInt32 n;
+
+    for (n = numPixels >> 4; n > 0; n--) {
+        y = _mm_loadu_si128((const __m128i *) yData);
+        c = _mm_loadu_si128((const __m128i *) cbcrData);
+
+        _mm_storeu_si128((__m128i *) uyvyData, _mm_unpacklo_epi8(c, y));
+        _mm_storeu_si128((__m128i *) (uyvyData + 16), _mm_unpackhi_epi8(c, y));
+
+        yData += 16;
+        cbcrData += 16;
+        uyvyData += 32;
+    }
+
+    semi_uyvy(yData, cbcrData, uyvyData, numPixels & 15);
+}
+
+/******************************************************************************
+ * uyvy_semi_simd (SSE2)
+ ******************************************************************************/
+static Void uyvy_semi_simd(const UInt8 *uyvyData, UInt8 *yData,
+                           UInt8 *cbcrData, UInt32 numPixels)
+{
+    const __m128i mask = _mm_set1_epi16(0xFF);
+    __m128i lo, hi;
+    UInt32 n;
+
+    for (n = numPixels >> 4; n > 0; n--) {
+        lo = _mm_loadu_si128((const __m128i *) uyvyData);
+        hi = _mm_loadu_si128((const __m128i *) (uyvyData + 16));
+
+        _mm_storeu_si128((__m128i *) yData,
+                         _mm_packus_epi16(_mm_srli_epi16(lo, 8),
+                                          _mm_srli_epi16(hi, 8)));
+
+        if (cbcrData) {
+            _mm_storeu_si128((__m128i *) cbcrData,
+                             _mm_packus_epi16(_mm_and_si128(lo, mask),
+                                              _mm_and_si128(hi, mask)));
+            cbcrData += 16;
+        }
+
+        uyvyData += 32;
+        yData += 16;
+    }
+
+    uyvy_semi(uyvyData, yData, cbcrData, numPixels & 15);
+}
+#endif
+
+static const _Ccv_Kernels scalarKernels = {
+    ycbcr_rgb,
+    semi_uyvy,
+    uyvy_semi,
+};
+
+#if defined(CCV_SIMD)
+static const _Ccv_Kernels simdKernels = {
+    ycbcr_rgb_simd,
+    semi_uyvy_simd,
+    uyvy_semi_simd,
+};
+#endif
+
 /* Unaccelerated color conversion function pointers */
-static Void (*ccvFxns[Ccv_Mode_COUNT])(Ccv_Handle hCcv, Buffer_Handle hSrcBuf,
-                                      Buffer_Handle hDstBuf) = {
+static Void (*ccvFxns[Ccv_Mode_COUNT])(Ccv_Handle hCcv,
+                                      Buffer_Handle hSrcBuf,
+                                      BufferGfx_Dimensions *srcDim,
+                                      Buffer_Handle hDstBuf,
+                                      BufferGfx_Dimensions *dstDim) = {
     ccv_Yuv420semi_Yuv422semi,
     ccv_Yuv422semi_Yuv420semi,
     ccv_Yuv420p_Rgb565,
     ccv_Yuv422p_Rgb565,
+    ccv_Yuv420semi_Rgb,
+    ccv_Yuv420semi_Rgb,
+    ccv_Yuv420semi_Rgb,
+    ccv_Uyvy_Rgb,
+    ccv_Uyvy_Rgb,
+    ccv_Uyvy_Rgb,
+    ccv_Yuv420semi_Uyvy,
+    ccv_Uyvy_Yuv420semi,
 };
 
+/******************************************************************************
+ * checkRegion
+ ******************************************************************************/
+static Int checkRegion(Buffer_Handle hBuf, BufferGfx_Dimensions *dim)
+{
+    ColorSpace_Type colorSpace = BufferGfx_getColorSpace(hBuf);
+    Int32 lumaSize = Buffer_getSize(hBuf);
+    Int bpp = ColorSpace_getBpp(colorSpace);
+
+    if (colorSpace == ColorSpace_YUV420PSEMI) {
+        lumaSize = lumaSize * 2 / 3;
+    }
+    else if (colorSpace == ColorSpace_YUV422PSEMI) {
+        lumaSize = lumaSize / 2;
+    }
+
+    if (dim->x < 0 || dim->y < 0 || dim->width <= 0 || dim->height <= 0 ||
+        bpp <= 0 || dim->lineLength < (dim->x + dim->width) * (bpp >> 3)) {
+
+        Dmai_err4("Invalid region %dx%d at %d,%d\n",
+                  (Int) dim->width, (Int) dim->height,
+                  (Int) dim->x, (Int) dim->y);
+        return Dmai_EINVAL;
+    }
+
+    /* Chroma is shared by two adjacent pixels (and lines for 420Psemi) */
+    if ((dim->x & 1) || (colorSpace == ColorSpace_YUV420PSEMI &&
+                         ((dim->y & 1) || (dim->height & 1)))) {
+        Dmai_err2("Region position %d,%d not aligned to the chroma\n",
+                  (Int) dim->x, (Int) dim->y);
+        return Dmai_EINVAL;
+    }
+
+    if ((dim->y + dim->height) * dim->lineLength > lumaSize) {
+        Dmai_err0("Region does not fit in the buffer\n");
+        return Dmai_EINVAL;
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * setDstDirty
+ ******************************************************************************/
+static Void setDstDirty(Ccv_Handle hCcv,
+                        BufferGfx_Dimensions *srcDim,
+                        Buffer_Handle hDstBuf,
+                        BufferGfx_Dimensions *dstDim)
+{
+    ColorSpace_Type colorSpace = BufferGfx_getColorSpace(hDstBuf);
+    Int32 size = Buffer_getSize(hDstBuf);
+    Int32 lineLength = dstDim->lineLength;
+    Int width, height, bytesPerPixel;
+
+    /* The planar conversions write packed RGB565 from the start */
+    if (hCcv->mode == Ccv_Mode_YUV420P_RGB565 ||
+        hCcv->mode == Ccv_Mode_YUV422PSEMI_RGB565) {
+
+        Buffer_setCpuDirty(hDstBuf, 0, srcDim->width * srcDim->height * 2);
+        return;
+    }
+
+    width = srcDim->width < dstDim->width ? srcDim->width : dstDim->width;
+    height = srcDim->height < dstDim->height ? srcDim->height : dstDim->height;
+    bytesPerPixel = ColorSpace_getBpp(colorSpace) >> 3;
+
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    Buffer_setCpuDirty(hDstBuf,
+                       dstDim->y * lineLength + dstDim->x * bytesPerPixel,
+                       (height - 1) * lineLength + width * bytesPerPixel);
+
+    if (colorSpace == ColorSpace_YUV420PSEMI) {
+        Buffer_setCpuDirty(hDstBuf,
+                           size * 2 / 3 + dstDim->y / 2 * lineLength +
+                           dstDim->x,
+                           ((height + 1) / 2 - 1) * lineLength + width);
+    }
+    else if (colorSpace == ColorSpace_YUV422PSEMI) {
+        /* The 420 to 422 chroma rows are written in pairs */
+        Buffer_setCpuDirty(hDstBuf,
+                           size / 2 + dstDim->y * lineLength + dstDim->x,
+                           (((height + 1) & ~1) - 1) * lineLength + width);
+    }
+}
+
+/******************************************************************************
+ * getKernels
+ ******************************************************************************/
+static const _Ccv_Kernels *getKernels(Void)
+{
+#if defined(CCV_SIMD)
+    if (_Ccv_simdSupported()) {
+        Dmai_dbg0("Using " CCV_SIMD " color conversion kernels\n");
+        return &simdKernels;
+    }
+#endif
+
+    return &scalarKernels;
+}
+
 /******************************************************************************
  * Ccv_create
  ******************************************************************************/
@@ -483,6 +1232,9 @@ Ccv_Handle Ccv_create(Ccv_Attrs *attrs)
             return NULL;
         }
     }
+    else {
+        hCcv->kernels = getKernels();
+    }
 
     return hCcv;
 }
@@ -555,12 +1307,50 @@ Int Ccv_config(Ccv_Handle hCcv, Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
                     return Dmai_EINVAL;
                 }
 
-                if (BufferGfx_getColorSpace(hDstBuf) == ColorSpace_YUV422PSEMI){
-                    hCcv->mode = Ccv_Mode_YUV420SEMI_YUV422SEMI;
+                switch (BufferGfx_getColorSpace(hDstBuf)) {
+                    case ColorSpace_YUV422PSEMI:
+                        hCcv->mode = Ccv_Mode_YUV420SEMI_YUV422SEMI;
+                        break;
+                    case ColorSpace_RGB565:
+                        hCcv->mode = Ccv_Mode_YUV420SEMI_RGB565;
+                        break;
+                    case ColorSpace_RGB888:
+                        hCcv->mode = Ccv_Mode_YUV420SEMI_RGB888;
+                        break;
+                    case ColorSpace_ARGB8888:
+                        hCcv->mode = Ccv_Mode_YUV420SEMI_ARGB8888;
+                        break;
+                    case ColorSpace_UYVY:
+                        hCcv->mode = Ccv_Mode_YUV420SEMI_UYVY;
+                        break;
+                    default:
+                        Dmai_err0("Color conversion mode not supported\n");
+                        return Dmai_ENOTIMPL;
                 }
-                else {
-                    Dmai_err0("Color conversion mode not supported\n");
-                    return Dmai_ENOTIMPL;
+                break;
+            case ColorSpace_UYVY:
+                /* Two adjacent pixels are dependent, hence need even numbers */
+                if (width & 1) {
+                    Dmai_err1("Width needs to be even (%d)\n", width);
+                    return Dmai_EINVAL;
+                }
+
+                switch (BufferGfx_getColorSpace(hDstBuf)) {
+                    case ColorSpace_RGB565:
+                        hCcv->mode = Ccv_Mode_UYVY_RGB565;
+                        break;
+                    case ColorSpace_RGB888:
+                        hCcv->mode = Ccv_Mode_UYVY_RGB888;
+                        break;
+                    case ColorSpace_ARGB8888:
+                        hCcv->mode = Ccv_Mode_UYVY_ARGB8888;
+                        break;
+                    case ColorSpace_YUV420PSEMI:
+                        hCcv->mode = Ccv_Mode_UYVY_YUV420SEMI;
+                        break;
+                    default:
+                        Dmai_err0("Color conversion mode not supported\n");
+                        return Dmai_ENOTIMPL;
                 }
                 break;
             case ColorSpace_YUV420P:
@@ -592,6 +1382,8 @@ Int Ccv_config(Ccv_Handle hCcv, Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
  ******************************************************************************/
 Int Ccv_execute(Ccv_Handle hCcv, Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
+    BufferGfx_Dimensions srcDim, dstDim;
+
     assert(hCcv);
     assert(hSrcBuf);
     assert(hDstBuf);
@@ -608,7 +1400,12 @@ Int Ccv_execute(Ccv_Handle hCcv, Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
     }
 
     if (ccvFxns[hCcv->mode]) {
-        ccvFxns[hCcv->mode](hCcv, hSrcBuf, hDstBuf);
+        BufferGfx_getDimensions(hSrcBuf, &srcDim);
+        BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+        Buffer_cacheInv(hSrcBuf);
+        ccvFxns[hCcv->mode](hCcv, hSrcBuf, &srcDim, hDstBuf, &dstDim);
+        setDstDirty(hCcv, &srcDim, hDstBuf, &dstDim);
     }
     else {
         return Dmai_ENOTIMPL;
@@ -617,6 +1414,48 @@ Int Ccv_execute(Ccv_Handle hCcv, Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * Ccv_executeRegion
+ ******************************************************************************/
+Int Ccv_executeRegion(Ccv_Handle hCcv,
+                      Buffer_Handle hSrcBuf, BufferGfx_Dimensions *srcDim,
+                      Buffer_Handle hDstBuf, BufferGfx_Dimensions *dstDim)
+{
+    assert(hCcv);
+    assert(hSrcBuf);
+    assert(hDstBuf);
+    assert(srcDim);
+    assert(dstDim);
+    assert(Buffer_getUserPtr(hSrcBuf));
+    assert(Buffer_getUserPtr(hDstBuf));
+    assert(Buffer_getType(hSrcBuf) == Buffer_Type_GRAPHICS);
+    assert(Buffer_getType(hDstBuf) == Buffer_Type_GRAPHICS);
+
+    if (hCcv->accel) {
+        Dmai_err0("Region conversion not supported by accelerated Ccv\n");
+        return Dmai_ENOTIMPL;
+    }
+
+    /* The planar conversions work on whole frames only */
+    if (hCcv->mode == Ccv_Mode_YUV420P_RGB565 ||
+        hCcv->mode == Ccv_Mode_YUV422PSEMI_RGB565 ||
+        ccvFxns[hCcv->mode] == NULL) {
+
+        Dmai_err0("Region conversion not supported for this mode\n");
+        return Dmai_ENOTIMPL;
+    }
+
+    if (checkRegion(hSrcBuf, srcDim) < 0 || checkRegion(hDstBuf, dstDim) < 0) {
+        return Dmai_EINVAL;
+    }
+
+    Buffer_cacheInv(hSrcBuf);
+    ccvFxns[hCcv->mode](hCcv, hSrcBuf, srcDim, hDstBuf, dstDim);
+    setDstDirty(hCcv, srcDim, hDstBuf, dstDim);
+
+    return Dmai_EOK;
+}
+
 /******************************************************************************
  * Ccv_getMode
  ******************************************************************************/
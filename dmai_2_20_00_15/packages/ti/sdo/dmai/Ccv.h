@@ -88,6 +88,7 @@
 
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
 
 /** @ingroup    ti_sdo_dmai_Ccv */
 /*@{*/
@@ -109,6 +110,30 @@ typedef enum {
     /** @brief From 422Psemi to RGB565 */
     Ccv_Mode_YUV422PSEMI_RGB565,
 
+    /** @brief From 420Psemi (NV12) to RGB565 */
+    Ccv_Mode_YUV420SEMI_RGB565,
+
+    /** @brief From 420Psemi (NV12) to RGB888 */
+    Ccv_Mode_YUV420SEMI_RGB888,
+
+    /** @brief From 420Psemi (NV12) to ARGB8888 (opaque alpha) */
+    Ccv_Mode_YUV420SEMI_ARGB8888,
+
+    /** @brief From UYVY to RGB565 */
+    Ccv_Mode_UYVY_RGB565,
+
+    /** @brief From UYVY to RGB888 */
+    Ccv_Mode_UYVY_RGB888,
+
+    /** @brief From UYVY to ARGB8888 (opaque alpha) */
+    Ccv_Mode_UYVY_ARGB8888,
+
+    /** @brief From 420Psemi (NV12) to UYVY */
+    Ccv_Mode_YUV420SEMI_UYVY,
+
+    /** @brief From UYVY to 420Psemi (NV12), chroma taken from even lines */
+    Ccv_Mode_UYVY_YUV420SEMI,
+
     Ccv_Mode_COUNT
 } Ccv_Mode;
 
@@ -180,10 +205,43 @@ extern Int Ccv_config(Ccv_Handle hCcv,
  *
  * @remarks     #Ccv_create must be called before this function.
  * @remarks     #Ccv_config must be called before this function.
+ * @remarks     Without H/W acceleration the conversion runs on the CPU,
+ *              using NEON (ARM) or SSE2 (x86) kernels when the processor
+ *              supports them. The output is identical to the scalar code.
  */
 extern Int Ccv_execute(Ccv_Handle hCcv,
                        Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf);
 
+/**
+ * @brief       Execute a Color Conversion job on a region of the buffers.
+ *              The crop of the source, the repacking to the destination
+ *              line length and the color conversion are done in a single
+ *              pass, without an intermediate buffer.
+ *
+ * @param[in]   hCcv        The #Ccv_Handle of the job to execute.
+ * @param[in]   hSrcBuf     The source buffer to convert from.
+ * @param[in]   srcDim      The region of the source buffer to read.
+ * @param[in]   hDstBuf     The destination buffer to convert to.
+ * @param[in]   dstDim      The region of the destination buffer to write.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      Dmai_EINVAL if a region is not chroma aligned or does not
+ *              fit in its buffer.
+ * @retval      Dmai_ENOTIMPL if the job is accelerated or converts from a
+ *              planar format.
+ *
+ * @remarks     #Ccv_create must be called before this function.
+ * @remarks     #Ccv_config must be called before this function. The color
+ *              spaces are the ones the job was configured for.
+ * @remarks     The dimensions stored in the buffers are not used. The
+ *              smaller of the two region widths and heights is converted.
+ */
+extern Int Ccv_executeRegion(Ccv_Handle hCcv,
+                             Buffer_Handle hSrcBuf,
+                             BufferGfx_Dimensions *srcDim,
+                             Buffer_Handle hDstBuf,
+                             BufferGfx_Dimensions *dstDim);
+
 /**
  * @brief       Gets the mode of a configured color conversion job.
  *
@@ -44,6 +44,7 @@ Int ColorSpace_getBpp(ColorSpace_Type colorSpace)
 
     switch (colorSpace) {
         case ColorSpace_RGB888:
+        case ColorSpace_ARGB8888:
             bpp = 32;
             break;
 
@@ -114,6 +114,12 @@ typedef enum {
       */
     ColorSpace_GRAY,
 
+    /**
+      * @brief ARGB 8888 packed, 32 bits per pixel with the alpha component
+      *        in the most significant byte (V4L2_PIX_FMT_RGB32 with alpha).
+      */
+    ColorSpace_ARGB8888,
+
     ColorSpace_COUNT
 } ColorSpace_Type;
 
@@ -66,11 +66,41 @@
 
 #include <ti/sdo/dmai/Dmai.h>
 
+/**
+ * @brief       Timeout value for #Fifo_getTimeout and #Fifo_getMany to block
+ *              until an element is available.
+ */
+#define Fifo_FOREVER    ((UInt32) -1)
+
+/**
+ * @brief       Timeout value for #Fifo_getTimeout and #Fifo_getMany to
+ *              return immediately if no element is available.
+ */
+#define Fifo_POLL       ((UInt32) 0)
+
 /**
  * @brief       Handle through which to reference a Fifo.
  */
 typedef struct Fifo_Object *Fifo_Handle;
 
+/**
+ * @brief       Fifo backends (see #Fifo_Attrs).
+ */
+typedef enum {
+    /** @brief Elements are passed through a pipe(2) (Linux default). */
+    Fifo_Mode_PIPE = 0,
+
+    /**
+     * @brief Elements are passed through a bounded lock-free ring shared
+     *        by exactly one producer thread and one consumer thread. The
+     *        calling threads only enter the kernel when the ring is empty
+     *        (#Fifo_get) or full (#Fifo_put).
+     */
+    Fifo_Mode_RING,
+
+    Fifo_Mode_COUNT
+} Fifo_Mode;
+
 /**
  * @brief       Attributes used to create a Fifo.
  * @see         Fifo_Attrs_DEFAULT.
@@ -78,15 +108,24 @@ typedef struct Fifo_Object *Fifo_Handle;
 typedef struct Fifo_Attrs {
     /** 
      * @brief      Maximum elements that can be put on the Fifo at once
-     * @remarks    For Bios only, Linux ignores this attribute
+     * @remarks    For Bios, and for Linux when mode is #Fifo_Mode_RING, in
+     *             which case it is rounded up to the next power of 2.
+     *             Ignored on Linux for #Fifo_Mode_PIPE.
      */     
     Int maxElems;
+
+    /** 
+     * @brief      Backend used to pass elements, see #Fifo_Mode.
+     * @remarks    For Linux only, Bios ignores this attribute
+     */     
+    Fifo_Mode mode;
 } Fifo_Attrs;
 
 /**
  * @brief       Default attributes for a Fifo.
  * @code
  * numElems     = 20
+ * mode         = Fifo_Mode_PIPE
  * @endcode
  */
 extern const Fifo_Attrs Fifo_Attrs_DEFAULT;
@@ -116,9 +155,54 @@ extern Fifo_Handle Fifo_create(Fifo_Attrs *attrs);
  * @retval      "Negative value" for failure, see Dmai.h.
  *
  * @remarks     #Fifo_create must be called before this function.
+ *
+ * @remarks     For #Fifo_Mode_RING only one thread may call this function
+ *              on a given fifo.
  */
 extern Int Fifo_get(Fifo_Handle hFifo, Ptr ptrPtr);
 
+/**
+ * @brief       Receive a buffer pointer from a fifo, waiting at most a given
+ *              time for one to become available.
+ *
+ * @param[in]   hFifo       #Fifo_Handle from which to receive a buffer.
+ * @param[out]  ptrPtr      A pointer to the pointer to be set.
+ * @param[in]   timeout     Maximum time to wait in microseconds, or
+ *                          #Fifo_POLL or #Fifo_FOREVER.
+ *
+ * @retval      Dmai_EOK if a buffer was successfully received.
+ * @retval      Dmai_EFLUSH if the fifo was flushed.
+ * @retval      Dmai_ETIMEOUT if no buffer was received within timeout.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     #Fifo_create must be called before this function.
+ *
+ * @remarks     On Bios the timeout is rounded up to whole system clock ticks.
+ */
+extern Int Fifo_getTimeout(Fifo_Handle hFifo, Ptr ptrPtr, UInt32 timeout);
+
+/**
+ * @brief       Receive a burst of buffer pointers from a fifo in one
+ *              operation. Waits until at least one pointer is available,
+ *              then returns as many as are queued, up to maxPtrs.
+ *
+ * @param[in]   hFifo       #Fifo_Handle from which to receive buffers.
+ * @param[out]  ptrs        Array of at least maxPtrs pointers to be set.
+ * @param[in]   maxPtrs     Maximum number of pointers to receive.
+ * @param[out]  numPtrs     Number of pointers actually received.
+ * @param[in]   timeout     Maximum time to wait in microseconds, or
+ *                          #Fifo_POLL or #Fifo_FOREVER.
+ *
+ * @retval      Dmai_EOK if at least one buffer was received.
+ * @retval      Dmai_EFLUSH if the fifo was flushed.
+ * @retval      Dmai_ETIMEOUT if no buffer was received within timeout.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     #Fifo_create must be called before this function.
+ */
+extern Int Fifo_getMany(Fifo_Handle hFifo, Ptr ptrs[], Int maxPtrs,
+                        Int *numPtrs, UInt32 timeout);
+
 /**
  * @brief       Flushes a fifo. The other end will unblock and return the
  *              (non-negative) #Dmai_EFLUSH error code.
@@ -139,12 +223,34 @@ extern Int Fifo_flush(Fifo_Handle hFifo);
  * @param[in]   ptr         The pointer to put to the fifo.
  *
  * @retval      Dmai_EOK for success.
+ * @retval      Dmai_EFLUSH if the fifo was flushed while waiting for a free
+ *              slot (#Fifo_Mode_RING only).
  * @retval      "Negative value" for failure, see Dmai.h.
  *
  * @remarks     #Fifo_create must be called before this function.
+ *
+ * @remarks     For #Fifo_Mode_RING only one thread may call this function
+ *              on a given fifo. The call blocks if the ring is full.
  */
 extern Int Fifo_put(Fifo_Handle hFifo, Ptr ptr);
 
+/**
+ * @brief       Put a burst of buffer pointers on the fifo in one operation.
+ *              The pointers are received in array order.
+ *
+ * @param[in]   hFifo       #Fifo_Handle to which to send the buffers.
+ * @param[in]   ptrs        Array of pointers to put to the fifo.
+ * @param[in]   numPtrs     Number of pointers in ptrs.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      Dmai_EFLUSH if the fifo was flushed while waiting for free
+ *              slots (#Fifo_Mode_RING only).
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     #Fifo_create must be called before this function.
+ */
+extern Int Fifo_putMany(Fifo_Handle hFifo, Ptr ptrs[], Int numPtrs);
+
 /**
  * @brief       Determine number of entries (pointers) currently in fifo.
  *
@@ -38,6 +38,7 @@
 #include <ti/sdo/dmai/Framecopy.h>
 #include <ti/sdo/dmai/ColorSpace.h>
 #include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/Time.h>
 
 #include "priv/_Framecopy.h"
 
@@ -208,6 +209,7 @@ static Int _execute(Framecopy_Handle hFc,
  ******************************************************************************/
 Framecopy_Handle Framecopy_create(Framecopy_Attrs *attrs)
 {
+    Time_Attrs       tAttrs = Time_Attrs_DEFAULT;
     Framecopy_Handle hFc;
 
     if (attrs == NULL) {
@@ -243,6 +245,13 @@ Framecopy_Handle Framecopy_create(Framecopy_Attrs *attrs)
     hFc->common.accel = attrs->accel;
     hFc->common.sdma = attrs->sdma;
 
+    /* Used to measure the throughput, copying works without it */
+    hFc->common.hTime = Time_create(&tAttrs);
+
+    if (hFc->common.hTime == NULL) {
+        Dmai_dbg0("Failed to create timer, throughput is not measured\n");
+    }
+
     return hFc;
 }
 
@@ -287,26 +296,58 @@ Int Framecopy_config(Framecopy_Handle hFc,
 Int Framecopy_execute(Framecopy_Handle hFc,
                       Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
+    UInt32 usecs;
+    Int    ret;
+
     assert(hFc);
     assert(hSrcBuf);
     assert(hDstBuf);
     assert(Buffer_getType(hSrcBuf) == Buffer_Type_GRAPHICS);
     assert(Buffer_getType(hDstBuf) == Buffer_Type_GRAPHICS);
 
+    if (hFc->common.hTime) {
+        Time_reset(hFc->common.hTime);
+    }
+
     if (hFc->common.accel) {
 #if defined(Dmai_Device_omap3530) || defined(Dmai_Device_dm3730)
         if (hFc->common.sdma) {
-            return Framecopy_sdma_accel_execute(hFc, hSrcBuf, hDstBuf);
+            ret = Framecopy_sdma_accel_execute(hFc, hSrcBuf, hDstBuf);
         }
         else {
-            return Framecopy_resizer_accel_execute(hFc, hSrcBuf, hDstBuf);
+            ret = Framecopy_resizer_accel_execute(hFc, hSrcBuf, hDstBuf);
         }
 #else
-        return Framecopy_accel_execute(hFc, hSrcBuf, hDstBuf);
+        ret = Framecopy_accel_execute(hFc, hSrcBuf, hDstBuf);
 #endif
     }
+    else {
+        ret = _execute(hFc, hSrcBuf, hDstBuf);
+    }
+
+    if (ret == Dmai_EOK && hFc->common.hTime &&
+        Time_delta(hFc->common.hTime, &usecs) == Dmai_EOK) {
 
-    return _execute(hFc, hSrcBuf, hDstBuf);
+        hFc->common.numBytes += Buffer_getNumBytesUsed(hDstBuf);
+        hFc->common.numUsecs += usecs;
+    }
+
+    return ret;
+}
+
+/******************************************************************************
+ * Framecopy_getThroughput
+ ******************************************************************************/
+Float Framecopy_getThroughput(Framecopy_Handle hFc)
+{
+    assert(hFc);
+
+    if (hFc->common.numUsecs == 0) {
+        return 0;
+    }
+
+    /* Bytes per microsecond are MB/s */
+    return (Float) (hFc->common.numBytes / hFc->common.numUsecs / 1000);
 }
 
 /******************************************************************************
@@ -317,6 +358,10 @@ Int Framecopy_delete(Framecopy_Handle hFc)
     Int ret = Dmai_EOK;
 
     if (hFc) {
+        if (hFc->common.hTime) {
+            Time_delete(hFc->common.hTime);
+        }
+
         if (hFc->common.accel) {
 #if defined(Dmai_Device_omap3530) || defined(Dmai_Device_dm3730)
             if (hFc->common.sdma) {
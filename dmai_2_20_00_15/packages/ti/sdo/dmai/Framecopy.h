@@ -86,7 +86,10 @@
  * @see         Framecopy_Attrs_DEFAULT.
  */
 typedef struct Framecopy_Attrs {
-    /** @brief TRUE if H/W acceleration is to be used */
+    /** @brief TRUE if H/W acceleration is to be used. On generic linux
+      *        large frames are instead copied in row bands by one thread
+      *        per CPU (up to 4), bypassing the cache for non-cached
+      *        destination buffers. */
     Int accel;
 
     /** @brief The rate of the resizer H/W to use.
@@ -165,6 +168,17 @@ extern Int Framecopy_config(Framecopy_Handle hFramecopy,
 extern Int Framecopy_execute(Framecopy_Handle hFramecopy,
                              Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf);
 
+/**
+ * @brief       Get the copy throughput achieved by a Framecopy job.
+ * @param[in]   hFramecopy  The #Framecopy_Handle of the job to query.
+ * @retval      The average throughput in GB/s of all successful executions,
+ *              measured from the start to the end of #Framecopy_execute
+ *              and counting the bytes written to the destination buffers.
+ * @retval      0 if no job has been executed yet.
+ * @remarks     #Framecopy_create must be called before this function.
+ */
+extern Float Framecopy_getThroughput(Framecopy_Handle hFramecopy);
+
 /**
  * @brief       Deletes a Framecopy job.
  *
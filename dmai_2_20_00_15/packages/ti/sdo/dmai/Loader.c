@@ -40,11 +40,16 @@
 
 /* Needed for Buffer_Memory_Params_DEFAULT_DEFINE */
 #include "priv/_Buffer.h"
+#include "priv/_Loader.h"
+#include "priv/_Bitstream.h"
 
 #include <ti/sdo/dmai/Loader.h>
 
 #define MODULE_NAME     "Loader"
 
+/* Initial number of entries in the frame index, doubled when full */
+#define INDEX_INITIAL_FRAMES    256
+
 /* These definitions missing in some OS build environments (eg: WinCE) */
 #ifndef _IOFBF
     #define _IOFBF  0
@@ -78,6 +83,18 @@ typedef struct Loader_Object {
     UInt32              vBufSize;
     Memory_AllocParams  mParams;
     Bool                started;
+    Loader_Mode         mode;
+    Bool                contiguous;
+    Int8               *map;        /* Start of the file mapping */
+    Int32               mapSize;
+    Int8               *stage;      /* Mapped data held in the staging buffer */
+    Int32               stageBytes;
+    Int32               readPos;    /* File offset of w */
+    Loader_Format       format;
+    Bool                index;
+    UInt32             *frames;     /* File offsets of the indexed frames */
+    Int                 numFrames;
+    Int                 maxFrames;
 } Loader_Object;
 
 const Loader_Attrs Loader_Attrs_DEFAULT = {
@@ -86,7 +103,11 @@ const Loader_Attrs Loader_Attrs_DEFAULT = {
     0,
     0,
     FALSE,
-    Buffer_Memory_Params_DEFAULT_DEFINE
+    Buffer_Memory_Params_DEFAULT_DEFINE,
+    Loader_Mode_READ,
+    TRUE,
+    Loader_Format_NONE,
+    FALSE
 };
 
 /******************************************************************************
@@ -102,6 +123,12 @@ static Int cleanup(Loader_Handle hLoader)
         }
     }
 
+    if (hLoader->map) {
+        if (_Loader_unmapFile(hLoader->map, hLoader->mapSize) < 0) {
+            ret = Dmai_EFAIL;
+        }
+    }
+
     if (hLoader->vBuf) {
         if (Memory_free(hLoader->vBuf,
                         hLoader->vBufSize, &hLoader->mParams) == FALSE) {
@@ -133,6 +160,10 @@ static Int cleanup(Loader_Handle hLoader)
         Sem_delete(hLoader->semRead);
     }
 
+    if (hLoader->frames) {
+        free(hLoader->frames);
+    }
+
     free(hLoader);
 
     return ret;
@@ -285,38 +316,276 @@ static inline Int stop(Loader_Handle hLoader)
 }
 
 /******************************************************************************
- * Loader_create
+ * classify
  ******************************************************************************/
-Loader_Handle Loader_create(Char *fileName, Loader_Attrs *attrs)
+static inline Void classify(Loader_Format format, UInt8 *ptr,
+                            Bool *frameStart, Bool *picture)
 {
-    Buffer_Attrs        bAttrs        = Buffer_Attrs_DEFAULT;
-    Loader_Handle       hLoader;
+    UInt8 code = ptr[3];
+
+    switch (format) {
+        case Loader_Format_H264:
+            code &= 0x1f;
+
+            /* Coded slices, new picture if first_mb_in_slice is 0 */
+            *picture = code >= 1 && code <= 5;
+            *frameStart = (*picture && (ptr[4] & 0x80)) ||
+                          (code >= 6 && code <= 9) ||
+                          (code >= 14 && code <= 18);
+            break;
+
+        case Loader_Format_MPEG4:
+            /* VO, VOL, VOS, GOV, VO and VOP start codes */
+            *picture = code == 0xb6;
+            *frameStart = *picture || code <= 0x2f || code == 0xb0 ||
+                          code == 0xb3 || code == 0xb5;
+            break;
+
+        case Loader_Format_MPEG2:
+            /* Sequence, GOP and picture start codes */
+            *picture = code == 0x00;
+            *frameStart = *picture || code == 0xb3 || code == 0xb8;
+            break;
+
+        default:
+            *picture = FALSE;
+            *frameStart = FALSE;
+            break;
+    }
+}
 
-    if (!fileName || !attrs || !attrs->readSize || !attrs->readBufSize) {
-        Dmai_err0("Must supply a file name and valid attributes\n");
-        return NULL;
+/******************************************************************************
+ * fileOffset
+ ******************************************************************************/
+static inline UInt32 fileOffset(Loader_Handle hLoader, Int8 *ptr)
+{
+    if (hLoader->mode == Loader_Mode_MMAP) {
+        return ptr - hLoader->map;
     }
- 
-    hLoader = (Loader_Handle)calloc(1, sizeof(Loader_Object));
 
-    if (hLoader == NULL) {
-        Dmai_err0("Failed to allocate Loader Object\n");
-        return NULL;
+    return hLoader->readPos - (hLoader->w - ptr);
+}
+
+/******************************************************************************
+ * indexFrame
+ ******************************************************************************/
+static Void indexFrame(Loader_Handle hLoader, UInt32 offset)
+{
+    UInt32 *frames;
+    Int     maxFrames;
+
+    /* Frames may be scanned more than once, only add new ones */
+    if (hLoader->numFrames &&
+        offset <= hLoader->frames[hLoader->numFrames - 1]) {
+        return;
     }
-    
-    bAttrs.memParams = attrs->mParams;
 
-    Dmai_dbg4("Creating Loader for %s with buffer size %d, window size %d, "
-        "alignment %d\n", fileName, attrs->readBufSize, 
-        attrs->readSize, attrs->mParams.align);
+    if (hLoader->numFrames == hLoader->maxFrames) {
+        maxFrames = hLoader->maxFrames ? hLoader->maxFrames * 2 :
+                                         INDEX_INITIAL_FRAMES;
+        frames = realloc(hLoader->frames, maxFrames * sizeof(UInt32));
+
+        if (frames == NULL) {
+            Dmai_err1("Failed to grow frame index to %d frames\n", maxFrames);
+            hLoader->index = FALSE;
+            return;
+        }
+
+        hLoader->frames = frames;
+        hLoader->maxFrames = maxFrames;
+    }
+
+    hLoader->frames[hLoader->numFrames++] = offset;
+}
+
+/******************************************************************************
+ * frameSize
+ ******************************************************************************/
+static Int32 frameSize(Loader_Handle hLoader, Int8 *start, Int32 numBytes)
+{
+    UInt8  *ptr     = (UInt8 *) start;
+    UInt8  *end     = ptr + numBytes;
+    Bool    picture = FALSE;
+    Bool    frameStart, isPicture;
+
+    if (numBytes < 5) {
+        return -1;
+    }
+
+    /* Unless the window starts on a start code, we are inside a frame */
+    while (ptr < end && *ptr == 0) {
+        ptr++;
+    }
+
+    if (ptr - (UInt8 *) start < 2 || ptr == end || *ptr != 1) {
+        picture = TRUE;
+    }
+
+    ptr = (UInt8 *) start;
+
+    /* Leave room to classify the start code found */
+    while ((ptr = _Bitstream_findStartCode(ptr, end - 2)) != NULL) {
+        classify(hLoader->format, ptr, &frameStart, &isPicture);
+
+        /* The next frame starts at the first header after picture data */
+        if (frameStart && picture) {
+            /* A 4 byte H.264 start code belongs to the next frame */
+            if (hLoader->format == Loader_Format_H264 &&
+                ptr > (UInt8 *) start && ptr[-1] == 0) {
+                ptr--;
+            }
+
+            if (hLoader->index) {
+                indexFrame(hLoader, fileOffset(hLoader, (Int8 *) ptr));
+            }
+
+            return (Int8 *) ptr - start;
+        }
+
+        picture = picture || isPicture;
+        ptr += 3;
+    }
+
+    return -1;
+}
+
+/******************************************************************************
+ * stageWindow
+ ******************************************************************************/
+static Int8 *stageWindow(Loader_Handle hLoader, Int8 *ptr, Int32 numBytes)
+{
+    Int8   *stageBuf = Buffer_getUserPtr(hLoader->hReadBuffer);
+    Int32   toCopy;
+
+    /* Refill the staging buffer only when the window has moved past it */
+    if (ptr < hLoader->stage ||
+        ptr + numBytes > hLoader->stage + hLoader->stageBytes) {
+
+        toCopy = hLoader->map + hLoader->mapSize - ptr;
+
+        if (toCopy > Buffer_getSize(hLoader->hReadBuffer)) {
+            toCopy = Buffer_getSize(hLoader->hReadBuffer);
+        }
+
+        memcpy(stageBuf, ptr, toCopy);
+
+        Buffer_setCpuDirty(hLoader->hReadBuffer, 0, toCopy);
+        Buffer_cacheWb(hLoader->hReadBuffer);
+
+        hLoader->stage = ptr;
+        hLoader->stageBytes = toCopy;
+    }
+
+    return stageBuf + (ptr - hLoader->stage);
+}
+
+/******************************************************************************
+ * setWindow
+ ******************************************************************************/
+static Void setWindow(Loader_Handle hLoader, Int32 delta)
+{
+    Int8   *ptr      = hLoader->r1;
+    Int32   numBytes = delta > hLoader->readSize ? hLoader->readSize : delta;
+    Int32   size;
+
+    /* Cut the window at the end of the frame if it can be found */
+    if (hLoader->format != Loader_Format_NONE) {
+        size = frameSize(hLoader, ptr, numBytes);
+
+        if (size > 0) {
+            numBytes = size;
+        }
+    }
+
+    if (hLoader->mode != Loader_Mode_MMAP) {
+        Buffer_setUserPtr(hLoader->hBuf, ptr);
+    }
+    else if (hLoader->contiguous) {
+        Buffer_setUserPtr(hLoader->hBuf, stageWindow(hLoader, ptr, numBytes));
+    }
+    else {
+        /* A window into the file mapping has no physical address */
+        _Buffer_setVirtualPtr(hLoader->hBuf, ptr);
+    }
+
+    Buffer_setSize(hLoader->hBuf, numBytes);
+    Buffer_setNumBytesUsed(hLoader->hBuf, numBytes);
+}
+
+/******************************************************************************
+ * mapData
+ ******************************************************************************/
+static Int mapData(Loader_Handle hLoader)
+{
+    Int delta, toRead;
+
+    delta = hLoader->w - hLoader->r1;
+
+    /* Do we need to read more data? */
+    if (delta < hLoader->readSize + hLoader->readAhead) {
+        toRead = hLoader->readSize + hLoader->readAhead - delta;
+
+        if (toRead > hLoader->map + hLoader->mapSize - hLoader->w) {
+            toRead = hLoader->map + hLoader->mapSize - hLoader->w;
+        }
+
+        /* Are we at the end of the file? */
+        if (toRead == 0) {
+            hLoader->end = TRUE;
+            unlock(hLoader);
+
+            doneReading(hLoader);
+
+            /* Stop the loader to allow repriming */
+            if (stop(hLoader) < 0) {
+                return Dmai_EFAIL;
+            }
+
+            return Dmai_EEOF;
+        }
+
+        /* The data is already mapped, only the kernel readahead is needed */
+        _Loader_prefetch(hLoader->w, toRead);
+
+        hLoader->w += toRead;
+
+        unlock(hLoader);
+        doneReading(hLoader);
+    }
+    else {
+        doneReading(hLoader);
+
+        /* Wait for the other thread to catch up in async mode */
+        wait(hLoader);
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * openFile
+ ******************************************************************************/
+static Int openFile(Loader_Handle hLoader, Char *fileName, Loader_Attrs *attrs)
+{
+    Int ret;
+
+    if (hLoader->mode == Loader_Mode_MMAP) {
+        ret = _Loader_mapFile(fileName, &hLoader->map, &hLoader->mapSize);
+
+        if (ret != Dmai_ENOTIMPL) {
+            return ret;
+        }
+
+        Dmai_dbg0("File can't be mapped, falling back to reading\n");
+        hLoader->mode = Loader_Mode_READ;
+    }
 
     /* Open the file for binary reading */
     hLoader->file = fopen(fileName, "rb");
 
     if (hLoader->file == NULL) {
         Dmai_err1("Failed to open %s\n", fileName);
-        cleanup(hLoader);
-        return NULL;
+        return Dmai_EIO;
     }
 
     /* Using a bigger input buffer for stdio enhances RTDX performance */
@@ -327,8 +596,7 @@ Loader_Handle Loader_create(Char *fileName, Loader_Attrs *attrs)
         if (hLoader->vBuf == NULL) {
             Dmai_err1("Failed to allocate memory (%d) for stdio buffer\n",
                       attrs->vBufSize);
-            cleanup(hLoader);
-            return NULL;
+            return Dmai_EFAIL;
         }
 
         hLoader->vBufSize = attrs->vBufSize;
@@ -338,25 +606,81 @@ Loader_Handle Loader_create(Char *fileName, Loader_Attrs *attrs)
 
             Dmai_err1("Failed setvbuf (%d) on file descriptor\n",
                       attrs->vBufSize);
-            cleanup(hLoader);
-            return NULL;
+            return Dmai_EFAIL;
         }
     }
 
-    /* Create the ring buffer which will hold the data */
-    hLoader->hReadBuffer = Buffer_create(attrs->readBufSize, &bAttrs);
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Loader_create
+ ******************************************************************************/
+Loader_Handle Loader_create(Char *fileName, Loader_Attrs *attrs)
+{
+    Buffer_Attrs        bAttrs        = Buffer_Attrs_DEFAULT;
+    Loader_Handle       hLoader;
+
+    if (!fileName || !attrs || !attrs->readSize || !attrs->readBufSize) {
+        Dmai_err0("Must supply a file name and valid attributes\n");
+        return NULL;
+    }
+ 
+    hLoader = (Loader_Handle)calloc(1, sizeof(Loader_Object));
 
-    if (hLoader->hReadBuffer == NULL) {
-        Dmai_err0("Failed to allocate ring buffer\n");
+    if (hLoader == NULL) {
+        Dmai_err0("Failed to allocate Loader Object\n");
+        return NULL;
+    }
+    
+    bAttrs.memParams = attrs->mParams;
+
+    Dmai_dbg4("Creating Loader for %s with buffer size %d, window size %d, "
+        "alignment %d\n", fileName, attrs->readBufSize, 
+        attrs->readSize, attrs->mParams.align);
+
+    if (attrs->format >= Loader_Format_COUNT) {
+        Dmai_err1("Unsupported stream format (%d)\n", attrs->format);
         cleanup(hLoader);
         return NULL;
     }
 
-    /* Invalidate the created pool in case it is cached */
-    if (hLoader->mParams.flags == Memory_CACHED)
-    {
-        Memory_cacheInv(Buffer_getUserPtr(hLoader->hReadBuffer), 
-            attrs->readBufSize);
+    hLoader->mode = attrs->mode;
+    hLoader->contiguous = attrs->contiguous;
+    hLoader->format = attrs->format;
+    hLoader->index = attrs->index && attrs->format != Loader_Format_NONE;
+
+    if (openFile(hLoader, fileName, attrs) < 0) {
+        cleanup(hLoader);
+        return NULL;
+    }
+
+    /* Windows of a mapped file are handed out directly unless staged */
+    if (hLoader->mode == Loader_Mode_READ || hLoader->contiguous) {
+        if (hLoader->mode == Loader_Mode_MMAP &&
+            attrs->readBufSize < attrs->readSize) {
+
+            Dmai_err0("Staging buffer must hold at least readSize bytes\n");
+            cleanup(hLoader);
+            return NULL;
+        }
+
+        /* Create the ring (or staging) buffer which will hold the data */
+        hLoader->hReadBuffer = Buffer_create(attrs->readBufSize, &bAttrs);
+
+        if (hLoader->hReadBuffer == NULL) {
+            Dmai_err0("Failed to allocate ring buffer\n");
+            cleanup(hLoader);
+            return NULL;
+        }
+
+        /*
+         * Invalidate the created pool in case it is cached. Buffer_cacheInv
+         * tests the buffer's own memParams, and only acts on device dirty
+         * buffers, which is what stale lines of a new pool amount to.
+         */
+        Buffer_setDeviceDirty(hLoader->hReadBuffer);
+        Buffer_cacheInv(hLoader->hReadBuffer);
     }
 
     bAttrs.reference = TRUE;
@@ -393,9 +717,9 @@ Loader_Handle Loader_create(Char *fileName, Loader_Attrs *attrs)
 }
 
 /******************************************************************************
- * Loader_prime
+ * primeAt
  ******************************************************************************/
-Int Loader_prime(Loader_Handle hLoader, Buffer_Handle *hBufPtr)
+static Int primeAt(Loader_Handle hLoader, UInt32 offset, Buffer_Handle *hBufPtr)
 {
     Buffer_Handle hReadBuffer = hLoader->hReadBuffer;
     Int numBytes;
@@ -414,34 +738,54 @@ Int Loader_prime(Loader_Handle hLoader, Buffer_Handle *hBufPtr)
         return Dmai_EFAIL;
     }
 
-    /* rewind replaced by fseek/clearerr combination which is more generic 
-     * and works under multiple OSes
-     */
-    fseek(hLoader->file, 0, SEEK_SET);
-    clearerr(hLoader->file);
+    if (hLoader->mode == Loader_Mode_MMAP) {
+        /* A full 'window' of encoded data is already mapped */
+        numBytes = hLoader->mapSize - offset;
 
-    /* Read a full 'window' of encoded data */
-    numBytes = fread(Buffer_getUserPtr(hReadBuffer), 1,
-                     hLoader->readSize, hLoader->file);
+        if (numBytes > hLoader->readSize) {
+            numBytes = hLoader->readSize;
+        }
 
-    /* Must be able to provide a full window to the app (codec) */
-    if (numBytes < hLoader->readSize && ferror(hLoader->file)) {
-        unlock(hLoader);
-        doneReading(hLoader);
-        Dmai_err0("Error reading data from video file\n");
-        return Dmai_EIO;
+        hLoader->r1 = hLoader->map + offset;
+        hLoader->stage = NULL;
+        hLoader->stageBytes = 0;
+
+        _Loader_prefetch(hLoader->r1, numBytes);
+    }
+    else {
+        /* rewind replaced by fseek/clearerr combination which is more generic 
+         * and works under multiple OSes
+         */
+        fseek(hLoader->file, offset, SEEK_SET);
+        clearerr(hLoader->file);
+
+        /* Read a full 'window' of encoded data */
+        numBytes = fread(Buffer_getUserPtr(hReadBuffer), 1,
+                         hLoader->readSize, hLoader->file);
+
+        /* Must be able to provide a full window to the app (codec) */
+        if (numBytes < hLoader->readSize && ferror(hLoader->file)) {
+            unlock(hLoader);
+            doneReading(hLoader);
+            Dmai_err0("Error reading data from video file\n");
+            return Dmai_EIO;
+        }
+
+        hLoader->r1 = Buffer_getUserPtr(hReadBuffer);
+        hLoader->readPos = offset + numBytes;
     }
 
     /* Initialize state */
-    hLoader->r1 = Buffer_getUserPtr(hReadBuffer);
-    hLoader->r2 = Buffer_getUserPtr(hReadBuffer) + numBytes;
+    hLoader->r2 = hLoader->r1 + numBytes;
     hLoader->w = hLoader->r2;
 
+    if (hLoader->index && numBytes > 0) {
+        indexFrame(hLoader, offset);
+    }
+
     *hBufPtr = hLoader->hBuf;
 
-    Buffer_setUserPtr(*hBufPtr, hLoader->r1);
-    Buffer_setSize(*hBufPtr, numBytes);
-    Buffer_setNumBytesUsed(*hBufPtr, numBytes);
+    setWindow(hLoader, numBytes);
 
     hLoader->end = FALSE;
 
@@ -452,11 +796,10 @@ Int Loader_prime(Loader_Handle hLoader, Buffer_Handle *hBufPtr)
         return Dmai_EEOF;
     }
 
-    /* After Priming, WB if the pool is CACHED */
-    if (hLoader->mParams.flags == Memory_CACHED)
-    {
-        Memory_cacheWb(Buffer_getUserPtr(hReadBuffer), 
-            hLoader->readSize);
+    /* After Priming, WB the window if the pool is CACHED */
+    if (hLoader->mode == Loader_Mode_READ) {
+        Buffer_setCpuDirty(hReadBuffer, 0, numBytes);
+        Buffer_cacheWb(hReadBuffer);
     }
 
     /* Are we at the end of the file? */
@@ -484,6 +827,40 @@ Int Loader_prime(Loader_Handle hLoader, Buffer_Handle *hBufPtr)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * Loader_prime
+ ******************************************************************************/
+Int Loader_prime(Loader_Handle hLoader, Buffer_Handle *hBufPtr)
+{
+    return primeAt(hLoader, 0, hBufPtr);
+}
+
+/******************************************************************************
+ * Loader_seek
+ ******************************************************************************/
+Int Loader_seek(Loader_Handle hLoader, Int frame, Buffer_Handle *hBufPtr)
+{
+    assert(hLoader);
+    assert(hBufPtr);
+
+    if (!hLoader->index || frame < 0 || frame >= hLoader->numFrames) {
+        Dmai_err1("Frame %d has not been indexed\n", frame);
+        return Dmai_EINVAL;
+    }
+
+    return primeAt(hLoader, hLoader->frames[frame], hBufPtr);
+}
+
+/******************************************************************************
+ * Loader_getNumFrames
+ ******************************************************************************/
+Int Loader_getNumFrames(Loader_Handle hLoader)
+{
+    assert(hLoader);
+
+    return hLoader->numFrames;
+}
+
 /******************************************************************************
  * Loader_readData
  ******************************************************************************/
@@ -512,6 +889,11 @@ Int Loader_readData(Loader_Handle hLoader)
         return Dmai_EFAIL;
     }
 
+    /* A mapped file needs no copying, and so never wraps */
+    if (hLoader->mode == Loader_Mode_MMAP) {
+        return mapData(hLoader);
+    }
+
     ringBufferEnd = (UInt32) Buffer_getUserPtr(hLoader->hReadBuffer) +
                     (UInt32) Buffer_getSize(hLoader->hReadBuffer);
 
@@ -537,12 +919,8 @@ Int Loader_readData(Loader_Handle hLoader)
             unlock(hLoader);
             memcpy(Buffer_getUserPtr(hLoader->hReadBuffer), ptr, delta);
 
-            /* After Copying, WB if the pool is CACHED */
-            if (hLoader->mParams.flags == Memory_CACHED)
-            {
-                Memory_cacheWb(Buffer_getUserPtr(hLoader->hReadBuffer), 
-                    delta);
-            }
+            /* Written back together with the data read below */
+            Buffer_setCpuDirty(hLoader->hReadBuffer, 0, delta);
 
             /* Reacquire lock and compensate for intermediate processing */
             if (lock(hLoader) < 0) {
@@ -570,12 +948,13 @@ Int Loader_readData(Loader_Handle hLoader)
         }
 
         /* After Reading, WB if the pool is CACHED */
-        if (hLoader->mParams.flags == Memory_CACHED)
-        {
-            Memory_cacheWb(hLoader->w, toRead);
-        }
+        Buffer_setCpuDirty(hLoader->hReadBuffer,
+                           hLoader->w - Buffer_getUserPtr(hLoader->hReadBuffer),
+                           numBytes);
+        Buffer_cacheWb(hLoader->hReadBuffer);
 
         hLoader->w += numBytes;
+        hLoader->readPos += numBytes;
 
         /* Are we at the end of the file? */
         if (numBytes == 0) {
@@ -653,15 +1032,7 @@ Int Loader_getFrame(Loader_Handle hLoader, Buffer_Handle hBuf)
     }
     else {
         /* Return new pointers to the next frame */
-        Buffer_setUserPtr(hBuf, hLoader->r1);
-        if (delta > hLoader->readSize) {
-            Buffer_setSize(hBuf, hLoader->readSize);
-            Buffer_setNumBytesUsed(hBuf, hLoader->readSize);
-        }
-        else {
-            Buffer_setSize(hBuf, delta);
-            Buffer_setNumBytesUsed(hBuf, delta);
-        }
+        setWindow(hLoader, delta);
     }
 
     /* Make sure other thread wakes up and tries reading again in async mode */
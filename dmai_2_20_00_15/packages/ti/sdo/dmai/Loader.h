@@ -71,6 +71,43 @@
 /** @ingroup    ti_sdo_dmai_Loader */
 /*@{*/
 
+/**
+ * @brief Ways for the Loader to get data from the file.
+ */
+typedef enum {
+    /** @brief Read the file with stdio in to a ring buffer */
+    Loader_Mode_READ = 0,
+
+    /**
+     * @brief Map the file in to memory and hand out windows of the mapping
+     * directly, leaving readahead to the kernel. Falls back to
+     * #Loader_Mode_READ on platforms which can't map files, and for files
+     * of 2 GB or more.
+     */
+    Loader_Mode_MMAP,
+
+    Loader_Mode_COUNT
+} Loader_Mode;
+
+/**
+ * @brief Elementary stream formats the Loader can split in to frames.
+ */
+typedef enum {
+    /** @brief Don't split, hand out windows of readSize bytes */
+    Loader_Format_NONE = 0,
+
+    /** @brief H.264 Annex B byte stream */
+    Loader_Format_H264,
+
+    /** @brief MPEG-4 part 2 video elementary stream */
+    Loader_Format_MPEG4,
+
+    /** @brief MPEG-2 video elementary stream */
+    Loader_Format_MPEG2,
+
+    Loader_Format_COUNT
+} Loader_Format;
+
 /**
  * @brief Attributes used to create a Loader.
  * @see Loader_Attrs_DEFAULT.
@@ -114,7 +151,37 @@ typedef struct Loader_Attrs {
       * of the Loader.
       */                
     Memory_AllocParams  mParams;
-    
+
+    /**
+      * @brief How the file is read, see #Loader_Mode.
+      */
+    Loader_Mode         mode;
+
+    /**
+      * @brief Set to TRUE if the data returned needs to be in physically
+      * contiguous memory, e.g. when it is passed to a hardware or DSP
+      * codec. In #Loader_Mode_MMAP mode windows are then copied from the
+      * mapping to a staging buffer of readBufSize bytes, refilled only when
+      * the window moves past its end. When FALSE, windows point directly in
+      * to the mapping and no data is copied. Ignored in #Loader_Mode_READ
+      * mode, where the ring buffer is always contiguous.
+      */
+    Bool                contiguous;
+
+    /**
+      * @brief Format of the elementary stream. When set, #Loader_getFrame
+      * returns exactly one access unit (frame) instead of a full window,
+      * as long as the frame fits in readSize bytes.
+      */
+    Loader_Format       format;
+
+    /**
+      * @brief When set to TRUE, and a format is set, the file offset of each
+      * frame is recorded as it is loaded so that the stream can be
+      * restarted from any of those frames using #Loader_seek.
+      */
+    Bool                index;
+
 } Loader_Attrs;
 
 /**
@@ -125,6 +192,11 @@ typedef struct Loader_Attrs {
  *     readAhead        = 0
  *     vBufSize         = 0
  *     async            = FALSE
+ *     mParams          = Buffer_Memory_Params_DEFAULT
+ *     mode             = Loader_Mode_READ
+ *     contiguous       = TRUE
+ *     format           = Loader_Format_NONE
+ *     index            = FALSE
  * @endcode
  */
 extern const Loader_Attrs Loader_Attrs_DEFAULT;
@@ -179,6 +251,8 @@ extern Int Loader_prime(Loader_Handle hLoader, Buffer_Handle *hBufPtr);
  * @remarks     #Loader_create must be called before this function.
  * @remarks     This function should @b not be used in synchronous mode
  *              (see #Loader_Attrs.async).
+ * @remarks     In #Loader_Mode_MMAP mode no data is copied, this function
+ *              only asks the kernel to read ahead of the window.
  */
 extern Int Loader_readData(Loader_Handle hLoader);
 
@@ -201,9 +275,46 @@ extern Int Loader_readData(Loader_Handle hLoader);
  *
  * @remarks     #Loader_create must be called before this function.
  * @remarks     #Loader_prime must be called before this function.
+ * @remarks     When #Loader_Attrs.format is set, the buffer ends where the
+ *              next frame starts, so a decoder consuming the whole frame
+ *              gets the next frame aligned at the start of the buffer.
  */
 extern Int Loader_getFrame(Loader_Handle hLoader, Buffer_Handle hBuf);
 
+/**
+ * @brief       Restart loading at a previously loaded frame, and obtain it.
+ *
+ * @param[in]   hLoader     The #Loader_Handle to seek in.
+ * @param[in]   frame       Index of the frame to restart at, counting the
+ *                          first frame of the file as 0.
+ * @param[out]  hBufPtr     The buffer containing the encoded frame
+ *                          will be returned in this #Buffer_Handle.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      Dmai_EEOF if the rest of the file fits in the window.
+ * @retval      Dmai_EINVAL if the frame has not been indexed.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     #Loader_create must be called with #Loader_Attrs.index set
+ *              before this function.
+ * @remarks     Only frames already returned by #Loader_getFrame are indexed,
+ *              see #Loader_getNumFrames. It is up to the caller to pick a
+ *              frame the decoder can start from, e.g. frame 0 to loop.
+ */
+extern Int Loader_seek(Loader_Handle hLoader, Int frame,
+                       Buffer_Handle *hBufPtr);
+
+/**
+ * @brief       Get the number of frames indexed so far.
+ *
+ * @param[in]   hLoader     The #Loader_Handle to query.
+ *
+ * @retval      Number of frames which can be passed to #Loader_seek.
+ *
+ * @remarks     #Loader_create must be called before this function.
+ */
+extern Int Loader_getNumFrames(Loader_Handle hLoader);
+
 /**
  * @brief       Tells the thread calling #Loader_readData that it should quit.
  *              If the Loader is not used in async mode this call has no
@@ -0,0 +1,414 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+#include <string.h>
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/Loader.h>
+#include <ti/sdo/dmai/Probe.h>
+
+#include "priv/_Bitstream.h"
+
+#define MODULE_NAME     "Probe"
+
+/* Bit reader over the payload of a start code */
+typedef struct BitReader {
+    UInt8              *ptr;
+    UInt8              *end;
+    UInt32              byte;       /* Byte currently being read */
+    Int                 bitsLeft;   /* Bits left in byte */
+    Int                 zeros;      /* Consecutive zero bytes read */
+    Bool                epb;        /* Remove H.264 emulation prevention */
+    Bool                overrun;
+} BitReader;
+
+/******************************************************************************
+ * initBits
+ ******************************************************************************/
+static Void initBits(BitReader *br, UInt8 *ptr, UInt8 *end, Bool epb)
+{
+    memset(br, 0, sizeof(BitReader));
+
+    br->ptr = ptr;
+    br->end = end;
+    br->epb = epb;
+}
+
+/******************************************************************************
+ * getBit
+ ******************************************************************************/
+static UInt32 getBit(BitReader *br)
+{
+    if (br->bitsLeft == 0) {
+        /* Skip the 0x03 in 0x000003 in an H.264 NAL unit */
+        if (br->epb && br->zeros >= 2 && br->ptr < br->end &&
+            *br->ptr == 0x03) {
+
+            br->ptr++;
+            br->zeros = 0;
+        }
+
+        if (br->ptr >= br->end) {
+            br->overrun = TRUE;
+            return 0;
+        }
+
+        br->byte = *br->ptr++;
+        br->zeros = br->byte ? 0 : br->zeros + 1;
+        br->bitsLeft = 8;
+    }
+
+    br->bitsLeft--;
+
+    return (br->byte >> br->bitsLeft) & 1;
+}
+
+/******************************************************************************
+ * getBits
+ ******************************************************************************/
+static UInt32 getBits(BitReader *br, Int numBits)
+{
+    UInt32 val = 0;
+
+    while (numBits--) {
+        val = (val << 1) | getBit(br);
+    }
+
+    return val;
+}
+
+/******************************************************************************
+ * getUe
+ ******************************************************************************/
+static UInt32 getUe(BitReader *br)
+{
+    Int leadingZeros = 0;
+
+    while (getBit(br) == 0) {
+        if (br->overrun || ++leadingZeros > 31) {
+            br->overrun = TRUE;
+            return 0;
+        }
+    }
+
+    return ((UInt32) 1 << leadingZeros) - 1 + getBits(br, leadingZeros);
+}
+
+/******************************************************************************
+ * getSe
+ ******************************************************************************/
+static Int32 getSe(BitReader *br)
+{
+    UInt32 val = getUe(br);
+
+    return val & 1 ? (Int32) ((val + 1) / 2) : -(Int32) (val / 2);
+}
+
+/******************************************************************************
+ * skipScalingList
+ ******************************************************************************/
+static Void skipScalingList(BitReader *br, Int size)
+{
+    Int lastScale = 8;
+    Int nextScale = 8;
+    Int i;
+
+    for (i = 0; i < size; i++) {
+        if (nextScale != 0) {
+            nextScale = (lastScale + getSe(br) + 256) % 256;
+        }
+
+        lastScale = nextScale == 0 ? lastScale : nextScale;
+    }
+}
+
+/******************************************************************************
+ * parseSps
+ ******************************************************************************/
+static Int parseSps(BitReader *br, BufferGfx_Dimensions *dim)
+{
+    UInt32 profileIdc, chromaFormatIdc = 1, pocType, numCycle, cycle;
+    UInt32 widthMbs, heightMapUnits, frameMbsOnly;
+    UInt32 cropLeft = 0, cropRight = 0, cropTop = 0, cropBottom = 0;
+    Int    cropUnitX, cropUnitY, i;
+
+    profileIdc = getBits(br, 8);
+    getBits(br, 16);                            /* constraints, level_idc */
+    getUe(br);                                  /* seq_parameter_set_id */
+
+    /* The high profiles carry the chroma format and scaling matrices */
+    if (profileIdc == 100 || profileIdc == 110 || profileIdc == 122 ||
+        profileIdc == 244 || profileIdc == 44  || profileIdc == 83  ||
+        profileIdc == 86  || profileIdc == 118 || profileIdc == 128) {
+
+        chromaFormatIdc = getUe(br);
+
+        if (chromaFormatIdc == 3) {
+            getBit(br);                         /* separate_colour_plane */
+        }
+
+        getUe(br);                              /* bit_depth_luma_minus8 */
+        getUe(br);                              /* bit_depth_chroma_minus8 */
+        getBit(br);                             /* qpprime_y_zero_bypass */
+
+        if (getBit(br)) {                       /* seq_scaling_matrix */
+            for (i = 0; i < (chromaFormatIdc != 3 ? 8 : 12); i++) {
+                if (getBit(br)) {
+                    skipScalingList(br, i < 6 ? 16 : 64);
+                }
+            }
+        }
+    }
+
+    getUe(br);                                  /* log2_max_frame_num */
+    pocType = getUe(br);
+
+    if (pocType == 0) {
+        getUe(br);                              /* log2_max_poc_lsb */
+    }
+    else if (pocType == 1) {
+        getBit(br);                             /* delta_pic_order_zero */
+        getSe(br);                              /* offset_for_non_ref_pic */
+        getSe(br);                              /* offset_for_top_to_bottom */
+        numCycle = getUe(br);
+
+        for (cycle = 0; cycle < numCycle && !br->overrun; cycle++) {
+            getSe(br);                          /* offset_for_ref_frame */
+        }
+    }
+
+    getUe(br);                                  /* max_num_ref_frames */
+    getBit(br);                                 /* gaps_in_frame_num */
+
+    widthMbs = getUe(br) + 1;
+    heightMapUnits = getUe(br) + 1;
+    frameMbsOnly = getBit(br);
+
+    if (!frameMbsOnly) {
+        getBit(br);                             /* mb_adaptive_frame_field */
+    }
+
+    getBit(br);                                 /* direct_8x8_inference */
+
+    if (getBit(br)) {                           /* frame_cropping_flag */
+        cropLeft = getUe(br);
+        cropRight = getUe(br);
+        cropTop = getUe(br);
+        cropBottom = getUe(br);
+    }
+
+    if (br->overrun) {
+        return Dmai_EINVAL;
+    }
+
+    /* Cropping is in chroma sample units, and per field for interlaced */
+    cropUnitX = chromaFormatIdc == 1 || chromaFormatIdc == 2 ? 2 : 1;
+    cropUnitY = (chromaFormatIdc == 1 ? 2 : 1) * (2 - frameMbsOnly);
+
+    dim->width = widthMbs * 16 - cropUnitX * (cropLeft + cropRight);
+    dim->height = (2 - frameMbsOnly) * heightMapUnits * 16 -
+                  cropUnitY * (cropTop + cropBottom);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * parseVol
+ ******************************************************************************/
+static Int parseVol(BitReader *br, BufferGfx_Dimensions *dim)
+{
+    UInt32 verid = 1, shape, resolution;
+    Int    numBits;
+
+    getBit(br);                                 /* random_accessible_vol */
+    getBits(br, 8);                             /* video_object_type */
+
+    if (getBit(br)) {                           /* is_object_layer_id */
+        verid = getBits(br, 4);
+        getBits(br, 3);                         /* priority */
+    }
+
+    if (getBits(br, 4) == 15) {                 /* aspect_ratio_info */
+        getBits(br, 16);                        /* par_width, par_height */
+    }
+
+    if (getBit(br)) {                           /* vol_control_parameters */
+        getBits(br, 3);                         /* chroma_format, low_delay */
+
+        if (getBit(br)) {                       /* vbv_parameters */
+            getBits(br, 32);                    /* bit_rate */
+            getBits(br, 16);                    /* vbv_buffer_size */
+            getBits(br, 15);                    /* ..and vbv_occupancy */
+            getBits(br, 16);                    /* vbv_occupancy */
+        }
+    }
+
+    shape = getBits(br, 2);
+
+    if (shape == 3 && verid != 1) {
+        getBits(br, 4);                         /* shape_extension */
+    }
+
+    getBit(br);                                 /* marker */
+    resolution = getBits(br, 16);               /* vop_time_increment_res */
+    getBit(br);                                 /* marker */
+
+    if (getBit(br)) {                           /* fixed_vop_rate */
+        for (numBits = 1; ((UInt32) 1 << numBits) < resolution; numBits++);
+
+        getBits(br, numBits);                   /* fixed_vop_time_increment */
+    }
+
+    /* Only rectangular video objects have their size in the VOL */
+    if (shape != 0) {
+        Dmai_dbg1("Unsupported MPEG-4 video object layer shape %d\n", shape);
+        return Dmai_EINVAL;
+    }
+
+    getBit(br);                                 /* marker */
+    dim->width = getBits(br, 13);
+    getBit(br);                                 /* marker */
+    dim->height = getBits(br, 13);
+
+    return br->overrun ? Dmai_EINVAL : Dmai_EOK;
+}
+
+/******************************************************************************
+ * parseSequence
+ ******************************************************************************/
+static Int parseSequence(BitReader *br, UInt8 *end, BufferGfx_Dimensions *dim)
+{
+    UInt8 *ptr;
+
+    dim->width = getBits(br, 12);
+    dim->height = getBits(br, 12);
+
+    if (br->overrun) {
+        return Dmai_EINVAL;
+    }
+
+    /* An MPEG-2 sequence extension holds the 2 upper bits of the size */
+    ptr = br->ptr;
+
+    while ((ptr = _Bitstream_findStartCode(ptr, end - 2)) != NULL) {
+        if (ptr[3] == 0xb5 && ptr[4] >> 4 == 1) {
+            initBits(br, ptr + 4, end, FALSE);
+
+            getBits(br, 4 + 8 + 1 + 2);         /* id, profile, prog, chroma */
+            dim->width |= getBits(br, 2) << 12;
+            dim->height |= getBits(br, 2) << 12;
+            break;
+        }
+
+        /* The extension directly follows the sequence header, if present */
+        if (ptr[3] != 0xb2) {
+            break;
+        }
+
+        ptr += 3;
+    }
+
+    return br->overrun ? Dmai_EINVAL : Dmai_EOK;
+}
+
+/******************************************************************************
+ * Probe_getDimensions
+ ******************************************************************************/
+Int Probe_getDimensions(Loader_Format format, Buffer_Handle hBuf,
+                        BufferGfx_Dimensions *dim)
+{
+    UInt8      *ptr, *end;
+    BitReader   br;
+    Int         ret;
+
+    assert(hBuf);
+    assert(dim);
+
+    if (format == Loader_Format_NONE || format >= Loader_Format_COUNT) {
+        Dmai_err1("Can't probe stream format %d\n", format);
+        return Dmai_ENOTIMPL;
+    }
+
+    ptr = (UInt8 *) Buffer_getUserPtr(hBuf);
+    end = ptr + Buffer_getNumBytesUsed(hBuf);
+
+    if (ptr == NULL || end - ptr < 4) {
+        return Dmai_EINVAL;
+    }
+
+    memset(dim, 0, sizeof(BufferGfx_Dimensions));
+
+    while ((ptr = _Bitstream_findStartCode(ptr, end - 1)) != NULL) {
+        ret = Dmai_EINVAL;
+
+        switch (format) {
+            case Loader_Format_H264:
+                if ((ptr[3] & 0x1f) == 7) {
+                    initBits(&br, ptr + 4, end, TRUE);
+                    ret = parseSps(&br, dim);
+                }
+                break;
+
+            case Loader_Format_MPEG4:
+                if (ptr[3] >= 0x20 && ptr[3] <= 0x2f) {
+                    initBits(&br, ptr + 4, end, FALSE);
+                    ret = parseVol(&br, dim);
+                }
+                break;
+
+            case Loader_Format_MPEG2:
+                if (ptr[3] == 0xb3) {
+                    initBits(&br, ptr + 4, end, FALSE);
+                    ret = parseSequence(&br, end, dim);
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        if (ret == Dmai_EOK && dim->width > 0 && dim->height > 0) {
+            Dmai_dbg2("Probed clip dimensions %dx%d\n",
+                      (Int) dim->width, (Int) dim->height);
+            return Dmai_EOK;
+        }
+
+        ptr += 3;
+    }
+
+    Dmai_dbg0("No sequence header found\n");
+
+    return Dmai_EINVAL;
+}
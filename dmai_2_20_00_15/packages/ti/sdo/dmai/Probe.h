@@ -0,0 +1,102 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+/**
+ * @defgroup   ti_sdo_dmai_Probe    Probe
+ *
+ * @brief Parses the sequence headers of an elementary video stream to find
+ *        the dimensions of the clip without decoding it. It has no state,
+ *        so no creation of an instance is required. Typical usage
+ *        (H.264, no error checking):
+ *
+ * @code
+ *   #include <xdc/std.h>
+ *   #include <ti/sdo/dmai/Dmai.h>
+ *   #include <ti/sdo/dmai/Loader.h>
+ *   #include <ti/sdo/dmai/Probe.h>
+ *   Loader_Attrs lAttrs = Loader_Attrs_DEFAULT;
+ *   BufferGfx_Dimensions dim;
+ *   Loader_Handle hLoader;
+ *   Buffer_Handle hBuf;
+ *
+ *   Dmai_init();
+ *   hLoader = Loader_create("myfile.264", &lAttrs);
+ *   Loader_prime(hLoader, &hBuf);
+ *   Probe_getDimensions(Loader_Format_H264, hBuf, &dim);
+ *   // Create the decoder and its output buffers for dim.width x dim.height
+ * @endcode
+ */
+
+#ifndef ti_sdo_dmai_Probe_h_
+#define ti_sdo_dmai_Probe_h_
+
+#include <xdc/std.h>
+
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/Loader.h>
+
+/** @ingroup    ti_sdo_dmai_Probe */
+/*@{*/
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * @brief       Finds the dimensions of a clip from its sequence header.
+ *
+ * @param[in]   format      The #Loader_Format of the elementary stream. The
+ *                          H.264 SPS, MPEG-4 VOL and MPEG-2 sequence header
+ *                          (and sequence extension) are parsed.
+ * @param[in]   hBuf        The #Buffer_Handle of a buffer holding the start
+ *                          of the stream, #Buffer_getNumBytesUsed bytes are
+ *                          searched for the header.
+ * @param[out]  dim         The displayed width and height of the clip are
+ *                          returned here, with cropping applied. x, y and
+ *                          lineLength are set to 0.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      Dmai_EINVAL if no supported header was found.
+ * @retval      Dmai_ENOTIMPL if the format can't be probed.
+ */
+extern Int Probe_getDimensions(Loader_Format format, Buffer_Handle hBuf,
+                               BufferGfx_Dimensions *dim);
+
+#if defined (__cplusplus)
+}
+#endif
+
+/*@}*/
+
+#endif /* ti_sdo_dmai_Probe_h_ */
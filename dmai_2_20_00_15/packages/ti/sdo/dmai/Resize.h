@@ -194,6 +194,11 @@ extern Resize_Handle Resize_create(Resize_Attrs *attrs);
  * @retval      "Negative value" for failure, see Dmai.h.
  *
  * @remarks     #Resize_create must be called before this function.
+ * @remarks     On Linux devices without a resizer peripheral the resize is
+ *              done by the CPU using a bilinear filter (an area filter when
+ *              down-scaling). Source and destination must have the same
+ *              color space, one of #ColorSpace_YUV420PSEMI,
+ *              #ColorSpace_YUV422PSEMI or #ColorSpace_UYVY.
  */
 extern Int Resize_config(Resize_Handle hResize,
                          Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf);
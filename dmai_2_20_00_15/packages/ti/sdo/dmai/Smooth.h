@@ -80,6 +80,23 @@
 /** @ingroup    ti_sdo_dmai_Smooth */
 /*@{*/
 
+/**
+ * @brief Deinterlacing methods of the software implementation. The even
+ *        lines (the top field) are kept and the odd lines are replaced.
+ * @remarks Only applicable to generic linux.
+ */
+typedef enum {
+    /** @brief Edge-directed line averaging (ELA) along the best of three
+     *         directions */
+    Smooth_Mode_ELA = 0,
+
+    /** @brief Odd lines are the average of the lines above and below */
+    Smooth_Mode_BOB,
+
+    /** @brief The fields are left woven together, the frame is copied */
+    Smooth_Mode_WEAVE
+} Smooth_Mode;
+
 /**
  * @brief Handle through which to reference a Smooth job.
  */
@@ -93,12 +110,23 @@ typedef struct Smooth_Attrs {
     /** @brief The rate of the resizer H/W to use.
       * @remarks Only applicable to DM6446 */
     Int rszRate;
+
+    /** @brief The deinterlacing method to use.
+      * @remarks Only applicable to generic linux */
+    Smooth_Mode mode;
+
+    /** @brief The number of threads splitting the frame in to row bands.
+      *        0 or 1 processes the frame in the calling thread only.
+      * @remarks Only applicable to generic linux */
+    Int numThreads;
 } Smooth_Attrs;
 
 /**
  * @brief Default attributes for a Smooth job.
  * @code
- *    rszRate   = 0xe
+ *    rszRate    = 0xe,
+ *    mode       = Smooth_Mode_ELA,
+ *    numThreads = 1
  * @endcode
  */
 extern const Smooth_Attrs Smooth_Attrs_DEFAULT;
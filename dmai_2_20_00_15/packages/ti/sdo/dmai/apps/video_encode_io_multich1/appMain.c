@@ -32,7 +32,8 @@
 /*
  * This application encodes multiple channels of video data from files, one 
  * channel per application thread, and stores the encoded files to the
- * file system.
+ * file system. With --batch, all channels are encoded from a single thread
+ * with Venc1_processMulti instead.
  */
 
 #include <stdio.h>
@@ -81,6 +82,11 @@ Int readFrameUYVY(Buffer_Handle hBuf, FILE *outFile)
 
     for (y = 0; y < dim.height; y++) {
         if (fread(ptr, dim.width * 2, 1, outFile) != 1) {
+            /* Running out between two frames is the normal end of input */
+            if (y == 0 && feof(outFile)) {
+                return Dmai_EEOF;
+            }
+
             printf("Failed to read data from file\n");
             return -1;
         }
@@ -161,12 +167,16 @@ Void *encodeThrFxn(Void *thrArgs)
     Time_Handle            hTime          = NULL;
     Buffer_Handle          hOutBuf        = NULL;
     Buffer_Handle          hInBuf         = NULL;
+    Void                  *ret            = THREAD_FAILURE;
     Int                    numFrame       = 0;
     Char*                  inFilenameThr  = NULL;
     Char*                  outFilenameThr = NULL;
     Int                    inBufSize, outBufSize;
     ColorSpace_Type        colorSpace;
     UInt32                 time;
+    Int                    status;
+
+    args->numEncoded = 0;
 
     if (args->benchmark) {
         hTime = Time_create(&tAttrs);
@@ -269,7 +279,16 @@ Void *encodeThrFxn(Void *thrArgs)
 
     while (numFrame++ < args->numFrames) {
         /* Get a new input frame */
-        if (readFrameUYVY(hInBuf, inFile) < 0) {
+        status = readFrameUYVY(hInBuf, inFile);
+
+        if (status == Dmai_EEOF) {
+            printf("Input of channel %d ended after %d frames\n", args->thrId,
+                   args->numEncoded);
+            ret = THREAD_SUCCESS;
+            goto cleanup;
+        }
+
+        if (status < 0) {
             goto cleanup;
         }
 
@@ -349,8 +368,12 @@ Void *encodeThrFxn(Void *thrArgs)
 
             printf("Total: %uus\n", (unsigned int)time);
         }
+
+        args->numEncoded++;
     }
 
+    ret = THREAD_SUCCESS;
+
 cleanup:
     /* Clean up the thread */
     if (hOutBuf) {
@@ -389,27 +412,311 @@ cleanup:
         free(outFilenameThr);
     }
 
-    return 0;
+    return ret;
 }
 
 
+/* Per channel state of the batch encoder */
+typedef struct Channel {
+    Venc1_Handle           hVe1;
+    FILE                  *inFile;
+    FILE                  *outFile;
+    Buffer_Handle          hInBuf;
+    Buffer_Handle          hOutBuf;
+} Channel;
+
+/******************************************************************************
+ * batchEncode
+ *    Encodes all channels from the calling thread, one Venc1_processMulti
+ *    call per frame, until numFrames frames are encoded or an input file
+ *    ends. The number of frames encoded is returned in numEncoded.
+ ******************************************************************************/
+Void *batchEncode(Args *args, Int *numEncoded)
+{
+    VIDENC1_Params         params         = Venc1_Params_DEFAULT;
+    VIDENC1_DynamicParams  dynParams      = Venc1_DynamicParams_DEFAULT;
+    BufferGfx_Attrs        gfxAttrs       = BufferGfx_Attrs_DEFAULT;
+    Time_Attrs             tAttrs         = Time_Attrs_DEFAULT;
+    Engine_Handle          hEngine        = NULL;
+    Time_Handle            hTime          = NULL;
+    Channel               *channels       = NULL;
+    Venc1_Job             *jobs           = NULL;
+    Void                  *ret            = THREAD_FAILURE;
+    Int                    numFrame       = 0;
+    Char                  *filename;
+    Int                    inBufSize, outBufSize;
+    Int                    chId;
+    Channel               *ch;
+    UInt32                 time;
+    Int                    status;
+
+    *numEncoded = 0;
+
+    if (args->benchmark) {
+        hTime = Time_create(&tAttrs);
+
+        if (hTime == NULL) {
+            printf("Failed to create Time object\n");
+            goto cleanup;
+        }
+    }
+
+    channels = calloc(args->numThreads, sizeof(Channel));
+    jobs = calloc(args->numThreads, sizeof(Venc1_Job));
+
+    if (channels == NULL || jobs == NULL) {
+        printf("Failed to allocate channel information records\n");
+        goto cleanup;
+    }
+
+    /* All channels share one codec engine instance */
+    hEngine = Engine_open(args->engineName, NULL, NULL);
+
+    if (hEngine == NULL) {
+        printf("Failed to open codec engine: %s\n", args->engineName);
+        goto cleanup;
+    }
+
+    params.maxWidth = args->width;
+    params.maxHeight = args->height;
+
+    params.rateControlPreset = args->bitRate < 0 ? IVIDEO_NONE :
+                                                   IVIDEO_LOW_DELAY;
+    params.maxBitRate = args->bitRate < 0 ? 2000000 : args->bitRate;
+    params.inputChromaFormat = XDM_YUV_422ILE;
+    params.reconChromaFormat = XDM_YUV_420P;
+
+    dynParams.targetBitRate = params.maxBitRate;
+    dynParams.inputWidth = params.maxWidth;
+    dynParams.inputHeight = params.maxHeight;
+
+    /* Align buffers to cache line boundary */
+    gfxAttrs.bAttrs.memParams.align = BUFSIZEALIGN;
+
+    /* Use cached buffers if requested */
+    if (args->cache) {
+        gfxAttrs.bAttrs.memParams.flags = Memory_CACHED;
+    }
+
+    gfxAttrs.dim.width = args->width;
+    gfxAttrs.dim.height = args->height;
+    gfxAttrs.dim.lineLength = BufferGfx_calcLineLength(args->width,
+                                                       ColorSpace_UYVY);
+    gfxAttrs.colorSpace = ColorSpace_UYVY;
+
+    for (chId = 0; chId < args->numThreads; chId++) {
+        ch = &channels[chId];
+
+        filename = filenameInsertId(args->inFile, chId);
+        ch->inFile = fopen(filename, "rb");
+        free(filename);
+
+        if (ch->inFile == NULL) {
+            printf("Failed to open input file %s\n", args->inFile);
+            goto cleanup;
+        }
+
+        filename = filenameInsertId(args->outFile, chId);
+        ch->outFile = fopen(filename, "wb");
+        free(filename);
+
+        if (ch->outFile == NULL) {
+            printf("Failed to open output file %s\n", args->outFile);
+            goto cleanup;
+        }
+
+        ch->hVe1 = Venc1_create(hEngine, args->codecName, &params,
+                                &dynParams);
+
+        if (ch->hVe1 == NULL) {
+            printf("Failed to create video encoder: %s\n", args->codecName);
+            goto cleanup;
+        }
+
+        outBufSize = Venc1_getOutBufSize(ch->hVe1);
+        inBufSize = Venc1_getInBufSize(ch->hVe1);
+
+        if (inBufSize < 0) {
+            printf("Failed to calculate buffer attributes\n");
+            goto cleanup;
+        }
+
+        ch->hInBuf = Buffer_create(Dmai_roundUp(inBufSize, BUFSIZEALIGN),
+                                   (Buffer_Attrs *) &gfxAttrs);
+        ch->hOutBuf = Buffer_create(Dmai_roundUp(outBufSize, BUFSIZEALIGN),
+                                    (Buffer_Attrs *) &gfxAttrs);
+
+        if (ch->hInBuf == NULL || ch->hOutBuf == NULL) {
+            printf("Failed to allocate contiguous buffer\n");
+            goto cleanup;
+        }
+
+        jobs[chId].hVe = ch->hVe1;
+        jobs[chId].hInBuf = ch->hInBuf;
+        jobs[chId].hOutBuf = ch->hOutBuf;
+    }
+
+    while (numFrame++ < args->numFrames) {
+        /* Get a new input frame for every channel */
+        for (chId = 0; chId < args->numThreads; chId++) {
+            ch = &channels[chId];
+
+            status = readFrameUYVY(ch->hInBuf, ch->inFile);
+
+            if (status == Dmai_EEOF) {
+                printf("Input of channel %d ended after %d frames\n", chId,
+                       *numEncoded);
+                ret = THREAD_SUCCESS;
+                goto cleanup;
+            }
+
+            if (status < 0) {
+                goto cleanup;
+            }
+
+            if (args->cache) {
+                /* See encodeThrFxn() for the xDAIS DMA Rule 7 requirements */
+                Memory_cacheWbInv(Buffer_getUserPtr(ch->hInBuf),
+                                  Buffer_getSize(ch->hInBuf));
+                Memory_cacheInv(Buffer_getUserPtr(ch->hOutBuf),
+                                Buffer_getSize(ch->hOutBuf));
+            }
+        }
+
+        if (args->benchmark) {
+            if (Time_reset(hTime) < 0) {
+                printf("Failed to reset timer\n");
+                goto cleanup;
+            }
+        }
+
+        /* Encode the frame of every channel */
+        if (Venc1_processMulti(jobs, args->numThreads) < 0) {
+            for (chId = 0; chId < args->numThreads; chId++) {
+                if (jobs[chId].status < 0) {
+                    printf("Failed to encode video buffer of channel %d\n",
+                           chId);
+                }
+            }
+            goto cleanup;
+        }
+
+        if (args->benchmark) {
+            if (Time_delta(hTime, &time) < 0) {
+                printf("Failed to get encode time\n");
+                goto cleanup;
+            }
+
+            printf("[%d] Encode of %d channels: %uus\n", numFrame,
+                   args->numThreads, (Uns) time);
+        }
+
+        /* Write the encoded frames to the file system */
+        for (chId = 0; chId < args->numThreads; chId++) {
+            ch = &channels[chId];
+
+            if (args->cache) {
+                Memory_cacheWb(Buffer_getUserPtr(ch->hOutBuf),
+                               Buffer_getSize(ch->hOutBuf));
+            }
+
+            if (Buffer_getNumBytesUsed(ch->hOutBuf)) {
+                if (fwrite(Buffer_getUserPtr(ch->hOutBuf),
+                           Buffer_getNumBytesUsed(ch->hOutBuf), 1,
+                           ch->outFile) != 1) {
+                    printf("Failed to write encoded video data to file\n");
+                    goto cleanup;
+                }
+            }
+        }
+
+        (*numEncoded)++;
+    }
+
+    ret = THREAD_SUCCESS;
+
+cleanup:
+    /* Clean up the channels */
+    if (channels) {
+        for (chId = 0; chId < args->numThreads; chId++) {
+            ch = &channels[chId];
+
+            if (ch->hOutBuf) {
+                Buffer_delete(ch->hOutBuf);
+            }
+
+            if (ch->hInBuf) {
+                Buffer_delete(ch->hInBuf);
+            }
+
+            if (ch->hVe1) {
+                Venc1_delete(ch->hVe1);
+            }
+
+            if (ch->inFile) {
+                fclose(ch->inFile);
+            }
+
+            if (ch->outFile) {
+                fclose(ch->outFile);
+            }
+        }
+    }
+
+    if (hEngine) {
+        Engine_close(hEngine);
+    }
+
+    if (hTime) {
+        Time_delete(hTime);
+    }
+
+    free(channels);
+    free(jobs);
+
+    return ret;
+}
+
 /******************************************************************************
  * appMain
  ******************************************************************************/
 Void appMain(Args * args)
 {
-    Int        status = EXIT_SUCCESS;
-    pthread_t *threads;
-    Args      *thrArgs;
-    Void      *ret;
-    Int        thrId;
+    Int          status  = EXIT_SUCCESS;
+    pthread_t   *threads = NULL;
+    Args        *thrArgs = NULL;
+    Time_Attrs   tAttrs  = Time_Attrs_DEFAULT;
+    Time_Handle  hTime   = NULL;
+    Void        *ret;
+    Int          thrId;
+    Int          numEncoded;
+    UInt32       time;
 
     /* Initialize the codec engine run time */
     CERuntime_init();
     
     /* Initialize DMAI */
     Dmai_init();
-    
+
+    if (args->benchmark) {
+        hTime = Time_create(&tAttrs);
+
+        if (hTime == NULL || Time_reset(hTime) < 0) {
+            printf("Failed to create Time object\n");
+            status = EXIT_FAILURE;
+            goto cleanup;
+        }
+    }
+
+    if (args->batch) {
+        /* Encode all channels from this thread */
+        if (batchEncode(args, &numEncoded) == THREAD_FAILURE) {
+            status = EXIT_FAILURE;
+        }
+
+        goto report;
+    }
+
     /* Allocate space for video thread handles */
     threads = calloc(args->numThreads, sizeof(pthread_t));
     thrArgs = calloc(args->numThreads, sizeof(Args));
@@ -433,6 +740,9 @@ Void appMain(Args * args)
         }
     }
 
+    /* Like batchEncode, count the frames encoded on every channel */
+    numEncoded = args->numFrames;
+
     /* Wait for all threads to finish */
     for (thrId = 0; thrId < args->numThreads; thrId++) {
         args->thrId = thrId;
@@ -442,6 +752,20 @@ Void appMain(Args * args)
                 status = EXIT_FAILURE;
             }
         }
+
+        if (thrArgs[thrId].numEncoded < numEncoded) {
+            numEncoded = thrArgs[thrId].numEncoded;
+        }
+    }
+
+report:
+    if (hTime) {
+        /* Compare this between the thread per channel and --batch modes */
+        if (Time_total(hTime, &time) == Dmai_EOK) {
+            printf("Encoded %d frames on %d channels (%s) in %uus\n",
+                   numEncoded, args->numThreads,
+                   args->batch ? "batch" : "thread per channel", (Uns) time);
+        }
     }
 
 cleanup:
@@ -449,5 +773,9 @@ cleanup:
     free(threads);
     free(thrArgs);
 
+    if (hTime) {
+        Time_delete(hTime);
+    }
+
     exit(status);
 }
@@ -49,10 +49,12 @@ typedef struct Args {
     Int   numThreads;
     Int   thrId;
     Bool  cache;
+    Bool  batch;
     Char  codecName[MAX_CODEC_NAME_SIZE];
     Char  inFile[MAX_FILE_NAME_SIZE];
     Char  outFile[MAX_FILE_NAME_SIZE];
     Char  engineName[MAX_ENGINE_NAME_SIZE];
+    Int   numEncoded;   /* Set by each encode thread to its frame count */
 } Args;
 
 #if defined (__cplusplus)
@@ -48,7 +48,7 @@
 #define DEFAULT_ENGINE_NAME     "encode"
 
 /* Default arguments for app */
-#define DEFAULT_ARGS { 100, 720, 576, -1, FALSE, 1, 0, FALSE }
+#define DEFAULT_ARGS { 100, 720, 576, -1, FALSE, 1, 0, FALSE, FALSE }
 
 /*
  * Argument IDs for long options. They must not conflict with ASCII values,
@@ -57,6 +57,7 @@
 typedef enum
 {
    ArgID_BENCHMARK = 256,
+   ArgID_BATCH,
    ArgID_BITRATE,
    ArgID_CODEC,
    ArgID_ENGINE,
@@ -78,6 +79,9 @@ static Void usage(void)
 {
     fprintf(stderr, "Usage: video_encode_io1_<platform> [options]\n\n"
         "Options:\n"
+        "     --batch          Encode all channels from one thread with\n"
+        "                      Venc1_processMulti instead of one thread per\n"
+        "                      channel\n"
         "     --benchmark      Print benchmarking information\n"
         "-b | --bitrate        Bitrate used to process video stream [variable]\n"
         "-c | --codec          Name of codec to use\n"
@@ -102,6 +106,7 @@ static Void parseArgs(Int argc, Char *argv[], Args *argsp)
     const char shortOptions[] = "b:c:e:hi:C:n:o:r:";
 
     const struct option longOptions[] = {
+        {"batch",           no_argument,       NULL, ArgID_BATCH       },
         {"benchmark",       no_argument,       NULL, ArgID_BENCHMARK   },
         {"bitrate",         required_argument, NULL, ArgID_BITRATE     },
         {"codec",           required_argument, NULL, ArgID_CODEC       },
@@ -133,6 +138,10 @@ static Void parseArgs(Int argc, Char *argv[], Args *argsp)
 
         switch (argID) {
 
+            case ArgID_BATCH:
+                argsp->batch = TRUE;
+                break;
+
             case ArgID_BENCHMARK:
                 argsp->benchmark = TRUE;
                 break;
@@ -33,6 +33,7 @@
 #include <xdc/std.h>
 
 #include <std.h>
+#include <clk.h>
 #include <que.h>
 #include <sem.h>
 #include <mem.h>
@@ -59,7 +60,8 @@ typedef struct Fifo_Elem {
 } Fifo_Elem;
 
 const Fifo_Attrs Fifo_Attrs_DEFAULT = {
-    20
+    20,
+    Fifo_Mode_PIPE
 };
 
 /******************************************************************************
@@ -118,9 +120,31 @@ Int Fifo_delete(Fifo_Handle hFifo)
 }
 
 /******************************************************************************
- * Fifo_get
+ * usToTicks
  ******************************************************************************/
-Int Fifo_get(Fifo_Handle hFifo, Ptr ptrPtr)
+static Uns usToTicks(UInt32 timeout)
+{
+    ULLong countsPerTick;
+
+    if (timeout == Fifo_FOREVER) {
+        return SYS_FOREVER;
+    }
+
+    if (timeout == Fifo_POLL) {
+        return 0;
+    }
+
+    /* Round up to whole low resolution clock ticks */
+    countsPerTick = (ULLong) CLK_getprd() * 1000;
+
+    return (Uns) (((ULLong) timeout * CLK_countspms() + countsPerTick - 1) /
+                  countsPerTick);
+}
+
+/******************************************************************************
+ * Fifo_getTimeout
+ ******************************************************************************/
+Int Fifo_getTimeout(Fifo_Handle hFifo, Ptr ptrPtr, UInt32 timeout)
 {
     Int flush;
     Fifo_Elem * elem;
@@ -139,7 +163,9 @@ Int Fifo_get(Fifo_Handle hFifo, Ptr ptrPtr)
     }
 
     /* Wait for element from other thread */
-    SEM_pend(&hFifo->sem, SYS_FOREVER);
+    if (!SEM_pend(&hFifo->sem, usToTicks(timeout))) {
+        return Dmai_ETIMEOUT;
+    }
    
     /* Handle flushed fifo */
     SEM_pend(&hFifo->mutex, SYS_FOREVER);
@@ -166,6 +192,52 @@ Int Fifo_get(Fifo_Handle hFifo, Ptr ptrPtr)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * Fifo_get
+ ******************************************************************************/
+Int Fifo_get(Fifo_Handle hFifo, Ptr ptrPtr)
+{
+    return Fifo_getTimeout(hFifo, ptrPtr, Fifo_FOREVER);
+}
+
+/******************************************************************************
+ * Fifo_getMany
+ ******************************************************************************/
+Int Fifo_getMany(Fifo_Handle hFifo, Ptr ptrs[], Int maxPtrs, Int *numPtrs,
+                 UInt32 timeout)
+{
+    Int ret;
+
+    assert(hFifo);
+    assert(ptrs);
+    assert(numPtrs);
+    assert(maxPtrs > 0);
+
+    *numPtrs = 0;
+
+    /* Wait for the first element, then drain what is already queued */
+    ret = Fifo_getTimeout(hFifo, &ptrs[0], timeout);
+
+    while (ret == Dmai_EOK) {
+        (*numPtrs)++;
+
+        if (*numPtrs == maxPtrs) {
+            break;
+        }
+
+        ret = Fifo_getTimeout(hFifo, &ptrs[*numPtrs], Fifo_POLL);
+    }
+
+    /* Keep a flush seen while draining pending for the next call */
+    if (ret == Dmai_EFLUSH && *numPtrs > 0) {
+        SEM_pend(&hFifo->mutex, SYS_FOREVER);
+        hFifo->flush = TRUE;
+        SEM_post(&hFifo->mutex);
+    }
+
+    return *numPtrs > 0 ? Dmai_EOK : ret;
+}
+
 /******************************************************************************
  * Fifo_flush
  ******************************************************************************/
@@ -227,3 +299,21 @@ Int Fifo_getNumEntries(Fifo_Handle hFifo)
     return numEntries;
 }
 
+
+/******************************************************************************
+ * Fifo_putMany
+ ******************************************************************************/
+Int Fifo_putMany(Fifo_Handle hFifo, Ptr ptrs[], Int numPtrs)
+{
+    Int ret = Dmai_EOK;
+    Int i;
+
+    assert(hFifo);
+    assert(ptrs);
+
+    for (i = 0; i < numPtrs && ret == Dmai_EOK; i++) {
+        ret = Fifo_put(hFifo, ptrs[i]);
+    }
+
+    return ret;
+}
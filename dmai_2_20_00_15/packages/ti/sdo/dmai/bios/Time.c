@@ -38,10 +38,13 @@
 #include <clk.h>
 #include <mem.h>
 #include <hwi.h>
+#include <prd.h>
 
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Time.h>
 
+#include "../priv/_Time.h"
+
 #define MODULE_NAME     "Time"
 
 typedef struct Time_Object {
@@ -218,3 +221,12 @@ Int Time_total(Time_Handle hTime, UInt32 *totalPtr)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * _Time_getSemTicks
+ ******************************************************************************/
+UInt32 _Time_getSemTicks(Void)
+{
+    /* SEM_pend timeouts are in system clock ticks */
+    return PRD_getticks();
+}
+
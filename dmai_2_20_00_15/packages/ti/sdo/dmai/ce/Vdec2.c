@@ -44,6 +44,9 @@
 #include <ti/sdo/dmai/ce/Vdec2.h>
 #include <ti/sdo/dmai/Buffer.h>
 #include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/Time.h>
+
+#include "../priv/_Pool.h"
 
 #define MODULE_NAME     "Vdec2"
 
@@ -51,6 +54,20 @@
 #define GETID(x)  ((x) + 1)
 #define GETIDX(x) ((x) - 1)
 
+/* Arguments of a decode call, kept in the object while it is in flight */
+typedef struct Vdec2_Call {
+    VIDDEC2_InArgs          inArgs;
+    VIDDEC2_OutArgs         outArgs;
+    XDM1_BufDesc            inBufDesc;
+    XDM_BufDesc             outBufDesc;
+    XDAS_Int32              outBufSizeArray[XDM_MAX_IO_BUFFERS];
+    XDAS_Int8              *outBufPtrArray[XDM_MAX_IO_BUFFERS];
+    Buffer_Handle           hInBuf;
+    Buffer_Handle           hDstBuf;
+    UInt32                  bpp;
+    XDAS_Int32              status;
+} Vdec2_Call;
+
 typedef struct Vdec2_Object {
     VIDDEC2_Handle          hDecode;
     Int32                   minNumInBufs;
@@ -64,8 +81,29 @@ typedef struct Vdec2_Object {
     Buffer_Handle           hDisplayBufs[IVIDDEC2_MAX_IO_BUFFERS];
     Int                     displayBufIdx;
     VIDDEC2_DynamicParams   dynParams;
+    Engine_Handle           hEngine;
+    Ptr                    *regBufs;
+    Int                    *regSizes;
+    Int                     numRegBufs;
+    struct Vdec2_PoolEntry *poolEntry;
+    Vdec2_Call              call;
+    Bool                    callPending;
 } Vdec2_Object;
 
+/* A codec instance created by Vdec2_preCreate, to be leased by Vdec2_create */
+typedef struct Vdec2_PoolEntry {
+    struct Vdec2_PoolEntry *next;
+    Engine_Handle           hEngine;
+    Char                   *codecName;
+    VIDDEC2_Params         *params;
+    VIDDEC2_Handle          hDecode;
+    Bool                    inUse;
+    Bool                    retired;
+} Vdec2_PoolEntry;
+
+static Vdec2_PoolEntry     *pool = NULL;
+static Sem_Handle           poolSem = NULL;
+
 const VIDDEC2_Params Vdec2_Params_DEFAULT = {
     sizeof(VIDDEC2_Params),             /* size */
     576,                                /* maxHeight */
@@ -87,22 +125,13 @@ const VIDDEC2_DynamicParams Vdec2_DynamicParams_DEFAULT = {
 };
 
 /******************************************************************************
- * Vdec2_process
+ * prepareCall
  ******************************************************************************/
-Int Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
-                  Buffer_Handle hDstBuf)
+static Int prepareCall(Vdec2_Handle hVd, Buffer_Handle hInBuf,
+                       Buffer_Handle hDstBuf, Vdec2_Call *call)
 {
-    VIDDEC2_InArgs          inArgs;
-    VIDDEC2_OutArgs         outArgs;
-    XDM1_BufDesc            inBufDesc;
-    XDM_BufDesc             outBufDesc;
-    XDAS_Int32              outBufSizeArray[XDM_MAX_IO_BUFFERS];
-    XDAS_Int8              *outBufPtrArray[XDM_MAX_IO_BUFFERS];
-    XDAS_Int32              status;
-    Int                     bufIdx;
     BufferGfx_Dimensions    dim;
     XDAS_Int8              *inPtr, *dstPtr;
-    Int                     ret = Dmai_EOK;
     UInt32                  offset;
     UInt32                  bpp;
 
@@ -116,7 +145,7 @@ Int Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
     assert(Buffer_getType(hDstBuf) == Buffer_Type_GRAPHICS);
 
     bpp = ColorSpace_getBpp(BufferGfx_getColorSpace(hDstBuf));
- 
+
     BufferGfx_getDimensions(hDstBuf, &dim);
 
     offset = (dim.y * dim.lineLength) + (dim.x * (bpp >> 3));
@@ -126,83 +155,108 @@ Int Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
     dstPtr = Buffer_getUserPtr(hDstBuf) + offset;
 
     if (BufferGfx_getColorSpace(hDstBuf) == ColorSpace_YUV420PSEMI) {
-        outBufPtrArray[0]       = dstPtr;
-        outBufSizeArray[0]      = hVd->minOutBufSize[0];
+        call->outBufPtrArray[0]     = dstPtr;
+        call->outBufSizeArray[0]    = hVd->minOutBufSize[0];
 
-        outBufPtrArray[1]       = dstPtr + Buffer_getSize(hDstBuf) * 2 / 3;
-        outBufSizeArray[1]      = hVd->minOutBufSize[1];
+        call->outBufPtrArray[1]     = dstPtr + Buffer_getSize(hDstBuf) * 2 / 3;
+        call->outBufSizeArray[1]    = hVd->minOutBufSize[1];
     }
     else if (BufferGfx_getColorSpace(hDstBuf) == ColorSpace_YUV420P) {
-        outBufPtrArray[0]       = dstPtr;
-        outBufSizeArray[0]      = hVd->minOutBufSize[0];
+        call->outBufPtrArray[0]     = dstPtr;
+        call->outBufSizeArray[0]    = hVd->minOutBufSize[0];
 
-        outBufPtrArray[1]       = dstPtr + Buffer_getSize(hDstBuf) * 2 / 3;
-        outBufSizeArray[1]      = hVd->minOutBufSize[1];
+        call->outBufPtrArray[1]     = dstPtr + Buffer_getSize(hDstBuf) * 2 / 3;
+        call->outBufSizeArray[1]    = hVd->minOutBufSize[1];
 
-        outBufPtrArray[2]       = dstPtr + Buffer_getSize(hDstBuf) * 5 / 6;  
-        outBufSizeArray[2]      = hVd->minOutBufSize[2];
+        call->outBufPtrArray[2]     = dstPtr + Buffer_getSize(hDstBuf) * 5 / 6;
+        call->outBufSizeArray[2]    = hVd->minOutBufSize[2];
     }
     else if (BufferGfx_getColorSpace(hDstBuf) == ColorSpace_UYVY) {
-        outBufPtrArray[0]       = dstPtr;
-        outBufSizeArray[0]      = hVd->minOutBufSize[0];
+        call->outBufPtrArray[0]     = dstPtr;
+        call->outBufSizeArray[0]    = hVd->minOutBufSize[0];
     }
     else {
         Dmai_err0("Unsupported color format of destination buffer\n");
         return Dmai_EINVAL;
     }
 
-    outBufDesc.numBufs          = hVd->minNumOutBufs;
-    outBufDesc.bufSizes         = outBufSizeArray;
-    outBufDesc.bufs             = outBufPtrArray;
+    call->outBufDesc.numBufs            = hVd->minNumOutBufs;
+    call->outBufDesc.bufSizes           = call->outBufSizeArray;
+    call->outBufDesc.bufs               = call->outBufPtrArray;
 
     /* One buffer with encoded data */
-    inBufDesc.numBufs           = 1;
-    inBufDesc.descs[0].buf      = inPtr;
-    inBufDesc.descs[0].bufSize  = Buffer_getNumBytesUsed(hInBuf);
+    call->inBufDesc.numBufs             = 1;
+    call->inBufDesc.descs[0].buf        = inPtr;
+    call->inBufDesc.descs[0].bufSize    = Buffer_getNumBytesUsed(hInBuf);
 
-    inArgs.size                 = sizeof(VIDDEC2_InArgs);
-    inArgs.numBytes             = Buffer_getNumBytesUsed(hInBuf);
-    inArgs.inputID              = GETID(Buffer_getId(hDstBuf));
+    call->inArgs.size                   = sizeof(VIDDEC2_InArgs);
+    call->inArgs.numBytes               = Buffer_getNumBytesUsed(hInBuf);
+    call->inArgs.inputID                = GETID(Buffer_getId(hDstBuf));
 
-    outArgs.size                = sizeof(VIDDEC2_OutArgs);
+    call->outArgs.size                  = sizeof(VIDDEC2_OutArgs);
 
-    /* Decode video buffer */
-    status = VIDDEC2_process(hVd->hDecode, &inBufDesc, &outBufDesc, &inArgs,
-                             &outArgs);
+    call->hInBuf                        = hInBuf;
+    call->hDstBuf                       = hDstBuf;
+    call->bpp                           = bpp;
+
+    /* A remote codec accesses the buffers behind the cache of this CPU */
+    if (!VISA_isLocal((VISA_Handle)hVd->hDecode)) {
+        Buffer_cacheWb(hInBuf);
+        Buffer_cacheWb(hDstBuf);
+    }
 
-    Buffer_setNumBytesUsed(hInBuf, outArgs.bytesConsumed);
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * completeCall
+ ******************************************************************************/
+static Int completeCall(Vdec2_Handle hVd, Vdec2_Call *call, XDAS_Int32 status)
+{
+    VIDDEC2_OutArgs        *outArgs = &call->outArgs;
+    Int                     bufIdx;
+    BufferGfx_Dimensions    dim;
+    Int                     ret = Dmai_EOK;
+    UInt32                  offset;
+    UInt32                  bpp = call->bpp;
+
+    Buffer_setNumBytesUsed(call->hInBuf, outArgs->bytesConsumed);
+
+    if (!VISA_isLocal((VISA_Handle)hVd->hDecode)) {
+        Buffer_setDeviceDirty(call->hDstBuf);
+    }
 
     Dmai_dbg4("VIDDEC2_process() ret %d inId %d inUse %d consumed %d\n",
-              status, Buffer_getId(hDstBuf), outArgs.outBufsInUseFlag,
-              outArgs.bytesConsumed);
+              status, Buffer_getId(call->hDstBuf), outArgs->outBufsInUseFlag,
+              outArgs->bytesConsumed);
 
     if (status != VIDDEC2_EOK) {
-        if (XDM_ISFATALERROR(outArgs.decodedBufs.extendedError)) {
+        if (XDM_ISFATALERROR(outArgs->decodedBufs.extendedError)) {
             Dmai_err2("VIDDEC2_process() failed with error (%d ext: 0x%x)\n",
-                      (Int)status, (Uns) outArgs.decodedBufs.extendedError);
+                      (Int)status, (Uns) outArgs->decodedBufs.extendedError);
             return Dmai_EFAIL;
         }
         else {
             Dmai_dbg1("VIDDEC2_process() non-fatal error 0x%x\n",
-                      (Uns) outArgs.decodedBufs.extendedError);
+                      (Uns) outArgs->decodedBufs.extendedError);
             ret = Dmai_EBITERROR;
         }
     }
 
     /* Prepare buffers for display */
     for (bufIdx = 0;
-         bufIdx < IVIDDEC2_MAX_IO_BUFFERS && outArgs.outputID[bufIdx] > 0;
+         bufIdx < IVIDDEC2_MAX_IO_BUFFERS && outArgs->outputID[bufIdx] > 0;
          bufIdx++) {
 
         hVd->hDisplayBufs[bufIdx] =
-            BufTab_getBuf(hVd->hOutBufTab, GETIDX(outArgs.outputID[bufIdx]));
+            BufTab_getBuf(hVd->hOutBufTab, GETIDX(outArgs->outputID[bufIdx]));
 
-        dim.width = outArgs.displayBufs[bufIdx].frameWidth;
-        dim.height = outArgs.displayBufs[bufIdx].frameHeight;
-        dim.lineLength = outArgs.displayBufs[bufIdx].framePitch;
+        dim.width = outArgs->displayBufs[bufIdx].frameWidth;
+        dim.height = outArgs->displayBufs[bufIdx].frameHeight;
+        dim.lineLength = outArgs->displayBufs[bufIdx].framePitch;
 
         /* Is there an offset to where we are supposed to start displaying? */
-        offset = outArgs.displayBufs[bufIdx].bufDesc[0].buf -
+        offset = outArgs->displayBufs[bufIdx].bufDesc[0].buf -
                  Buffer_getUserPtr(hVd->hDisplayBufs[bufIdx]);
 
         dim.y = offset / dim.lineLength;
@@ -211,7 +265,7 @@ Int Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
         Buffer_setNumBytesUsed(hVd->hDisplayBufs[bufIdx],
                                Vdec2_getOutBufSize(hVd));
         BufferGfx_setFrameType(hVd->hDisplayBufs[bufIdx],
-                               outArgs.displayBufs[bufIdx].frameType);
+                               outArgs->displayBufs[bufIdx].frameType);
 
         if (BufferGfx_setDimensions(hVd->hDisplayBufs[bufIdx], &dim) < 0) {
             Dmai_err0("Frame does not fit in allocated buffer\n");
@@ -228,11 +282,11 @@ Int Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
 
     /* Prepare buffers to be freed */
     for (bufIdx = 0;
-         bufIdx < IVIDDEC2_MAX_IO_BUFFERS && outArgs.freeBufID[bufIdx] > 0;
+         bufIdx < IVIDDEC2_MAX_IO_BUFFERS && outArgs->freeBufID[bufIdx] > 0;
          bufIdx++) {
 
         hVd->hFreeBufs[bufIdx] =
-            BufTab_getBuf(hVd->hOutBufTab, GETIDX(outArgs.freeBufID[bufIdx]));
+            BufTab_getBuf(hVd->hOutBufTab, GETIDX(outArgs->freeBufID[bufIdx]));
     }
 
     /* Null terminate the list of free buffers */
@@ -243,13 +297,122 @@ Int Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
     hVd->freeBufIdx = 0;
 
     /* Was this just the first field of an interlaced frame? */
-    if (outArgs.outBufsInUseFlag) {
+    if (outArgs->outBufsInUseFlag) {
         ret = Dmai_EFIRSTFIELD;
     }
 
     return ret;
 }
 
+/******************************************************************************
+ * Vdec2_process
+ ******************************************************************************/
+Int Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
+                  Buffer_Handle hDstBuf)
+{
+    Vdec2_Call              call;
+    XDAS_Int32              status;
+    Int                     ret;
+
+    assert(hVd);
+    assert(!hVd->callPending);
+
+    ret = prepareCall(hVd, hInBuf, hDstBuf, &call);
+
+    if (ret != Dmai_EOK) {
+        return ret;
+    }
+
+    /* Decode video buffer */
+    status = VIDDEC2_process(hVd->hDecode, &call.inBufDesc, &call.outBufDesc,
+                             &call.inArgs, &call.outArgs);
+
+    return completeCall(hVd, &call, status);
+}
+
+/******************************************************************************
+ * Vdec2_processAsync
+ ******************************************************************************/
+Int Vdec2_processAsync(Vdec2_Handle hVd, Buffer_Handle hInBuf,
+                       Buffer_Handle hDstBuf)
+{
+    Vdec2_Call             *call;
+    XDAS_Int32              status;
+    Int                     ret;
+
+    assert(hVd);
+
+    if (hVd->callPending) {
+        Dmai_err0("Previous Vdec2_processAsync() has not been waited for\n");
+        return Dmai_EINVAL;
+    }
+
+    call = &hVd->call;
+
+    ret = prepareCall(hVd, hInBuf, hDstBuf, call);
+
+    if (ret != Dmai_EOK) {
+        return ret;
+    }
+
+    if (VISA_isLocal((VISA_Handle)hVd->hDecode)) {
+        /* A local codec runs in this thread, so just decode it now */
+        call->status = VIDDEC2_process(hVd->hDecode, &call->inBufDesc,
+                                       &call->outBufDesc, &call->inArgs,
+                                       &call->outArgs);
+    }
+    else {
+        status = VIDDEC2_processAsync(hVd->hDecode, &call->inBufDesc,
+                                      &call->outBufDesc, &call->inArgs,
+                                      &call->outArgs);
+
+        if (status != VIDDEC2_EOK) {
+            Dmai_err1("VIDDEC2_processAsync() failed with error (%d)\n",
+                      (Int)status);
+            return Dmai_EFAIL;
+        }
+    }
+
+    hVd->callPending = TRUE;
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Vdec2_wait
+ ******************************************************************************/
+Int Vdec2_wait(Vdec2_Handle hVd, UInt timeout)
+{
+    Vdec2_Call             *call;
+    XDAS_Int32              status;
+
+    assert(hVd);
+
+    if (!hVd->callPending) {
+        Dmai_err0("No Vdec2_processAsync() to wait for\n");
+        return Dmai_EINVAL;
+    }
+
+    call = &hVd->call;
+
+    if (VISA_isLocal((VISA_Handle)hVd->hDecode)) {
+        status = call->status;
+    }
+    else {
+        status = VIDDEC2_processWait(hVd->hDecode, &call->inBufDesc,
+                                     &call->outBufDesc, &call->inArgs,
+                                     &call->outArgs, timeout);
+
+        if (status == VIDDEC2_ETIMEOUT) {
+            return Dmai_ETIMEOUT;
+        }
+    }
+
+    hVd->callPending = FALSE;
+
+    return completeCall(hVd, call, status);
+}
+
 /******************************************************************************
  * Vdec2_getMinOutBufs
  ******************************************************************************/
@@ -315,6 +478,180 @@ Int Vdec2_flush(Vdec2_Handle hVd)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * registerBufTab
+ ******************************************************************************/
+static Void registerBufTab(Vdec2_Handle hVd, BufTab_Handle hBufTab)
+{
+    Buffer_Handle hBuf;
+    Int           numBufs;
+    Int           i;
+
+    numBufs = BufTab_getNumBufs(hBufTab);
+    hVd->regBufs = malloc(numBufs * sizeof(Ptr));
+    hVd->regSizes = malloc(numBufs * sizeof(Int));
+
+    if (hVd->regBufs == NULL || hVd->regSizes == NULL) {
+        Dmai_dbg0("Failed to allocate space for the registered buffers\n");
+        goto fail;
+    }
+
+    for (i = 0; i < numBufs; i++) {
+        hBuf = BufTab_getBuf(hBufTab, i);
+        hVd->regBufs[i] = Buffer_getUserPtr(hBuf);
+        hVd->regSizes[i] = Buffer_getSize(hBuf);
+    }
+
+    /* Let the codec stubs skip address translation for these buffers */
+    if (Engine_registerBufs(hVd->hEngine, hVd->regBufs, hVd->regSizes,
+                            numBufs) != Engine_EOK) {
+        Dmai_dbg0("Could not register BufTab with the engine, buffers will "
+                  "be translated on each process call\n");
+        goto fail;
+    }
+
+    hVd->numRegBufs = numBufs;
+
+    return;
+
+fail:
+    free(hVd->regBufs);
+    free(hVd->regSizes);
+    hVd->regBufs = NULL;
+    hVd->regSizes = NULL;
+}
+
+/******************************************************************************
+ * unregisterBufTab
+ ******************************************************************************/
+static Void unregisterBufTab(Vdec2_Handle hVd)
+{
+    if (hVd->numRegBufs > 0) {
+        Engine_unregisterBufs(hVd->hEngine, hVd->regBufs, hVd->regSizes,
+                              hVd->numRegBufs);
+    }
+
+    free(hVd->regBufs);
+    free(hVd->regSizes);
+    hVd->regBufs = NULL;
+    hVd->regSizes = NULL;
+    hVd->numRegBufs = 0;
+}
+
+/******************************************************************************
+ * lockPool
+ ******************************************************************************/
+static Int lockPool(Void)
+{
+    if (_Pool_lock(&poolSem) != Dmai_EOK) {
+        Dmai_err0("Failed to lock the instance pool\n");
+        return Dmai_EFAIL;
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * unlockPool
+ ******************************************************************************/
+static Void unlockPool(Void)
+{
+    _Pool_unlock(&poolSem);
+}
+
+/******************************************************************************
+ * leaseInstance
+ ******************************************************************************/
+static Vdec2_PoolEntry *leaseInstance(Engine_Handle hEngine, Char *codecName,
+                                      VIDDEC2_Params *params)
+{
+    Vdec2_PoolEntry *entry;
+
+    if (lockPool() != Dmai_EOK) {
+        return NULL;
+    }
+
+    for (entry = pool; entry != NULL; entry = entry->next) {
+        if (!entry->inUse && !entry->retired && entry->hEngine == hEngine &&
+            strcmp(entry->codecName, codecName) == 0 &&
+            entry->params->size == params->size &&
+            memcmp(entry->params, params, params->size) == 0) {
+
+            entry->inUse = TRUE;
+            break;
+        }
+    }
+
+    unlockPool();
+
+    return entry;
+}
+
+/******************************************************************************
+ * freeEntry
+ ******************************************************************************/
+static Void freeEntry(Vdec2_PoolEntry *entry)
+{
+    if (entry->hDecode) {
+        VIDDEC2_delete(entry->hDecode);
+    }
+
+    free(entry->codecName);
+    free(entry->params);
+    free(entry);
+}
+
+/******************************************************************************
+ * releaseInstance
+ ******************************************************************************/
+static Void releaseInstance(Vdec2_PoolEntry *entry)
+{
+    Vdec2_PoolEntry **prev;
+    Bool           retired;
+
+    if (lockPool() != Dmai_EOK) {
+        return;
+    }
+
+    retired = entry->retired;
+
+    if (retired) {
+        /* The pool was deleted while the instance was leased */
+        for (prev = &pool; *prev != entry; prev = &(*prev)->next) {
+        }
+        *prev = entry->next;
+    }
+    else {
+        entry->inUse = FALSE;
+    }
+
+    unlockPool();
+
+    if (retired) {
+        freeEntry(entry);
+    }
+}
+
+/******************************************************************************
+ * discardInstance
+ ******************************************************************************/
+static Void discardInstance(Vdec2_PoolEntry *entry)
+{
+    Vdec2_PoolEntry **prev;
+
+    if (lockPool() != Dmai_EOK) {
+        return;
+    }
+
+    for (prev = &pool; *prev != entry; prev = &(*prev)->next) {
+    }
+    *prev = entry->next;
+
+    unlockPool();
+
+    freeEntry(entry);
+}
+
 /******************************************************************************
  * Vdec2_create
  ******************************************************************************/
@@ -326,6 +663,10 @@ Vdec2_Handle Vdec2_create(Engine_Handle hEngine, Char *codecName,
     VIDDEC2_Handle         hDecode;
     VIDDEC2_Status         decStatus;
     XDAS_Int32             status;
+    Vdec2_PoolEntry       *entry;
+    Time_Attrs             tAttrs = Time_Attrs_DEFAULT;
+    Time_Handle            hTime;
+    UInt32                 createTime;
 
     if (hEngine == NULL || codecName == NULL ||
         params == NULL || dynParams == NULL) {
@@ -342,25 +683,70 @@ Vdec2_Handle Vdec2_create(Engine_Handle hEngine, Char *codecName,
         return NULL;
     }
 
-    /* Create video decoder instance */
-    hDecode = VIDDEC2_create(hEngine, codecName, params);
+    decStatus.data.buf = NULL;
+    decStatus.size = sizeof(VIDDEC2_Status);
+
+    /* Time getting an instance, to see what the pool and zeroing policy save */
+    hTime = Time_create(&tAttrs);
+
+    if (hTime) {
+        Time_reset(hTime);
+    }
+
+    /* Lease a pre-created instance with the same params if there is one */
+    entry = leaseInstance(hEngine, codecName, params);
+
+    hDecode = NULL;
+
+    if (entry) {
+        status = VIDDEC2_control(entry->hDecode, XDM_RESET, dynParams,
+                                 &decStatus);
+
+        if (status == VIDDEC2_EOK) {
+            hDecode = entry->hDecode;
+        }
+        else {
+            /* Never pool a codec in an unknown state, start from a new one */
+            Dmai_err0("XDM_RESET control failed\n");
+            discardInstance(entry);
+            entry = NULL;
+        }
+    }
+
+    if (entry == NULL) {
+        /* Create video decoder instance */
+        hDecode = VIDDEC2_create(hEngine, codecName, params);
+
+        if (hDecode == NULL) {
+            Dmai_err0("Failed to open video decode algorithm\n");
+        }
+    }
+
+    if (hTime) {
+        if (hDecode && Time_delta(hTime, &createTime) == Dmai_EOK) {
+            Dmai_dbg3("Video decoder %s ready in %u us (%s)\n", codecName,
+                      (Uns) createTime, entry ? "from pool" : "created");
+        }
+
+        Time_delete(hTime);
+    }
 
     if (hDecode == NULL) {
-        Dmai_err0("Failed to open video decode algorithm\n");
         free(hVd);
         return NULL;
     }
 
-    Dmai_dbg0("Video decoder instance created\n");
-
     /* Set video decoder dynamic params */
-    decStatus.data.buf = NULL;
-    decStatus.size = sizeof(VIDDEC2_Status);
     status = VIDDEC2_control(hDecode, XDM_SETPARAMS, dynParams, &decStatus);
 
     if (status != VIDDEC2_EOK) {
         Dmai_err0("XDM_SETPARAMS control failed\n");
-        VIDDEC2_delete(hDecode);
+        if (entry) {
+            releaseInstance(entry);
+        }
+        else {
+            VIDDEC2_delete(hDecode);
+        }
         free(hVd);
         return NULL;
     }
@@ -369,6 +755,8 @@ Vdec2_Handle Vdec2_create(Engine_Handle hEngine, Char *codecName,
 
     hVd->dynParams = *dynParams;
     hVd->hDecode = hDecode;
+    hVd->hEngine = hEngine;
+    hVd->poolEntry = entry;
 
     Vdec2_getMinOutBufs(hVd);
 
@@ -381,7 +769,18 @@ Vdec2_Handle Vdec2_create(Engine_Handle hEngine, Char *codecName,
 Int Vdec2_delete(Vdec2_Handle hVd)
 {
     if (hVd) {
-        if (hVd->hDecode) {
+        if (hVd->callPending) {
+            /* Don't leave the codec writing into buffers about to be freed */
+            Vdec2_wait(hVd, VIDDEC2_FOREVER);
+        }
+
+        unregisterBufTab(hVd);
+
+        if (hVd->poolEntry) {
+            /* Hand the instance back to the pool for the next create */
+            releaseInstance(hVd->poolEntry);
+        }
+        else if (hVd->hDecode) {
             VIDDEC2_delete(hVd->hDecode);
         }
 
@@ -391,6 +790,107 @@ Int Vdec2_delete(Vdec2_Handle hVd)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * Vdec2_preCreate
+ ******************************************************************************/
+Int Vdec2_preCreate(Engine_Handle hEngine, Char *codecName,
+                    VIDDEC2_Params *params, Int numInstances)
+{
+    Vdec2_PoolEntry *entry;
+    Int              i;
+
+    if (hEngine == NULL || codecName == NULL || params == NULL ||
+        numInstances < 0) {
+        Dmai_err0("Cannot pass null for engine, codec name or params\n");
+        return Dmai_EINVAL;
+    }
+
+    for (i = 0; i < numInstances; i++) {
+        entry = calloc(1, sizeof(Vdec2_PoolEntry));
+
+        if (entry == NULL) {
+            Dmai_err0("Failed to allocate space for pool entry\n");
+            return Dmai_ENOMEM;
+        }
+
+        entry->hEngine = hEngine;
+        entry->codecName = malloc(strlen(codecName) + 1);
+        entry->params = malloc(params->size);
+
+        if (entry->codecName == NULL || entry->params == NULL) {
+            Dmai_err0("Failed to allocate space for pool entry\n");
+            freeEntry(entry);
+            return Dmai_ENOMEM;
+        }
+
+        strcpy(entry->codecName, codecName);
+        memcpy(entry->params, params, params->size);
+
+        entry->hDecode = VIDDEC2_create(hEngine, codecName, params);
+
+        if (entry->hDecode == NULL) {
+            Dmai_err0("Failed to open video decode algorithm\n");
+            freeEntry(entry);
+            return Dmai_EFAIL;
+        }
+
+        if (lockPool() != Dmai_EOK) {
+            freeEntry(entry);
+            return Dmai_EFAIL;
+        }
+
+        entry->next = pool;
+        pool = entry;
+        unlockPool();
+    }
+
+    Dmai_dbg2("Added %d instances of %s to the pool\n", numInstances,
+              codecName);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Vdec2_deletePool
+ ******************************************************************************/
+Int Vdec2_deletePool(Engine_Handle hEngine)
+{
+    Vdec2_PoolEntry **prev;
+    Vdec2_PoolEntry  *entry;
+    Vdec2_PoolEntry  *idle = NULL;
+
+    if (lockPool() != Dmai_EOK) {
+        return Dmai_EFAIL;
+    }
+
+    prev = &pool;
+    while ((entry = *prev) != NULL) {
+        if (hEngine != NULL && entry->hEngine != hEngine) {
+            prev = &entry->next;
+        }
+        else if (entry->inUse) {
+            /* Deleted by Vdec2_delete when it comes back */
+            entry->retired = TRUE;
+            prev = &entry->next;
+        }
+        else {
+            *prev = entry->next;
+            entry->next = idle;
+            idle = entry;
+        }
+    }
+
+    unlockPool();
+
+    while (idle) {
+        entry = idle;
+        idle = idle->next;
+        freeEntry(entry);
+    }
+
+    return Dmai_EOK;
+}
+
 /******************************************************************************
  * Vdec2_setBufTab
  ******************************************************************************/
@@ -398,7 +898,13 @@ Void Vdec2_setBufTab(Vdec2_Handle hVd, BufTab_Handle hBufTab)
 {
     assert(hVd);
 
+    unregisterBufTab(hVd);
+
     hVd->hOutBufTab = hBufTab;
+
+    if (hBufTab) {
+        registerBufTab(hVd, hBufTab);
+    }
 }
 
 /******************************************************************************
@@ -148,6 +148,51 @@ extern Int Vdec2_process(Vdec2_Handle hVd,
                          Buffer_Handle hInBuf,
                          Buffer_Handle hDstBuf);
 
+/**
+ * @brief       Starts decoding a video buffer without waiting for the
+ *              result. The decode is finished, and the display and free
+ *              buffers made available, by #Vdec2_wait.
+ *
+ * @param[in]   hVd         The #Vdec2_Handle to decode with.
+ * @param[in]   hInBuf      The #Buffer_Handle for the buffer containing the
+ *                          encoded data.
+ * @param[in]   hDstBuf     The #Buffer_Handle for the buffer to write the
+ *                          decoded data to.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     #Vdec2_create must be called before this function.
+ * @remarks     #Vdec2_setBufTab must be called before this function.
+ * @remarks     Neither buffer may be touched until #Vdec2_wait has returned
+ *              something other than Dmai_ETIMEOUT, and no other Vdec2 call
+ *              may be made on @c hVd in between.
+ * @remarks     If the codec is local (not on a codec server), the decode
+ *              runs to completion in this call.
+ */
+extern Int Vdec2_processAsync(Vdec2_Handle hVd,
+                              Buffer_Handle hInBuf,
+                              Buffer_Handle hDstBuf);
+
+/**
+ * @brief       Waits for the decode started by #Vdec2_processAsync to
+ *              finish.
+ *
+ * @param[in]   hVd         The #Vdec2_Handle to wait on.
+ * @param[in]   timeout     How long to wait, in the units of
+ *                          VIDDEC2_processWait(). Use VIDDEC2_FOREVER to
+ *                          block until the decode is done.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      Dmai_ETIMEOUT if the decode has not finished yet.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     Returns the same codes as #Vdec2_process, e.g.
+ *              Dmai_EFIRSTFIELD or Dmai_EBITERROR, and updates the display
+ *              and free buffers and the input buffer the same way.
+ */
+extern Int Vdec2_wait(Vdec2_Handle hVd, UInt timeout);
+
 /**
  * @brief       Deletes a Video Decode algorithm instance.
  *
@@ -160,6 +205,47 @@ extern Int Vdec2_process(Vdec2_Handle hVd,
  */
 extern Int Vdec2_delete(Vdec2_Handle hVd);
 
+/**
+ * @brief       Creates idle Video Decode algorithm instances ahead of time, so
+ *              that a later #Vdec2_create with the same engine, codec name and
+ *              params only has to reset an instance instead of creating one.
+ *
+ * @param[in]   hEngine      An opened engine containing the algorithm.
+ * @param[in]   codecName    The name of the algorithm to create.
+ * @param[in]   params       XDM parameters the instances are created with.
+ * @param[in]   numInstances The number of instances to add to the pool.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     #Vdec2_create only leases an instance if params match byte
+ *              for byte (up to params->size), and issues XDM_RESET on it
+ *              before applying the dynamic params.
+ *              An instance which fails XDM_RESET is deleted and a new one
+ *              is created in its place.
+ * @remarks     #Vdec2_delete returns a leased instance to the pool instead of
+ *              deleting it.
+ */
+extern Int Vdec2_preCreate(Engine_Handle hEngine,
+                           Char *codecName,
+                           VIDDEC2_Params *params,
+                           Int numInstances);
+
+/**
+ * @brief       Deletes the idle instances created by #Vdec2_preCreate.
+ *
+ * @param[in]   hEngine     Only delete instances on this engine, or NULL to
+ *                          empty the whole pool.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     Instances currently leased by a Vdec2 object are deleted when
+ *              that object is passed to #Vdec2_delete.
+ * @remarks     Must be called before the engine is closed.
+ */
+extern Int Vdec2_deletePool(Engine_Handle hEngine);
+
 /**
  * @brief       Figures out the actual output buffer requirements of the codec
  *              after the first #Vdec2_process call. Also updates the buffer
@@ -187,6 +273,13 @@ extern Int32 Vdec2_getMinOutBufs(Vdec2_Handle hVd);
  * @param[in]   hBufTab     The #BufTab_Handle to give to the video decoder.
  *
  * @remarks     #Vdec2_create must be called before this function.
+ *
+ * @remarks     The buffers are registered with the engine (see
+ *              Engine_registerBufs()) so that they don't need to be
+ *              translated to physical addresses on each process call.
+ *              They stay registered until the BufTab is replaced or the
+ *              Vdec2 instance is deleted, so the BufTab must not be freed
+ *              while the instance is still used for processing.
  */
 extern Void Vdec2_setBufTab(Vdec2_Handle hVd, BufTab_Handle hBufTab);
 
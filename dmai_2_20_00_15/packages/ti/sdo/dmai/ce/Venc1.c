@@ -42,6 +42,9 @@
 #include <ti/sdo/dmai/ColorSpace.h>
 #include <ti/sdo/dmai/ce/Venc1.h>
 #include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/Time.h>
+
+#include "../priv/_Pool.h"
 
 #define MODULE_NAME     "Venc1"
 
@@ -49,6 +52,19 @@
 #define GETID(x)  ((x) + 1)
 #define GETIDX(x) ((x) - 1)
 
+/* Arguments of an encode call, kept in the object while it is in flight */
+typedef struct Venc1_Call {
+    IVIDEO1_BufDescIn       inBufDesc;
+    XDM_BufDesc             outBufDesc;
+    XDAS_Int32              outBufSizeArray[1];
+    XDAS_Int8              *outPtr;
+    VIDENC1_InArgs          inArgs;
+    VIDENC1_OutArgs         outArgs;
+    Buffer_Handle           hInBuf;
+    Buffer_Handle           hOutBuf;
+    XDAS_Int32              status;
+} Venc1_Call;
+
 typedef struct Venc1_Object {
     VIDENC1_Handle          hEncode;
     IVIDEO1_BufDesc         reconBufs;
@@ -59,8 +75,29 @@ typedef struct Venc1_Object {
     BufTab_Handle           hInBufTab;
     Buffer_Handle           hFreeBuf;
     VIDENC1_DynamicParams   dynParams;
+    Engine_Handle           hEngine;
+    Ptr                    *regBufs;
+    Int                    *regSizes;
+    Int                     numRegBufs;
+    struct Venc1_PoolEntry *poolEntry;
+    Venc1_Call              call;
+    Bool                    callPending;
 } Venc1_Object;
 
+/* A codec instance created by Venc1_preCreate, to be leased by Venc1_create */
+typedef struct Venc1_PoolEntry {
+    struct Venc1_PoolEntry *next;
+    Engine_Handle           hEngine;
+    Char                   *codecName;
+    VIDENC1_Params         *params;
+    VIDENC1_Handle          hEncode;
+    Bool                    inUse;
+    Bool                    retired;
+} Venc1_PoolEntry;
+
+static Venc1_PoolEntry     *pool = NULL;
+static Sem_Handle           poolSem = NULL;
+
 const VIDENC1_Params Venc1_Params_DEFAULT = {
     sizeof(VIDENC1_Params),           /* size */
     XDM_DEFAULT,                      /* encodingPreset */
@@ -92,18 +129,12 @@ const VIDENC1_DynamicParams Venc1_DynamicParams_DEFAULT = {
 };
 
 /******************************************************************************
- * Venc1_process
+ * prepareCall
  ******************************************************************************/
-Int Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf, Buffer_Handle hOutBuf)
+static Int prepareCall(Venc1_Handle hVe, Buffer_Handle hInBuf,
+                       Buffer_Handle hOutBuf, Venc1_Call *call)
 {
-    IVIDEO1_BufDescIn       inBufDesc;
-    XDM_BufDesc             outBufDesc;
-    XDAS_Int32              outBufSizeArray[1];
-    XDAS_Int32              status;
-    VIDENC1_InArgs          inArgs;
-    VIDENC1_OutArgs         outArgs;
     XDAS_Int8              *inPtr;
-    XDAS_Int8              *outPtr;
     BufferGfx_Dimensions    dim;
     UInt32                  offset = 0;
     Uint32                  bpp;
@@ -124,66 +155,88 @@ Int Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf, Buffer_Handle hOutBuf)
     offset = (dim.y * dim.lineLength) + (dim.x * (bpp >> 3));
     assert(offset < Buffer_getSize(hInBuf));
 
-    inPtr  = Buffer_getUserPtr(hInBuf)  + offset;
-    outPtr = Buffer_getUserPtr(hOutBuf);
+    inPtr        = Buffer_getUserPtr(hInBuf)  + offset;
+    call->outPtr = Buffer_getUserPtr(hOutBuf);
 
     /* Set up the codec buffer dimensions */
-    inBufDesc.frameWidth                = dim.width;
-    inBufDesc.frameHeight               = dim.height;
-    inBufDesc.framePitch                = dim.lineLength;
+    call->inBufDesc.frameWidth              = dim.width;
+    call->inBufDesc.frameHeight             = dim.height;
+    call->inBufDesc.framePitch              = dim.lineLength;
 
     /* Point to the color planes depending on color space format */
     if (BufferGfx_getColorSpace(hInBuf) == ColorSpace_YUV420PSEMI) {
-        inBufDesc.bufDesc[0].bufSize    = hVe->minInBufSize[0];
-        inBufDesc.bufDesc[1].bufSize    = hVe->minInBufSize[1];
+        call->inBufDesc.bufDesc[0].bufSize  = hVe->minInBufSize[0];
+        call->inBufDesc.bufDesc[1].bufSize  = hVe->minInBufSize[1];
 
-        inBufDesc.bufDesc[0].buf        = inPtr;
-        inBufDesc.bufDesc[1].buf        = inPtr + Buffer_getSize(hInBuf) * 2/3;
-        inBufDesc.numBufs               = 2;
+        call->inBufDesc.bufDesc[0].buf      = inPtr;
+        call->inBufDesc.bufDesc[1].buf      = inPtr +
+                                              Buffer_getSize(hInBuf) * 2/3;
+        call->inBufDesc.numBufs             = 2;
     }
     else if (BufferGfx_getColorSpace(hInBuf) == ColorSpace_UYVY) {
-        inBufDesc.bufDesc[0].bufSize    = Buffer_getSize(hInBuf);
-        inBufDesc.bufDesc[0].buf        = inPtr;
-        inBufDesc.numBufs               = 1;
+        call->inBufDesc.bufDesc[0].bufSize  = Buffer_getSize(hInBuf);
+        call->inBufDesc.bufDesc[0].buf      = inPtr;
+        call->inBufDesc.numBufs             = 1;
     }
     else {
         Dmai_err0("Unsupported color format of input buffer\n");
         return Dmai_EINVAL;
     }
 
-    outBufSizeArray[0]                  = Buffer_getSize(hOutBuf);
+    call->outBufSizeArray[0]                = Buffer_getSize(hOutBuf);
 
-    outBufDesc.numBufs                  = 1;
-    outBufDesc.bufs                     = &outPtr;
-    outBufDesc.bufSizes                 = outBufSizeArray;
+    call->outBufDesc.numBufs                = 1;
+    call->outBufDesc.bufs                   = &call->outPtr;
+    call->outBufDesc.bufSizes               = call->outBufSizeArray;
 
-    inArgs.size                         = sizeof(VIDENC1_InArgs);
-    inArgs.inputID                      = GETID(Buffer_getId(hInBuf));
+    call->inArgs.size                       = sizeof(VIDENC1_InArgs);
+    call->inArgs.inputID                    = GETID(Buffer_getId(hInBuf));
 
     /* topFieldFirstFlag is hardcoded. Used only for interlaced content */
-    inArgs.topFieldFirstFlag            = 1;
-    
-    outArgs.size                        = sizeof(VIDENC1_OutArgs);
+    call->inArgs.topFieldFirstFlag          = 1;
 
-    /* Encode video buffer */
-    status = VIDENC1_process(hVe->hEncode, &inBufDesc, &outBufDesc, &inArgs,
-                             &outArgs);
+    call->outArgs.size                      = sizeof(VIDENC1_OutArgs);
+
+    call->hInBuf                            = hInBuf;
+    call->hOutBuf                           = hOutBuf;
+
+    /* A remote codec accesses the buffers behind the cache of this CPU */
+    if (!VISA_isLocal((VISA_Handle)hVe->hEncode)) {
+        Buffer_cacheWb(hInBuf);
+        Buffer_cacheWb(hOutBuf);
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * completeCall
+ ******************************************************************************/
+static Int completeCall(Venc1_Handle hVe, Venc1_Call *call, XDAS_Int32 status)
+{
+    VIDENC1_OutArgs        *outArgs = &call->outArgs;
+
+    if (!VISA_isLocal((VISA_Handle)hVe->hEncode)) {
+        Buffer_setDeviceDirty(call->hOutBuf);
+    }
 
     Dmai_dbg4("VIDENC1_process() ret %d inId %d outID %d generated %d bytes\n",
-        status, Buffer_getId(hInBuf), outArgs.outputID, outArgs.bytesGenerated);
+        status, Buffer_getId(call->hInBuf), outArgs->outputID,
+        outArgs->bytesGenerated);
 
     if (status != VIDENC1_EOK) {
         Dmai_err2("VIDENC1_process() failed with error (%d ext: 0x%x)\n",
-                  (Int)status, (Uns) outArgs.extendedError);
+                  (Int)status, (Uns) outArgs->extendedError);
         return Dmai_EFAIL;
     }
-   
+
     /* if memTab was used for input buffers */
     if(hVe->hInBufTab != NULL) {
         /* One buffer is freed when output content is generated */
-        if(outArgs.bytesGenerated>0) {
+        if(outArgs->bytesGenerated>0) {
             /* Buffer released by the encoder */
-            hVe->hFreeBuf = BufTab_getBuf(hVe->hInBufTab, GETIDX(outArgs.outputID));
+            hVe->hFreeBuf = BufTab_getBuf(hVe->hInBufTab,
+                                          GETIDX(outArgs->outputID));
         }
         else {
             hVe->hFreeBuf = NULL;
@@ -191,7 +244,7 @@ Int Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf, Buffer_Handle hOutBuf)
     }
 
     /* Copy recon buffer information so we can retrieve it later */
-    hVe->reconBufs = outArgs.reconBufs;
+    hVe->reconBufs = outArgs->reconBufs;
 
     /*
      * Setting the frame type in the input buffer even through it's a property
@@ -199,13 +252,328 @@ Int Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf, Buffer_Handle hOutBuf)
      * when byte and display order are not the same the frame type will get
      * out of sync.
      */
-    BufferGfx_setFrameType(hInBuf, outArgs.encodedFrameType);
+    BufferGfx_setFrameType(call->hInBuf, outArgs->encodedFrameType);
+
+    Buffer_setNumBytesUsed(call->hOutBuf, outArgs->bytesGenerated);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Venc1_process
+ ******************************************************************************/
+Int Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf, Buffer_Handle hOutBuf)
+{
+    Venc1_Call              call;
+    XDAS_Int32              status;
+    Int                     ret;
+
+    assert(hVe);
+    assert(!hVe->callPending);
+
+    ret = prepareCall(hVe, hInBuf, hOutBuf, &call);
+
+    if (ret != Dmai_EOK) {
+        return ret;
+    }
+
+    /* Encode video buffer */
+    status = VIDENC1_process(hVe->hEncode, &call.inBufDesc, &call.outBufDesc,
+                             &call.inArgs, &call.outArgs);
+
+    return completeCall(hVe, &call, status);
+}
+
+/******************************************************************************
+ * Venc1_processAsync
+ ******************************************************************************/
+Int Venc1_processAsync(Venc1_Handle hVe, Buffer_Handle hInBuf,
+                       Buffer_Handle hOutBuf)
+{
+    Venc1_Call             *call;
+    XDAS_Int32              status;
+    Int                     ret;
+
+    assert(hVe);
+
+    if (hVe->callPending) {
+        Dmai_err0("Previous Venc1_processAsync() has not been waited for\n");
+        return Dmai_EINVAL;
+    }
+
+    call = &hVe->call;
+
+    ret = prepareCall(hVe, hInBuf, hOutBuf, call);
+
+    if (ret != Dmai_EOK) {
+        return ret;
+    }
+
+    if (VISA_isLocal((VISA_Handle)hVe->hEncode)) {
+        /* A local codec runs in this thread, so just encode it now */
+        call->status = VIDENC1_process(hVe->hEncode, &call->inBufDesc,
+                                       &call->outBufDesc, &call->inArgs,
+                                       &call->outArgs);
+    }
+    else {
+        status = VIDENC1_processAsync(hVe->hEncode, &call->inBufDesc,
+                                      &call->outBufDesc, &call->inArgs,
+                                      &call->outArgs);
+
+        if (status != VIDENC1_EOK) {
+            Dmai_err1("VIDENC1_processAsync() failed with error (%d)\n",
+                      (Int)status);
+            return Dmai_EFAIL;
+        }
+    }
+
+    hVe->callPending = TRUE;
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Venc1_wait
+ ******************************************************************************/
+Int Venc1_wait(Venc1_Handle hVe, UInt timeout)
+{
+    Venc1_Call             *call;
+    XDAS_Int32              status;
+
+    assert(hVe);
+
+    if (!hVe->callPending) {
+        Dmai_err0("No Venc1_processAsync() to wait for\n");
+        return Dmai_EINVAL;
+    }
+
+    call = &hVe->call;
+
+    if (VISA_isLocal((VISA_Handle)hVe->hEncode)) {
+        status = call->status;
+    }
+    else {
+        status = VIDENC1_processWait(hVe->hEncode, &call->inBufDesc,
+                                     &call->outBufDesc, &call->inArgs,
+                                     &call->outArgs, timeout);
+
+        if (status == VIDENC1_ETIMEOUT) {
+            return Dmai_ETIMEOUT;
+        }
+    }
+
+    hVe->callPending = FALSE;
+
+    return completeCall(hVe, call, status);
+}
+
+/******************************************************************************
+ * Venc1_processMulti
+ ******************************************************************************/
+Int Venc1_processMulti(Venc1_Job *jobs, Int numJobs)
+{
+    Int i;
+    Int ret = Dmai_EOK;
+
+    assert(jobs);
+
+    /*
+     * Submit every job before waiting for any of them, so a codec server
+     * can run them back to back instead of waiting for this thread between
+     * each one.
+     */
+    for (i = 0; i < numJobs; i++) {
+        jobs[i].status = Venc1_processAsync(jobs[i].hVe, jobs[i].hInBuf,
+                                            jobs[i].hOutBuf);
+    }
+
+    for (i = 0; i < numJobs; i++) {
+        if (jobs[i].status == Dmai_EOK) {
+            jobs[i].status = Venc1_wait(jobs[i].hVe, VIDENC1_FOREVER);
+        }
+
+        if (jobs[i].status < 0) {
+            ret = Dmai_EFAIL;
+        }
+    }
+
+    return ret;
+}
+
+/******************************************************************************
+ * registerBufTab
+ ******************************************************************************/
+static Void registerBufTab(Venc1_Handle hVe, BufTab_Handle hBufTab)
+{
+    Buffer_Handle hBuf;
+    Int           numBufs;
+    Int           i;
+
+    numBufs = BufTab_getNumBufs(hBufTab);
+    hVe->regBufs = malloc(numBufs * sizeof(Ptr));
+    hVe->regSizes = malloc(numBufs * sizeof(Int));
+
+    if (hVe->regBufs == NULL || hVe->regSizes == NULL) {
+        Dmai_dbg0("Failed to allocate space for the registered buffers\n");
+        goto fail;
+    }
+
+    for (i = 0; i < numBufs; i++) {
+        hBuf = BufTab_getBuf(hBufTab, i);
+        hVe->regBufs[i] = Buffer_getUserPtr(hBuf);
+        hVe->regSizes[i] = Buffer_getSize(hBuf);
+    }
+
+    /* Let the codec stubs skip address translation for these buffers */
+    if (Engine_registerBufs(hVe->hEngine, hVe->regBufs, hVe->regSizes,
+                            numBufs) != Engine_EOK) {
+        Dmai_dbg0("Could not register BufTab with the engine, buffers will "
+                  "be translated on each process call\n");
+        goto fail;
+    }
+
+    hVe->numRegBufs = numBufs;
+
+    return;
+
+fail:
+    free(hVe->regBufs);
+    free(hVe->regSizes);
+    hVe->regBufs = NULL;
+    hVe->regSizes = NULL;
+}
 
-    Buffer_setNumBytesUsed(hOutBuf, outArgs.bytesGenerated);
+/******************************************************************************
+ * unregisterBufTab
+ ******************************************************************************/
+static Void unregisterBufTab(Venc1_Handle hVe)
+{
+    if (hVe->numRegBufs > 0) {
+        Engine_unregisterBufs(hVe->hEngine, hVe->regBufs, hVe->regSizes,
+                              hVe->numRegBufs);
+    }
+
+    free(hVe->regBufs);
+    free(hVe->regSizes);
+    hVe->regBufs = NULL;
+    hVe->regSizes = NULL;
+    hVe->numRegBufs = 0;
+}
+
+/******************************************************************************
+ * lockPool
+ ******************************************************************************/
+static Int lockPool(Void)
+{
+    if (_Pool_lock(&poolSem) != Dmai_EOK) {
+        Dmai_err0("Failed to lock the instance pool\n");
+        return Dmai_EFAIL;
+    }
 
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * unlockPool
+ ******************************************************************************/
+static Void unlockPool(Void)
+{
+    _Pool_unlock(&poolSem);
+}
+
+/******************************************************************************
+ * leaseInstance
+ ******************************************************************************/
+static Venc1_PoolEntry *leaseInstance(Engine_Handle hEngine, Char *codecName,
+                                      VIDENC1_Params *params)
+{
+    Venc1_PoolEntry *entry;
+
+    if (lockPool() != Dmai_EOK) {
+        return NULL;
+    }
+
+    for (entry = pool; entry != NULL; entry = entry->next) {
+        if (!entry->inUse && !entry->retired && entry->hEngine == hEngine &&
+            strcmp(entry->codecName, codecName) == 0 &&
+            entry->params->size == params->size &&
+            memcmp(entry->params, params, params->size) == 0) {
+
+            entry->inUse = TRUE;
+            break;
+        }
+    }
+
+    unlockPool();
+
+    return entry;
+}
+
+/******************************************************************************
+ * freeEntry
+ ******************************************************************************/
+static Void freeEntry(Venc1_PoolEntry *entry)
+{
+    if (entry->hEncode) {
+        VIDENC1_delete(entry->hEncode);
+    }
+
+    free(entry->codecName);
+    free(entry->params);
+    free(entry);
+}
+
+/******************************************************************************
+ * releaseInstance
+ ******************************************************************************/
+static Void releaseInstance(Venc1_PoolEntry *entry)
+{
+    Venc1_PoolEntry **prev;
+    Bool           retired;
+
+    if (lockPool() != Dmai_EOK) {
+        return;
+    }
+
+    retired = entry->retired;
+
+    if (retired) {
+        /* The pool was deleted while the instance was leased */
+        for (prev = &pool; *prev != entry; prev = &(*prev)->next) {
+        }
+        *prev = entry->next;
+    }
+    else {
+        entry->inUse = FALSE;
+    }
+
+    unlockPool();
+
+    if (retired) {
+        freeEntry(entry);
+    }
+}
+
+/******************************************************************************
+ * discardInstance
+ ******************************************************************************/
+static Void discardInstance(Venc1_PoolEntry *entry)
+{
+    Venc1_PoolEntry **prev;
+
+    if (lockPool() != Dmai_EOK) {
+        return;
+    }
+
+    for (prev = &pool; *prev != entry; prev = &(*prev)->next) {
+    }
+    *prev = entry->next;
+
+    unlockPool();
+
+    freeEntry(entry);
+}
+
 /******************************************************************************
  * Venc1_create
  ******************************************************************************/
@@ -217,6 +585,10 @@ Venc1_Handle Venc1_create(Engine_Handle hEngine, Char *codecName,
     VIDENC1_Status          encStatus;
     XDAS_Int32              status;
     VIDENC1_Handle          hEncode;
+    Venc1_PoolEntry        *entry;
+    Time_Attrs              tAttrs = Time_Attrs_DEFAULT;
+    Time_Handle             hTime;
+    UInt32                  createTime;
 
     if (hEngine == NULL || codecName == NULL ||
         params == NULL || dynParams == NULL) {
@@ -237,12 +609,56 @@ Venc1_Handle Venc1_create(Engine_Handle hEngine, Char *codecName,
               codecName, params->maxWidth, params->maxHeight,
               params->maxBitRate, params->rateControlPreset);
 
-    /* Create video encoder instance */
-    hEncode = VIDENC1_create(hEngine, codecName, params);
+    encStatus.size = sizeof(VIDENC1_Status);
+    encStatus.data.buf = NULL;
+
+    /* Time getting an instance, to see what the pool and zeroing policy save */
+    hTime = Time_create(&tAttrs);
+
+    if (hTime) {
+        Time_reset(hTime);
+    }
+
+    /* Lease a pre-created instance with the same params if there is one */
+    entry = leaseInstance(hEngine, codecName, params);
+
+    hEncode = NULL;
+
+    if (entry) {
+        status = VIDENC1_control(entry->hEncode, XDM_RESET, dynParams,
+                                 &encStatus);
+
+        if (status == VIDENC1_EOK) {
+            hEncode = entry->hEncode;
+        }
+        else {
+            /* Never pool a codec in an unknown state, start from a new one */
+            Dmai_err1("XDM_RESET failed, status=%d\n", status);
+            discardInstance(entry);
+            entry = NULL;
+        }
+    }
+
+    if (entry == NULL) {
+        /* Create video encoder instance */
+        hEncode = VIDENC1_create(hEngine, codecName, params);
+
+        if (hEncode == NULL) {
+            Dmai_err2("Failed to open video encode algorithm: %s (0x%x)\n",
+                     codecName, Engine_getLastError(hEngine));
+        }
+    }
+
+    if (hTime) {
+        if (hEncode && Time_delta(hTime, &createTime) == Dmai_EOK) {
+            Dmai_dbg3("Video encoder %s ready in %u us (%s)\n", codecName,
+                      (Uns) createTime, entry ? "from pool" : "created");
+        }
+
+        Time_delete(hTime);
+    }
 
     if (hEncode == NULL) {
-        Dmai_err2("Failed to open video encode algorithm: %s (0x%x)\n",
-                 codecName, Engine_getLastError(hEngine));
         free(hVe);
         return NULL;
     }
@@ -252,14 +668,16 @@ Venc1_Handle Venc1_create(Engine_Handle hEngine, Char *codecName,
              dynParams->targetBitRate);
 
     /* Set video encoder dynamic parameters */
-    encStatus.size = sizeof(VIDENC1_Status);
-    encStatus.data.buf = NULL;
-
     status = VIDENC1_control(hEncode, XDM_SETPARAMS, dynParams, &encStatus);
 
     if (status != VIDENC1_EOK) {
         Dmai_err1("XDM_SETPARAMS failed, status=%d\n", status);
-        VIDENC1_delete(hEncode);
+        if (entry) {
+            releaseInstance(entry);
+        }
+        else {
+            VIDENC1_delete(hEncode);
+        }
         free(hVe);
         return NULL;
     }
@@ -273,7 +691,12 @@ Venc1_Handle Venc1_create(Engine_Handle hEngine, Char *codecName,
 
     if (status != VIDENC1_EOK) {
         Dmai_err0("XDM_GETBUFINFO control failed\n");
-        VIDENC1_delete(hEncode);
+        if (entry) {
+            releaseInstance(entry);
+        }
+        else {
+            VIDENC1_delete(hEncode);
+        }
         free(hVe);
         return NULL;
     }
@@ -287,6 +710,8 @@ Venc1_Handle Venc1_create(Engine_Handle hEngine, Char *codecName,
     hVe->minNumOutBufs = encStatus.bufInfo.minNumOutBufs;
 
     hVe->hEncode = hEncode;
+    hVe->hEngine = hEngine;
+    hVe->poolEntry = entry;
 
     return hVe;
 }
@@ -297,7 +722,18 @@ Venc1_Handle Venc1_create(Engine_Handle hEngine, Char *codecName,
 Int Venc1_delete(Venc1_Handle hVe)
 {
     if (hVe) {
-        if (hVe->hEncode) {
+        if (hVe->callPending) {
+            /* Don't leave the codec reading from buffers about to be freed */
+            Venc1_wait(hVe, VIDENC1_FOREVER);
+        }
+
+        unregisterBufTab(hVe);
+
+        if (hVe->poolEntry) {
+            /* Hand the instance back to the pool for the next create */
+            releaseInstance(hVe->poolEntry);
+        }
+        else if (hVe->hEncode) {
             VIDENC1_delete(hVe->hEncode);
         }
 
@@ -307,6 +743,107 @@ Int Venc1_delete(Venc1_Handle hVe)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * Venc1_preCreate
+ ******************************************************************************/
+Int Venc1_preCreate(Engine_Handle hEngine, Char *codecName,
+                    VIDENC1_Params *params, Int numInstances)
+{
+    Venc1_PoolEntry *entry;
+    Int              i;
+
+    if (hEngine == NULL || codecName == NULL || params == NULL ||
+        numInstances < 0) {
+        Dmai_err0("Cannot pass null for engine, codec name or params\n");
+        return Dmai_EINVAL;
+    }
+
+    for (i = 0; i < numInstances; i++) {
+        entry = calloc(1, sizeof(Venc1_PoolEntry));
+
+        if (entry == NULL) {
+            Dmai_err0("Failed to allocate space for pool entry\n");
+            return Dmai_ENOMEM;
+        }
+
+        entry->hEngine = hEngine;
+        entry->codecName = malloc(strlen(codecName) + 1);
+        entry->params = malloc(params->size);
+
+        if (entry->codecName == NULL || entry->params == NULL) {
+            Dmai_err0("Failed to allocate space for pool entry\n");
+            freeEntry(entry);
+            return Dmai_ENOMEM;
+        }
+
+        strcpy(entry->codecName, codecName);
+        memcpy(entry->params, params, params->size);
+
+        entry->hEncode = VIDENC1_create(hEngine, codecName, params);
+
+        if (entry->hEncode == NULL) {
+            Dmai_err0("Failed to open video encode algorithm\n");
+            freeEntry(entry);
+            return Dmai_EFAIL;
+        }
+
+        if (lockPool() != Dmai_EOK) {
+            freeEntry(entry);
+            return Dmai_EFAIL;
+        }
+
+        entry->next = pool;
+        pool = entry;
+        unlockPool();
+    }
+
+    Dmai_dbg2("Added %d instances of %s to the pool\n", numInstances,
+              codecName);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Venc1_deletePool
+ ******************************************************************************/
+Int Venc1_deletePool(Engine_Handle hEngine)
+{
+    Venc1_PoolEntry **prev;
+    Venc1_PoolEntry  *entry;
+    Venc1_PoolEntry  *idle = NULL;
+
+    if (lockPool() != Dmai_EOK) {
+        return Dmai_EFAIL;
+    }
+
+    prev = &pool;
+    while ((entry = *prev) != NULL) {
+        if (hEngine != NULL && entry->hEngine != hEngine) {
+            prev = &entry->next;
+        }
+        else if (entry->inUse) {
+            /* Deleted by Venc1_delete when it comes back */
+            entry->retired = TRUE;
+            prev = &entry->next;
+        }
+        else {
+            *prev = entry->next;
+            entry->next = idle;
+            idle = entry;
+        }
+    }
+
+    unlockPool();
+
+    while (idle) {
+        entry = idle;
+        idle = idle->next;
+        freeEntry(entry);
+    }
+
+    return Dmai_EOK;
+}
+
 /******************************************************************************
  * Venc1_getInBufSize
  ******************************************************************************/
@@ -361,7 +898,13 @@ Void Venc1_setBufTab(Venc1_Handle hVe, BufTab_Handle hBufTab)
 {
     assert(hVe);
 
+    unregisterBufTab(hVe);
+
     hVe->hInBufTab = hBufTab;
+
+    if (hBufTab) {
+        registerBufTab(hVe, hBufTab);
+    }
 }
 
 /******************************************************************************
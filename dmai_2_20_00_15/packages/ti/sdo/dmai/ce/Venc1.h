@@ -94,6 +94,23 @@ extern const VIDENC1_Params Venc1_Params_DEFAULT;
  */
 extern const VIDENC1_DynamicParams Venc1_DynamicParams_DEFAULT;
 
+/**
+ * @brief       One encode in a #Venc1_processMulti batch.
+ */
+typedef struct Venc1_Job {
+    /** @brief Encoder to run the job on. */
+    Venc1_Handle    hVe;
+
+    /** @brief Buffer containing the raw frame to encode. */
+    Buffer_Handle   hInBuf;
+
+    /** @brief Buffer to write the encoded frame to. */
+    Buffer_Handle   hOutBuf;
+
+    /** @brief Set to what #Venc1_process would have returned for the job. */
+    Int             status;
+} Venc1_Job;
+
 #if defined (__cplusplus)
 extern "C" {
 #endif
@@ -141,6 +158,65 @@ extern Venc1_Handle Venc1_create(Engine_Handle hEngine,
 extern Int Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf,
                          Buffer_Handle hOutBuf);
 
+/**
+ * @brief       Starts encoding a video buffer without waiting for the
+ *              result. The encode is finished by #Venc1_wait.
+ *
+ * @param[in]   hVe         The #Venc1_Handle to encode with.
+ * @param[in]   hInBuf      The #Buffer_Handle for the buffer containing the
+ *                          raw data.
+ * @param[in]   hOutBuf     The #Buffer_Handle for the buffer to write the
+ *                          encoded data to.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     #Venc1_create must be called before this function.
+ * @remarks     Neither buffer may be touched until #Venc1_wait has returned
+ *              something other than Dmai_ETIMEOUT, and no other Venc1 call
+ *              may be made on @c hVe in between.
+ * @remarks     If the codec is local (not on a codec server), the encode
+ *              runs to completion in this call.
+ */
+extern Int Venc1_processAsync(Venc1_Handle hVe, Buffer_Handle hInBuf,
+                              Buffer_Handle hOutBuf);
+
+/**
+ * @brief       Waits for the encode started by #Venc1_processAsync to
+ *              finish.
+ *
+ * @param[in]   hVe         The #Venc1_Handle to wait on.
+ * @param[in]   timeout     How long to wait, in the units of
+ *                          VIDENC1_processWait(). Use VIDENC1_FOREVER to
+ *                          block until the encode is done.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      Dmai_ETIMEOUT if the encode has not finished yet.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     On success the output buffer, free buffer and
+ *              reconstruction buffers are updated as by #Venc1_process.
+ */
+extern Int Venc1_wait(Venc1_Handle hVe, UInt timeout);
+
+/**
+ * @brief       Encodes a batch of frames, typically one for each of a number
+ *              of channels, from a single thread.
+ *
+ * @param[in]   jobs        Array of jobs. The status of each job is set on
+ *                          return.
+ * @param[in]   numJobs     Number of jobs in the array.
+ *
+ * @retval      Dmai_EOK if all jobs succeeded.
+ * @retval      Dmai_EFAIL if at least one job failed, see the job status.
+ *
+ * @remarks     All jobs are submitted with #Venc1_processAsync before any is
+ *              waited for, so jobs for remote codecs run back to back on the
+ *              server. Jobs for local codecs run in turn in this call.
+ * @remarks     Each job must be for a different #Venc1_Handle.
+ */
+extern Int Venc1_processMulti(Venc1_Job *jobs, Int numJobs);
+
 /**
  * @brief       Deletes a Video Encode algorithm instance.
  *
@@ -151,6 +227,47 @@ extern Int Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf,
  */
 extern Int Venc1_delete(Venc1_Handle hVe);
 
+/**
+ * @brief       Creates idle Video Encode algorithm instances ahead of time, so
+ *              that a later #Venc1_create with the same engine, codec name and
+ *              params only has to reset an instance instead of creating one.
+ *
+ * @param[in]   hEngine      An opened engine containing the algorithm.
+ * @param[in]   codecName    The name of the algorithm to create.
+ * @param[in]   params       XDM parameters the instances are created with.
+ * @param[in]   numInstances The number of instances to add to the pool.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     #Venc1_create only leases an instance if params match byte
+ *              for byte (up to params->size), and issues XDM_RESET on it
+ *              before applying the dynamic params.
+ *              An instance which fails XDM_RESET is deleted and a new one
+ *              is created in its place.
+ * @remarks     #Venc1_delete returns a leased instance to the pool instead of
+ *              deleting it.
+ */
+extern Int Venc1_preCreate(Engine_Handle hEngine,
+                           Char *codecName,
+                           VIDENC1_Params *params,
+                           Int numInstances);
+
+/**
+ * @brief       Deletes the idle instances created by #Venc1_preCreate.
+ *
+ * @param[in]   hEngine     Only delete instances on this engine, or NULL to
+ *                          empty the whole pool.
+ *
+ * @retval      Dmai_EOK for success.
+ * @retval      "Negative value" for failure, see Dmai.h.
+ *
+ * @remarks     Instances currently leased by a Venc1 object are deleted when
+ *              that object is passed to #Venc1_delete.
+ * @remarks     Must be called before the engine is closed.
+ */
+extern Int Venc1_deletePool(Engine_Handle hEngine);
+
 /**
  * @brief       After a #Venc1_create call is made, this function can be
  *              called to figure out the total size of the required input
@@ -232,6 +349,13 @@ extern Buffer_Handle Venc1_getFreeBuf(Venc1_Handle hVe);
  * @param[in]   hBufTab     The #BufTab_Handle to give to the video encoder.
  *
  * @remarks     #Venc1_create must be called before this function.
+ *
+ * @remarks     The buffers are registered with the engine (see
+ *              Engine_registerBufs()) so that they don't need to be
+ *              translated to physical addresses on each process call.
+ *              They stay registered until the BufTab is replaced or the
+ *              Venc1 instance is deleted, so the BufTab must not be freed
+ *              while the instance is still used for processing.
  */
 
 extern Void Venc1_setBufTab(Venc1_Handle hVe, BufTab_Handle hBufTab);
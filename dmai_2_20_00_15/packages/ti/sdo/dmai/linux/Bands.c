@@ -0,0 +1,232 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Dmai.h>
+
+#include "../priv/_Bands.h"
+
+#define MODULE_NAME     "Bands"
+
+typedef struct _Bands_Object {
+    Int                 numThreads;
+    pthread_t          *threads;
+    pthread_mutex_t     mutex;
+    pthread_cond_t      start;
+    pthread_cond_t      done;
+    _Bands_Fxn          fxn;
+    Ptr                 arg;
+    Int                 numRows;
+    Int                 align;
+    Int                 numBusy;
+    Int                 numIdx;
+    UInt32              generation;
+    Bool                exit;
+} _Bands_Object;
+
+/******************************************************************************
+ * runBand
+ ******************************************************************************/
+static Void runBand(_Bands_Handle hBands, Int band)
+{
+    Int numUnits = (hBands->numRows + hBands->align - 1) / hBands->align;
+    Int first, last;
+
+    first = numUnits * band / hBands->numThreads * hBands->align;
+    last = numUnits * (band + 1) / hBands->numThreads * hBands->align;
+    last = last > hBands->numRows ? hBands->numRows : last;
+
+    if (first < last) {
+        hBands->fxn(hBands->arg, first, last);
+    }
+}
+
+/******************************************************************************
+ * workerThrFxn
+ ******************************************************************************/
+static Void *workerThrFxn(Void *arg)
+{
+    _Bands_Handle hBands = (_Bands_Handle) arg;
+    UInt32 generation;
+    Int band;
+
+    /* Start from the initial generation to pick up a job posted before now */
+    pthread_mutex_lock(&hBands->mutex);
+    band = ++hBands->numIdx;
+    generation = 0;
+
+    while (TRUE) {
+        while (!hBands->exit && hBands->generation == generation) {
+            pthread_cond_wait(&hBands->start, &hBands->mutex);
+        }
+
+        if (hBands->exit) {
+            break;
+        }
+
+        generation = hBands->generation;
+        pthread_mutex_unlock(&hBands->mutex);
+
+        runBand(hBands, band);
+
+        pthread_mutex_lock(&hBands->mutex);
+
+        if (--hBands->numBusy == 0) {
+            pthread_cond_signal(&hBands->done);
+        }
+    }
+
+    pthread_mutex_unlock(&hBands->mutex);
+
+    return NULL;
+}
+
+/******************************************************************************
+ * _Bands_create
+ ******************************************************************************/
+_Bands_Handle _Bands_create(Int numThreads)
+{
+    _Bands_Handle hBands;
+    Int i;
+
+    hBands = calloc(1, sizeof(_Bands_Object));
+
+    if (hBands == NULL) {
+        Dmai_err0("Failed to allocate space for Bands Object\n");
+        return NULL;
+    }
+
+    hBands->numThreads = numThreads < 1 ? 1 : numThreads;
+
+    pthread_mutex_init(&hBands->mutex, NULL);
+    pthread_cond_init(&hBands->start, NULL);
+    pthread_cond_init(&hBands->done, NULL);
+
+    if (hBands->numThreads == 1) {
+        return hBands;
+    }
+
+    hBands->threads = calloc(hBands->numThreads - 1, sizeof(pthread_t));
+
+    if (hBands->threads == NULL) {
+        Dmai_err0("Failed to allocate space for worker threads\n");
+        _Bands_delete(hBands);
+        return NULL;
+    }
+
+    /* The calling thread of _Bands_run works on band 0 */
+    for (i = 0; i < hBands->numThreads - 1; i++) {
+        if (pthread_create(&hBands->threads[i], NULL, workerThrFxn,
+                           hBands)) {
+            Dmai_err1("Failed to create worker thread %d\n", i);
+            hBands->numThreads = i + 1;
+            _Bands_delete(hBands);
+            return NULL;
+        }
+    }
+
+    return hBands;
+}
+
+/******************************************************************************
+ * _Bands_run
+ ******************************************************************************/
+Void _Bands_run(_Bands_Handle hBands, _Bands_Fxn fxn, Ptr arg,
+                Int numRows, Int align)
+{
+    if (hBands == NULL || hBands->numThreads == 1) {
+        fxn(arg, 0, numRows);
+        return;
+    }
+
+    pthread_mutex_lock(&hBands->mutex);
+    hBands->fxn = fxn;
+    hBands->arg = arg;
+    hBands->numRows = numRows;
+    hBands->align = align < 1 ? 1 : align;
+    hBands->numBusy = hBands->numThreads - 1;
+    hBands->generation++;
+    pthread_cond_broadcast(&hBands->start);
+    pthread_mutex_unlock(&hBands->mutex);
+
+    runBand(hBands, 0);
+
+    pthread_mutex_lock(&hBands->mutex);
+
+    while (hBands->numBusy) {
+        pthread_cond_wait(&hBands->done, &hBands->mutex);
+    }
+
+    pthread_mutex_unlock(&hBands->mutex);
+}
+
+/******************************************************************************
+ * _Bands_getNumThreads
+ ******************************************************************************/
+Int _Bands_getNumThreads(_Bands_Handle hBands)
+{
+    return hBands ? hBands->numThreads : 1;
+}
+
+/******************************************************************************
+ * _Bands_delete
+ ******************************************************************************/
+Void _Bands_delete(_Bands_Handle hBands)
+{
+    Int i;
+
+    if (hBands == NULL) {
+        return;
+    }
+
+    if (hBands->threads) {
+        pthread_mutex_lock(&hBands->mutex);
+        hBands->exit = TRUE;
+        pthread_cond_broadcast(&hBands->start);
+        pthread_mutex_unlock(&hBands->mutex);
+
+        for (i = 0; i < hBands->numThreads - 1; i++) {
+            pthread_join(hBands->threads[i], NULL);
+        }
+
+        free(hBands->threads);
+    }
+
+    pthread_cond_destroy(&hBands->done);
+    pthread_cond_destroy(&hBands->start);
+    pthread_mutex_destroy(&hBands->mutex);
+
+    free(hBands);
+}
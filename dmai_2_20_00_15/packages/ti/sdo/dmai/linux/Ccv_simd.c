@@ -0,0 +1,94 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+#include <stdio.h>
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Dmai.h>
+
+#include "../priv/_Ccv.h"
+
+#define MODULE_NAME     "Ccv"
+
+#if (defined(__ARM_NEON__) || defined(__ARM_NEON)) && !defined(__aarch64__)
+/* From the kernel's asm/hwcap.h and linux/auxvec.h */
+#define AT_HWCAP        16
+#define HWCAP_NEON      (1 << 12)
+
+/******************************************************************************
+ * getHwcap
+ ******************************************************************************/
+static UInt32 getHwcap(Void)
+{
+    unsigned long entry[2];
+    UInt32        hwcap = 0;
+    FILE         *fp;
+
+    fp = fopen("/proc/self/auxv", "rb");
+
+    if (fp == NULL) {
+        Dmai_err0("Failed to open /proc/self/auxv\n");
+        return 0;
+    }
+
+    while (fread(entry, sizeof(entry), 1, fp) == 1 && entry[0] != 0) {
+        if (entry[0] == AT_HWCAP) {
+            hwcap = entry[1];
+            break;
+        }
+    }
+
+    fclose(fp);
+
+    return hwcap;
+}
+#endif
+
+/******************************************************************************
+ * _Ccv_simdSupported
+ ******************************************************************************/
+Bool _Ccv_simdSupported(Void)
+{
+#if defined(__aarch64__)
+    /* Advanced SIMD is mandatory on ARMv8 */
+    return TRUE;
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    /* The toolchain may target NEON on a core without it (e.g. ARM9) */
+    return getHwcap() & HWCAP_NEON ? TRUE : FALSE;
+#elif defined(__SSE2__)
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("sse2") ? TRUE : FALSE;
+#else
+    return FALSE;
+#endif
+}
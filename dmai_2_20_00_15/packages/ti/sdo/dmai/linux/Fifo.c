@@ -31,8 +31,15 @@
  * --/COPYRIGHT--*/
 
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
 #include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include <xdc/std.h>
 
@@ -41,17 +48,403 @@
 
 #define MODULE_NAME     "Fifo"
 
+/* Ring size used for Fifo_Mode_RING if attrs->maxElems is not set */
+#define RING_DEFAULT_ELEMS  32
+
 typedef struct Fifo_Object {
     pthread_mutex_t mutex;
     Int             numBufs;
     Int16           flush;
     Int             pipes[2];
+    Int             flushPipes[2];  /* Wakes Fifo_get() up on a flush */
+    Fifo_Mode       mode;
+
+    /* Fifo_Mode_RING only */
+    Ptr            *ring;       /* Ring of ringMask + 1 elements */
+    UInt32          ringMask;
+    volatile UInt32 head;       /* Next slot to write, owned by producer */
+    volatile UInt32 tail;       /* Next slot to read, owned by consumer */
+    volatile Int32  getSeq;     /* Futex word the consumer waits on */
+    volatile Int32  putSeq;     /* Futex word the producer waits on */
+    volatile Int32  getWaiting; /* Consumer is (about to be) blocked */
+    volatile Int32  putWaiting; /* Producer is (about to be) blocked */
 } Fifo_Object;
 
 const Fifo_Attrs Fifo_Attrs_DEFAULT = {
-    0
+    0,
+    Fifo_Mode_PIPE
 };
 
+/******************************************************************************
+ * setDeadline
+ ******************************************************************************/
+static Void setDeadline(struct timespec *deadline, UInt32 timeout)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+
+    deadline->tv_sec  += timeout / 1000000;
+    deadline->tv_nsec += (timeout % 1000000) * 1000;
+
+    if (deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+/******************************************************************************
+ * getRemaining
+ ******************************************************************************/
+static Bool getRemaining(struct timespec *deadline, struct timespec *remaining)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    remaining->tv_sec  = deadline->tv_sec - now.tv_sec;
+    remaining->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+
+    if (remaining->tv_nsec < 0) {
+        remaining->tv_sec--;
+        remaining->tv_nsec += 1000000000;
+    }
+
+    return remaining->tv_sec >= 0;
+}
+
+/******************************************************************************
+ * futexWait
+ ******************************************************************************/
+static Int futexWait(volatile Int32 *addr, Int32 val, struct timespec *deadline)
+{
+    struct timespec remaining;
+
+    if (deadline && !getRemaining(deadline, &remaining)) {
+        return Dmai_ETIMEOUT;
+    }
+
+    /* EAGAIN (value changed) and EINTR both mean the caller should recheck */
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val,
+            deadline ? &remaining : NULL, NULL, 0);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * futexWake
+ ******************************************************************************/
+static Void futexWake(volatile Int32 *addr, Int numWaiters)
+{
+    __sync_fetch_and_add(addr, 1);
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, numWaiters, NULL, NULL, 0);
+}
+
+/******************************************************************************
+ * ringCreate
+ ******************************************************************************/
+static Int ringCreate(Fifo_Handle hFifo, Int maxElems)
+{
+    UInt32 numElems = 1;
+
+    if (maxElems <= 0) {
+        maxElems = RING_DEFAULT_ELEMS;
+    }
+
+    while (numElems < (UInt32) maxElems) {
+        numElems <<= 1;
+    }
+
+    hFifo->ring = calloc(numElems, sizeof(Ptr));
+
+    if (hFifo->ring == NULL) {
+        Dmai_err1("Failed to allocate ring of %u elements\n", (Uns) numElems);
+        return Dmai_ENOMEM;
+    }
+
+    hFifo->ringMask = numElems - 1;
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * ringGet
+ ******************************************************************************/
+static Int ringGet(Fifo_Handle hFifo, Ptr ptrs[], Int maxPtrs, Int *numPtrs,
+                   UInt32 timeout)
+{
+    struct timespec  deadline;
+    UInt32           tail = hFifo->tail;
+    UInt32           numAvail;
+    Int32            seq;
+    UInt32           i;
+
+    *numPtrs = 0;
+
+    /* If fifo is already flushed, do not block */
+    if (hFifo->flush) {
+        return Dmai_EFLUSH;
+    }
+
+    if (timeout != Fifo_FOREVER && hFifo->head == tail) {
+        if (timeout == Fifo_POLL) {
+            return Dmai_ETIMEOUT;
+        }
+
+        setDeadline(&deadline, timeout);
+    }
+
+    while (hFifo->head == tail) {
+        /*
+         * Announce that we are about to sleep, then recheck the ring. The
+         * full barrier pairs with the one in ringPut so that either we see
+         * the new element or the producer sees getWaiting and wakes us.
+         */
+        seq = hFifo->getSeq;
+        hFifo->getWaiting = TRUE;
+        __sync_synchronize();
+
+        if (hFifo->head == tail && !hFifo->flush) {
+            if (futexWait(&hFifo->getSeq, seq, timeout == Fifo_FOREVER ?
+                          NULL : &deadline) == Dmai_ETIMEOUT) {
+                hFifo->getWaiting = FALSE;
+                return Dmai_ETIMEOUT;
+            }
+        }
+
+        hFifo->getWaiting = FALSE;
+
+        if (hFifo->flush) {
+            hFifo->flush = FALSE;
+            return Dmai_EFLUSH;
+        }
+    }
+
+    /* Make sure the elements are read after the head index */
+    __sync_synchronize();
+
+    numAvail = hFifo->head - tail;
+    if (numAvail > (UInt32) maxPtrs) {
+        numAvail = maxPtrs;
+    }
+
+    for (i = 0; i < numAvail; i++) {
+        ptrs[i] = hFifo->ring[(tail + i) & hFifo->ringMask];
+    }
+
+    __sync_synchronize();
+    hFifo->tail = tail + numAvail;
+    __sync_synchronize();
+
+    if (hFifo->putWaiting) {
+        futexWake(&hFifo->putSeq, 1);
+    }
+
+    *numPtrs = numAvail;
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * ringPut
+ ******************************************************************************/
+static Int ringPut(Fifo_Handle hFifo, Ptr ptrs[], Int numPtrs)
+{
+    UInt32 head = hFifo->head;
+    UInt32 numFree;
+    Int32  seq;
+    UInt32 i;
+
+    while (numPtrs > 0) {
+        while (head - hFifo->tail > hFifo->ringMask) {
+            seq = hFifo->putSeq;
+            hFifo->putWaiting = TRUE;
+            __sync_synchronize();
+
+            if (head - hFifo->tail > hFifo->ringMask && !hFifo->flush) {
+                futexWait(&hFifo->putSeq, seq, NULL);
+            }
+
+            hFifo->putWaiting = FALSE;
+
+            if (hFifo->flush) {
+                return Dmai_EFLUSH;
+            }
+        }
+
+        numFree = hFifo->ringMask + 1 - (head - hFifo->tail);
+        if (numFree > (UInt32) numPtrs) {
+            numFree = numPtrs;
+        }
+
+        for (i = 0; i < numFree; i++) {
+            hFifo->ring[(head + i) & hFifo->ringMask] = ptrs[i];
+        }
+
+        /* Publish the elements before the new head index */
+        __sync_synchronize();
+        head += numFree;
+        hFifo->head = head;
+        __sync_synchronize();
+
+        if (hFifo->getWaiting) {
+            futexWake(&hFifo->getSeq, 1);
+        }
+
+        ptrs    += numFree;
+        numPtrs -= numFree;
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * pipeGet
+ ******************************************************************************/
+static Int pipeGet(Fifo_Handle hFifo, Ptr ptrs[], Int maxPtrs, Int *numPtrs,
+                   UInt32 timeout)
+{
+    struct timespec deadline;
+    struct timespec remaining;
+    struct pollfd pfd[2];
+    Int8 *bufPtr = (Int8 *) ptrs;
+    Int flush;
+    Int numBytes;
+    Int msecs;
+    Int ret;
+    Char ch;
+
+    *numPtrs = 0;
+
+    pthread_mutex_lock(&hFifo->mutex);
+    flush = hFifo->flush;
+    pthread_mutex_unlock(&hFifo->mutex);
+
+    if (flush) {
+        return Dmai_EFLUSH;
+    }
+
+    if (timeout != Fifo_FOREVER && timeout != Fifo_POLL) {
+        setDeadline(&deadline, timeout);
+    }
+
+    /*
+     * The flush marker is written to a pipe of its own, so the data pipe
+     * only ever holds whole pointers and a flush never splits a batch.
+     */
+    pfd[0].fd     = hFifo->pipes[0];
+    pfd[0].events = POLLIN;
+    pfd[1].fd     = hFifo->flushPipes[0];
+    pfd[1].events = POLLIN;
+
+    for (;;) {
+        /* Wait for the rest of the timeout only if interrupted */
+        do {
+            if (timeout == Fifo_FOREVER) {
+                msecs = -1;
+            }
+            else if (timeout == Fifo_POLL ||
+                     !getRemaining(&deadline, &remaining)) {
+                msecs = 0;
+            }
+            else {
+                msecs = remaining.tv_sec * 1000 +
+                        (remaining.tv_nsec + 999999) / 1000000;
+            }
+
+            pfd[0].revents = 0;
+            pfd[1].revents = 0;
+
+            ret = poll(pfd, 2, msecs);
+        } while (ret < 0 && errno == EINTR);
+
+        if (ret < 0) {
+            return Dmai_EIO;
+        }
+
+        if (ret == 0) {
+            return Dmai_ETIMEOUT;
+        }
+
+        if (pfd[1].revents) {
+            /* The marker may already have been taken by another Fifo_get() */
+            pthread_mutex_lock(&hFifo->mutex);
+            if (read(hFifo->flushPipes[0], &ch, 1) < 0) {
+                Dmai_dbg0("Flush marker already consumed\n");
+            }
+            hFifo->flush = FALSE;
+            pthread_mutex_unlock(&hFifo->mutex);
+
+            return Dmai_EFLUSH;
+        }
+
+        /* Another Fifo_get() may have taken the entries */
+        numBytes = read(hFifo->pipes[0], bufPtr, maxPtrs * sizeof(Ptr));
+
+        if (numBytes > 0) {
+            break;
+        }
+
+        if (numBytes == 0 || (errno != EAGAIN && errno != EINTR)) {
+            return Dmai_EIO;
+        }
+    }
+
+    /* A write larger than PIPE_BUF may be split, finish the last pointer */
+    while (numBytes % sizeof(Ptr)) {
+        ret = read(hFifo->pipes[0], bufPtr + numBytes,
+                   sizeof(Ptr) - numBytes % sizeof(Ptr));
+
+        if (ret > 0) {
+            numBytes += ret;
+        }
+        else if (ret < 0 && errno == EAGAIN) {
+            poll(pfd, 1, -1);
+        }
+        else if (ret == 0 || errno != EINTR) {
+            return Dmai_EIO;
+        }
+    }
+
+    *numPtrs = numBytes / sizeof(Ptr);
+
+    pthread_mutex_lock(&hFifo->mutex);
+    hFifo->numBufs -= *numPtrs;
+    pthread_mutex_unlock(&hFifo->mutex);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * pipePut
+ ******************************************************************************/
+static Int pipePut(Fifo_Handle hFifo, Ptr ptrs[], Int numPtrs)
+{
+    Int8 *bufPtr = (Int8 *) ptrs;
+    Int   numBytes = numPtrs * sizeof(Ptr);
+    Int   ret;
+
+    /* A blocking write only returns short if interrupted by a signal */
+    while (numBytes > 0) {
+        ret = write(hFifo->pipes[1], bufPtr, numBytes);
+
+        if (ret <= 0) {
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            return Dmai_EIO;
+        }
+
+        bufPtr   += ret;
+        numBytes -= ret;
+    }
+
+    /* Only count the entries once they can be read */
+    pthread_mutex_lock(&hFifo->mutex);
+    hFifo->numBufs += numPtrs;
+    pthread_mutex_unlock(&hFifo->mutex);
+
+    return Dmai_EOK;
+}
+
 /******************************************************************************
  * Fifo_create
  ******************************************************************************/
@@ -64,6 +457,11 @@ Fifo_Handle Fifo_create(Fifo_Attrs *attrs)
         return NULL;
     }
 
+    if (attrs->mode != Fifo_Mode_PIPE && attrs->mode != Fifo_Mode_RING) {
+        Dmai_err1("Unknown Fifo mode (%d)\n", attrs->mode);
+        return NULL;
+    }
+
     hFifo = calloc(1, sizeof(Fifo_Object));
 
     if (hFifo == NULL) {
@@ -71,10 +469,29 @@ Fifo_Handle Fifo_create(Fifo_Attrs *attrs)
         return NULL;
     }
 
-    if (pipe(hFifo->pipes)) {
+    hFifo->mode = attrs->mode;
+
+    if (hFifo->mode == Fifo_Mode_RING) {
+        if (ringCreate(hFifo, attrs->maxElems) < 0) {
+            free(hFifo);
+            return NULL;
+        }
+    }
+    else if (pipe(hFifo->pipes)) {
+        free(hFifo);
+        return NULL;
+    }
+    else if (pipe(hFifo->flushPipes)) {
+        close(hFifo->pipes[0]);
+        close(hFifo->pipes[1]);
         free(hFifo);
         return NULL;
     }
+    else {
+        /* Fifo_get() polls both pipes, the reads themselves don't block */
+        fcntl(hFifo->pipes[0], F_SETFL, O_NONBLOCK);
+        fcntl(hFifo->flushPipes[0], F_SETFL, O_NONBLOCK);
+    }
 
     pthread_mutex_init(&hFifo->mutex, NULL);
 
@@ -89,12 +506,25 @@ Int Fifo_delete(Fifo_Handle hFifo)
     int ret = Dmai_EOK;
 
     if (hFifo) {
-        if (close(hFifo->pipes[0])) {
-            ret = Dmai_EIO;
+        if (hFifo->mode == Fifo_Mode_RING) {
+            free(hFifo->ring);
         }
-
-        if (close(hFifo->pipes[1])) {
-            ret = Dmai_EIO;
+        else {
+            if (close(hFifo->pipes[0])) {
+                ret = Dmai_EIO;
+            }
+
+            if (close(hFifo->pipes[1])) {
+                ret = Dmai_EIO;
+            }
+
+            if (close(hFifo->flushPipes[0])) {
+                ret = Dmai_EIO;
+            }
+
+            if (close(hFifo->flushPipes[1])) {
+                ret = Dmai_EIO;
+            }
         }
 
         pthread_mutex_destroy(&hFifo->mutex);
@@ -110,41 +540,51 @@ Int Fifo_delete(Fifo_Handle hFifo)
  ******************************************************************************/
 Int Fifo_get(Fifo_Handle hFifo, Ptr ptrPtr)
 {
-    Int flush;
-    Int numBytes;
+    Int numPtrs;
 
     assert(hFifo);
     assert(ptrPtr);
 
-    pthread_mutex_lock(&hFifo->mutex);
-    flush = hFifo->flush;
-    pthread_mutex_unlock(&hFifo->mutex);
-
-    if (flush) {
-        return Dmai_EFLUSH;
+    if (hFifo->mode == Fifo_Mode_RING) {
+        return ringGet(hFifo, (Ptr *) ptrPtr, 1, &numPtrs, Fifo_FOREVER);
     }
 
-    numBytes = read(hFifo->pipes[0], ptrPtr, sizeof(Ptr));
+    return pipeGet(hFifo, (Ptr *) ptrPtr, 1, &numPtrs, Fifo_FOREVER);
+}
 
-    if (numBytes != sizeof(Ptr)) {
-        pthread_mutex_lock(&hFifo->mutex);
-        flush = hFifo->flush;
-        if (flush) {
-            hFifo->flush = FALSE;
-        }
-        pthread_mutex_unlock(&hFifo->mutex);
+/******************************************************************************
+ * Fifo_getTimeout
+ ******************************************************************************/
+Int Fifo_getTimeout(Fifo_Handle hFifo, Ptr ptrPtr, UInt32 timeout)
+{
+    Int numPtrs;
 
-        if (flush) {
-            return Dmai_EFLUSH;
-        }
-        return Dmai_EIO;
+    assert(hFifo);
+    assert(ptrPtr);
+
+    if (hFifo->mode == Fifo_Mode_RING) {
+        return ringGet(hFifo, (Ptr *) ptrPtr, 1, &numPtrs, timeout);
     }
 
-    pthread_mutex_lock(&hFifo->mutex);
-    hFifo->numBufs--;
-    pthread_mutex_unlock(&hFifo->mutex);
+    return pipeGet(hFifo, (Ptr *) ptrPtr, 1, &numPtrs, timeout);
+}
 
-    return Dmai_EOK;
+/******************************************************************************
+ * Fifo_getMany
+ ******************************************************************************/
+Int Fifo_getMany(Fifo_Handle hFifo, Ptr ptrs[], Int maxPtrs, Int *numPtrs,
+                 UInt32 timeout)
+{
+    assert(hFifo);
+    assert(ptrs);
+    assert(numPtrs);
+    assert(maxPtrs > 0);
+
+    if (hFifo->mode == Fifo_Mode_RING) {
+        return ringGet(hFifo, ptrs, maxPtrs, numPtrs, timeout);
+    }
+
+    return pipeGet(hFifo, ptrs, maxPtrs, numPtrs, timeout);
 }
 
 /******************************************************************************
@@ -156,12 +596,23 @@ Int Fifo_flush(Fifo_Handle hFifo)
 
     assert(hFifo);
 
+    if (hFifo->mode == Fifo_Mode_RING) {
+        hFifo->flush = TRUE;
+        __sync_synchronize();
+
+        /* Make sure any Fifo_get() or Fifo_put() calls are unblocked */
+        futexWake(&hFifo->getSeq, 1);
+        futexWake(&hFifo->putSeq, 1);
+
+        return Dmai_EOK;
+    }
+
     pthread_mutex_lock(&hFifo->mutex);
     hFifo->flush = TRUE;
     pthread_mutex_unlock(&hFifo->mutex);
 
     /* Make sure any Fifo_get() calls are unblocked */
-    if (write(hFifo->pipes[1], &ch, 1) != 1) {
+    if (write(hFifo->flushPipes[1], &ch, 1) != 1) {
         return Dmai_EIO;
     }
 
@@ -176,15 +627,30 @@ Int Fifo_put(Fifo_Handle hFifo, Ptr ptr)
     assert(hFifo);
     assert(ptr);
 
-    pthread_mutex_lock(&hFifo->mutex);
-    hFifo->numBufs++;
-    pthread_mutex_unlock(&hFifo->mutex);
+    if (hFifo->mode == Fifo_Mode_RING) {
+        return ringPut(hFifo, &ptr, 1);
+    }
 
-    if (write(hFifo->pipes[1], &ptr, sizeof(Ptr)) != sizeof(Ptr)) {
-        return Dmai_EIO;
+    return pipePut(hFifo, &ptr, 1);
+}
+
+/******************************************************************************
+ * Fifo_putMany
+ ******************************************************************************/
+Int Fifo_putMany(Fifo_Handle hFifo, Ptr ptrs[], Int numPtrs)
+{
+    assert(hFifo);
+    assert(ptrs);
+
+    if (numPtrs <= 0) {
+        return Dmai_EOK;
     }
 
-    return Dmai_EOK;
+    if (hFifo->mode == Fifo_Mode_RING) {
+        return ringPut(hFifo, ptrs, numPtrs);
+    }
+
+    return pipePut(hFifo, ptrs, numPtrs);
 }
 
 /******************************************************************************
@@ -196,10 +662,13 @@ Int Fifo_getNumEntries(Fifo_Handle hFifo)
 
     assert(hFifo);
 
+    if (hFifo->mode == Fifo_Mode_RING) {
+        return (Int) (hFifo->head - hFifo->tail);
+    }
+
     pthread_mutex_lock(&hFifo->mutex);
     numEntries = hFifo->numBufs;
     pthread_mutex_unlock(&hFifo->mutex);
 
     return numEntries;
 }
-
@@ -0,0 +1,138 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Dmai.h>
+
+#include "../priv/_Loader.h"
+
+#define MODULE_NAME     "Loader"
+
+/* Window offsets and sizes are 32 bit signed, so is the mapping */
+#define MAXMAPSIZE      0x7fffffff
+
+/******************************************************************************
+ * _Loader_mapFile
+ ******************************************************************************/
+Int _Loader_mapFile(Char *fileName, Int8 **mapPtr, Int32 *mapSize)
+{
+    struct stat st;
+    Ptr         map;
+    Int         fd;
+
+    fd = open(fileName, O_RDONLY);
+
+    if (fd == -1) {
+        Dmai_err1("Failed to open %s\n", fileName);
+        return Dmai_EIO;
+    }
+
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+
+        /* Too large for a 32 bit off_t, so surely too large to map */
+        if (errno == EOVERFLOW) {
+            Dmai_dbg1("%s is too large to be mapped\n", fileName);
+            return Dmai_ENOTIMPL;
+        }
+
+        Dmai_err1("Failed to stat %s\n", fileName);
+        return Dmai_EIO;
+    }
+
+    if (st.st_size > MAXMAPSIZE) {
+        close(fd);
+        Dmai_dbg1("%s is too large to be mapped\n", fileName);
+        return Dmai_ENOTIMPL;
+    }
+
+    /* An empty file can't be mapped, but is still a valid (empty) stream */
+    if (st.st_size == 0) {
+        close(fd);
+        *mapPtr = NULL;
+        *mapSize = 0;
+        return Dmai_EOK;
+    }
+
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    /* The mapping stays valid after the descriptor is closed */
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        Dmai_err1("Failed to map %s\n", fileName);
+        return Dmai_EIO;
+    }
+
+    /* The stream is consumed front to back, let the kernel read ahead */
+    if (madvise(map, st.st_size, MADV_SEQUENTIAL) == -1) {
+        Dmai_dbg1("madvise MADV_SEQUENTIAL failed on %s\n", fileName);
+    }
+
+    Dmai_dbg2("Mapped %d bytes of %s\n", (Int) st.st_size, fileName);
+
+    *mapPtr = (Int8 *) map;
+    *mapSize = st.st_size;
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * _Loader_unmapFile
+ ******************************************************************************/
+Int _Loader_unmapFile(Int8 *map, Int32 mapSize)
+{
+    if (map && munmap(map, mapSize) == -1) {
+        Dmai_err0("Failed to unmap file\n");
+        return Dmai_EFAIL;
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * _Loader_prefetch
+ ******************************************************************************/
+Void _Loader_prefetch(Int8 *ptr, Int32 numBytes)
+{
+    unsigned long pageMask = sysconf(_SC_PAGESIZE) - 1;
+    unsigned long start    = (unsigned long) ptr & ~pageMask;
+
+    /* Start reading the pages in without waiting for them */
+    madvise((Ptr) start, (unsigned long) ptr + numBytes - start, MADV_WILLNEED);
+}
@@ -31,12 +31,15 @@
  * --/COPYRIGHT--*/
 
 #include <stdlib.h>
+#include <time.h>
 #include <sys/time.h>
 
 #include <xdc/std.h>
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Time.h>
 
+#include "../priv/_Time.h"
+
 #define MODULE_NAME     "Time"
 
 typedef struct Time_Object {
@@ -151,3 +154,16 @@ Int Time_total(Time_Handle hTime, UInt32 *totalPtr)
     return Dmai_EOK;
 }
 
+/******************************************************************************
+ * _Time_getSemTicks
+ ******************************************************************************/
+UInt32 _Time_getSemTicks(Void)
+{
+    struct timespec ts;
+
+    /* In microseconds, on a clock which setting the date doesn't move */
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (UInt32) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
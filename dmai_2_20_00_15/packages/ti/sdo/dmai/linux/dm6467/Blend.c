@@ -72,6 +72,7 @@ const Blend_Config_Params Blend_Config_Params_DEFAULT = {
         { 0x6e, 0xf0, 0x29, 0x80, },
         { 0xde, 0xca, 0x6a, 0x40, },
     },
+    -1,
 };
 
 /******************************************************************************
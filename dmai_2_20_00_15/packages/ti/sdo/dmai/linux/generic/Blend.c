@@ -30,18 +30,431 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * --/COPYRIGHT--*/
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
 #include <ti/sdo/dmai/Blend.h>
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define MODULE_NAME     "Blend"
 
+/* Overlay bytes are classified in chunks of this size when building spans */
+#define CHUNK_SIZE      16
+
+/* A run of overlay bytes on one line which is either opaque or blended */
+typedef struct Blend_Span {
+    Int32               start;
+    Int32               length;
+    Bool                opaque;
+} Blend_Span;
+
+/*
+ * The bitmap converted to the byte layout of one plane of the video buffer,
+ * i.e. Y, interleaved CbCr or UYVY, with an alpha value for every byte.
+ * Fully transparent runs are not covered by any span and are skipped.
+ */
+typedef struct Blend_Layer {
+    UInt8              *data;
+    UInt8              *alpha;
+    Int                 lineLength;
+    Int                 numLines;
+    Blend_Span         *spans;
+    Int                *firstSpan;
+} Blend_Layer;
+
+/* Object holding the state of a Blending job. */
+typedef struct Blend_Object {
+    ColorSpace_Type     bmpColorSpace;
+    ColorSpace_Type     colorSpace;
+    Int                 width;
+    Int                 height;
+    Int                 xPos;
+    Int                 yPos;
+    Int32               colorKey;
+    UInt8               palette[4][4];
+    Int                 bmpLineBytes;
+    UInt8              *shadow;
+    Bool                converted;
+    Int                 numLayers;
+    Blend_Layer         layers[2];
+} Blend_Object;
+
+const Blend_Attrs Blend_Attrs_DEFAULT = {
+    0,
+};
+
+const Blend_Config_Params Blend_Config_Params_DEFAULT = {
+    0,
+    0,
+    {
+        { 0xf0, 0x5a, 0x51, 0xff, },
+        { 0x22, 0x36, 0x91, 0xc0, },
+        { 0x6e, 0xf0, 0x29, 0x80, },
+        { 0xde, 0xca, 0x6a, 0x40, },
+    },
+    -1,
+};
+
+/******************************************************************************
+ * cleanup
+ ******************************************************************************/
+static Void cleanup(Blend_Handle hBlend)
+{
+    Int i;
+
+    for (i = 0; i < 2; i++) {
+        free(hBlend->layers[i].data);
+        free(hBlend->layers[i].alpha);
+        free(hBlend->layers[i].spans);
+        free(hBlend->layers[i].firstSpan);
+        memset(&hBlend->layers[i], 0, sizeof(Blend_Layer));
+    }
+
+    free(hBlend->shadow);
+    hBlend->shadow = NULL;
+    hBlend->numLayers = 0;
+    hBlend->converted = FALSE;
+}
+
+/******************************************************************************
+ * initLayer
+ ******************************************************************************/
+static Int initLayer(Blend_Layer *layer, Int lineLength, Int numLines)
+{
+    Int size = lineLength * numLines;
+    Int chunks = (lineLength + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    layer->lineLength = lineLength;
+    layer->numLines = numLines;
+    layer->data = malloc(size);
+    layer->alpha = malloc(size);
+    layer->spans = malloc(chunks * numLines * sizeof(Blend_Span));
+    layer->firstSpan = malloc((numLines + 1) * sizeof(Int));
+
+    if (layer->data == NULL || layer->alpha == NULL ||
+        layer->spans == NULL || layer->firstSpan == NULL) {
+
+        Dmai_err0("Failed to allocate space for the converted bitmap\n");
+        return Dmai_ENOMEM;
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * getPixel
+ ******************************************************************************/
+static inline Void getPixel(Blend_Handle hBlend, const UInt8 *line, Int x,
+                            Int32 ycbcra[4])
+{
+    Int32 r, g, b;
+    UInt32 argb;
+    UInt16 rgb;
+    const UInt8 *entry;
+
+    switch (hBlend->bmpColorSpace) {
+        case ColorSpace_2BIT:
+            /* The first pixel is in the least significant bits */
+            entry = hBlend->palette[(line[x >> 2] >> ((x & 0x3) << 1)) & 0x3];
+            ycbcra[0] = entry[2];
+            ycbcra[1] = entry[1];
+            ycbcra[2] = entry[0];
+            ycbcra[3] = entry[3];
+            return;
+        case ColorSpace_RGB565:
+            rgb = ((const UInt16 *) line)[x];
+            r = (rgb >> 11) << 3 | (rgb >> 13);
+            g = ((rgb >> 5) & 0x3f) << 2 | ((rgb >> 9) & 0x3);
+            b = (rgb & 0x1f) << 3 | ((rgb >> 2) & 0x7);
+            ycbcra[3] = (Int32) rgb == hBlend->colorKey ? 0 : 255;
+            break;
+        default:
+            argb = ((const UInt32 *) line)[x];
+            r = (argb >> 16) & 0xff;
+            g = (argb >> 8) & 0xff;
+            b = argb & 0xff;
+            ycbcra[3] = argb >> 24;
+            break;
+    }
+
+    /* ITU-R BT.601, studio swing */
+    ycbcra[0] = 16 + ((66 * r + 129 * g + 25 * b + 128) >> 8);
+    ycbcra[1] = 128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8);
+    ycbcra[2] = 128 + ((112 * r - 94 * g - 18 * b + 128) >> 8);
+}
+
+/******************************************************************************
+ * buildSpans
+ ******************************************************************************/
+static Void buildSpans(Blend_Layer *layer)
+{
+    Blend_Span *span = layer->spans;
+    const UInt8 *alpha;
+    Int line, x, i, end, chunkType, type;
+
+    for (line = 0; line < layer->numLines; line++) {
+        layer->firstSpan[line] = span - layer->spans;
+        alpha = layer->alpha + line * layer->lineLength;
+        type = -1;
+
+        /*
+         * Chunks are transparent (0), opaque (1) or need blending (2), and
+         * neighbouring chunks of the same type are merged in to one span.
+         */
+        for (x = 0; x < layer->lineLength; x += CHUNK_SIZE) {
+            end = x + CHUNK_SIZE < layer->lineLength ?
+                  x + CHUNK_SIZE : layer->lineLength;
+            chunkType = alpha[x] == 0 ? 0 : alpha[x] == 255 ? 1 : 2;
+
+            for (i = x + 1; i < end && chunkType != 2; i++) {
+                if (alpha[i] != alpha[x]) {
+                    chunkType = 2;
+                }
+            }
+
+            if (chunkType == type) {
+                span[-1].length = end - span[-1].start;
+                continue;
+            }
+
+            type = chunkType;
+
+            if (type != 0) {
+                span->start = x;
+                span->length = end - x;
+                span->opaque = type == 1;
+                span++;
+            }
+            else {
+                /* Never merge across a transparent chunk */
+                type = -1;
+            }
+        }
+    }
+
+    layer->firstSpan[layer->numLines] = span - layer->spans;
+}
+
+/******************************************************************************
+ * convert
+ ******************************************************************************/
+static Void convert(Blend_Handle hBlend)
+{
+    Blend_Layer *luma = &hBlend->layers[0];
+    Blend_Layer *chroma = &hBlend->layers[1];
+    Int32 pix[4][4];
+    Int32 sumA, cb, cr, a;
+    const UInt8 *lines[2];
+    UInt8 *data, *alpha;
+    Int numRows, line, x, i, j;
+
+    numRows = hBlend->colorSpace == ColorSpace_YUV420PSEMI ? 2 : 1;
+
+    for (line = 0; line < hBlend->height; line += numRows) {
+        lines[0] = hBlend->shadow + line * hBlend->bmpLineBytes;
+        lines[1] = line + 1 < hBlend->height ?
+                   lines[0] + hBlend->bmpLineBytes : lines[0];
+
+        for (x = 0; x < hBlend->width; x += 2) {
+            for (j = 0; j < numRows; j++) {
+                getPixel(hBlend, lines[j], x, pix[j * 2]);
+                getPixel(hBlend, lines[j], x + 1, pix[j * 2 + 1]);
+            }
+
+            /*
+             * The chroma of a block of pixels is weighted by the alpha of
+             * each pixel, so transparent pixels don't bleed in to the edges.
+             */
+            sumA = 0;
+            cb = 0;
+            cr = 0;
+
+            for (i = 0; i < numRows * 2; i++) {
+                sumA += pix[i][3];
+                cb += pix[i][1] * pix[i][3];
+                cr += pix[i][2] * pix[i][3];
+            }
+
+            if (sumA) {
+                cb = (cb + (sumA >> 1)) / sumA;
+                cr = (cr + (sumA >> 1)) / sumA;
+            }
+            else {
+                cb = 128;
+                cr = 128;
+            }
+
+            a = (sumA + numRows) / (numRows * 2);
+
+            if (hBlend->colorSpace == ColorSpace_UYVY) {
+                data = luma->data + line * luma->lineLength + x * 2;
+                alpha = luma->alpha + line * luma->lineLength + x * 2;
+
+                data[0] = cb;
+                data[1] = pix[0][0];
+                data[2] = cr;
+                data[3] = pix[1][0];
+                alpha[0] = a;
+                alpha[1] = pix[0][3];
+                alpha[2] = a;
+                alpha[3] = pix[1][3];
+                continue;
+            }
+
+            for (j = 0; j < numRows && line + j < hBlend->height; j++) {
+                data = luma->data + (line + j) * luma->lineLength + x;
+                alpha = luma->alpha + (line + j) * luma->lineLength + x;
+
+                data[0] = pix[j * 2][0];
+                data[1] = pix[j * 2 + 1][0];
+                alpha[0] = pix[j * 2][3];
+                alpha[1] = pix[j * 2 + 1][3];
+            }
+
+            data = chroma->data + line / numRows * chroma->lineLength + x;
+            alpha = chroma->alpha + line / numRows * chroma->lineLength + x;
+
+            data[0] = cb;
+            data[1] = cr;
+            alpha[0] = a;
+            alpha[1] = a;
+        }
+    }
+
+    for (i = 0; i < hBlend->numLayers; i++) {
+        buildSpans(&hBlend->layers[i]);
+    }
+
+    hBlend->converted = TRUE;
+}
+
+/******************************************************************************
+ * blendBytes
+ ******************************************************************************/
+static Void blendBytes(UInt8 *dst, const UInt8 *ovl, const UInt8 *alpha,
+                       Int numBytes)
+{
+    UInt32 t;
+    Int x = 0;
+
+    /*
+     * dst = (ovl * alpha + dst * (255 - alpha)) / 255, where the division
+     * is done exactly and with rounding as (t + 128 + ((t + 128) >> 8)) >> 8.
+     */
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    uint16x8_t acc;
+    uint8x8_t a;
+
+    for (; x + 8 <= numBytes; x += 8) {
+        a = vld1_u8(alpha + x);
+        acc = vmull_u8(vld1_u8(ovl + x), a);
+        acc = vmlal_u8(acc, vld1_u8(dst + x), vmvn_u8(a));
+        vst1_u8(dst + x, vraddhn_u16(acc, vrshrq_n_u16(acc, 8)));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    __m128i d, o, a, lo, hi, w;
+
+    /* The 16 bit sums never exceed 65407, so unsigned wrapping is safe */
+    for (; x + 16 <= numBytes; x += 16) {
+        d = _mm_loadu_si128((const __m128i *) (dst + x));
+        o = _mm_loadu_si128((const __m128i *) (ovl + x));
+        a = _mm_loadu_si128((const __m128i *) (alpha + x));
+
+        w = _mm_unpacklo_epi8(a, zero);
+        lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(o, zero), w),
+                           _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero),
+                                           _mm_sub_epi16(full, w)));
+        lo = _mm_add_epi16(lo, half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+
+        w = _mm_unpackhi_epi8(a, zero);
+        hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(o, zero), w),
+                           _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero),
+                                           _mm_sub_epi16(full, w)));
+        hi = _mm_add_epi16(hi, half);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        _mm_storeu_si128((__m128i *) (dst + x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; x < numBytes; x++) {
+        t = ovl[x] * alpha[x] + dst[x] * (255 - alpha[x]) + 128;
+        dst[x] = (UInt8) ((t + (t >> 8)) >> 8);
+    }
+}
+
+/******************************************************************************
+ * blendLayer
+ ******************************************************************************/
+static Void blendLayer(Blend_Layer *layer, UInt8 *dst, Int32 lineLength)
+{
+    const Blend_Span *span;
+    const UInt8 *data, *alpha;
+    Int line;
+
+    for (line = 0; line < layer->numLines; line++) {
+        data = layer->data + line * layer->lineLength;
+        alpha = layer->alpha + line * layer->lineLength;
+        span = layer->spans + layer->firstSpan[line];
+
+        for (; span < layer->spans + layer->firstSpan[line + 1]; span++) {
+            if (span->opaque) {
+                memcpy(dst + span->start, data + span->start, span->length);
+            }
+            else {
+                blendBytes(dst + span->start, data + span->start,
+                           alpha + span->start, span->length);
+            }
+        }
+
+        dst += lineLength;
+    }
+}
+
+/******************************************************************************
+ * copyPlane
+ ******************************************************************************/
+static Void copyPlane(const Int8 *src, Int32 srcLineLength, Int8 *dst,
+                      Int32 dstLineLength, Int numBytes, Int numLines)
+{
+    Int line;
+
+    for (line = 0; line < numLines; line++) {
+        memcpy(dst, src, numBytes);
+        src += srcLineLength;
+        dst += dstLineLength;
+    }
+}
+
 /******************************************************************************
  * Blend_create
  ******************************************************************************/
 Blend_Handle Blend_create(Blend_Attrs *attrs)
 {
-    return NULL;
+    Blend_Handle hBlend;
+
+    hBlend = calloc(1, sizeof(Blend_Object));
+
+    if (hBlend == NULL) {
+        Dmai_err0("Failed to allocate space for Blend Object\n");
+        return NULL;
+    }
+
+    return hBlend;
 }
 
 /******************************************************************************
@@ -51,7 +464,134 @@ Int Blend_config(Blend_Handle hBlend, Ccv_Handle hCcv, Buffer_Handle hBmpBuf,
                  Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf,
                  Blend_Config_Params *params)
 {
-    return Dmai_ENOTIMPL;
+    BufferGfx_Dimensions bmpDim;
+    BufferGfx_Dimensions dstDim;
+    ColorSpace_Type      bmpColorSpace;
+    ColorSpace_Type      colorSpace;
+    Int                  width, height, i;
+    Int                  ret;
+
+    if (!hBlend || !hBmpBuf || !hSrcBuf || !hDstBuf || !params) {
+        Dmai_err0("Blend handle, buffers and params must not be NULL\n");
+        return Dmai_EINVAL;
+    }
+
+    if (hCcv) {
+        Dmai_err0("Combined color conversion and blending not supported\n");
+        return Dmai_ENOTIMPL;
+    }
+
+    /* Buffer needs to be graphics buffers */
+    if (Buffer_getType(hBmpBuf) != Buffer_Type_GRAPHICS ||
+        Buffer_getType(hSrcBuf) != Buffer_Type_GRAPHICS ||
+        Buffer_getType(hDstBuf) != Buffer_Type_GRAPHICS) {
+
+        Dmai_err0("Bitmap, src and dst buffers need to be graphics buffers\n");
+        return Dmai_EINVAL;
+    }
+
+    bmpColorSpace = BufferGfx_getColorSpace(hBmpBuf);
+    colorSpace = BufferGfx_getColorSpace(hSrcBuf);
+
+    if (bmpColorSpace != ColorSpace_ARGB8888 &&
+        bmpColorSpace != ColorSpace_RGB565 &&
+        bmpColorSpace != ColorSpace_2BIT) {
+
+        Dmai_err1("Bitmap color space %d not supported\n", bmpColorSpace);
+        return Dmai_ENOTIMPL;
+    }
+
+    if (colorSpace != BufferGfx_getColorSpace(hDstBuf)) {
+        Dmai_err0("Src and dst buffers need to have same colorspace\n");
+        return Dmai_EINVAL;
+    }
+
+    if (colorSpace != ColorSpace_YUV420PSEMI &&
+        colorSpace != ColorSpace_YUV422PSEMI &&
+        colorSpace != ColorSpace_UYVY) {
+
+        Dmai_err1("Color space %d not supported\n", colorSpace);
+        return Dmai_ENOTIMPL;
+    }
+
+    BufferGfx_getDimensions(hBmpBuf, &bmpDim);
+    BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+    if (params->bmpXpos < 0 || params->bmpXpos >= dstDim.width ||
+        params->bmpYpos < 0 || params->bmpYpos >= dstDim.height) {
+
+        Dmai_err2("Bitmap position (%ld, %ld) outside of the video buffer\n",
+                  params->bmpXpos, params->bmpYpos);
+        return Dmai_EINVAL;
+    }
+
+    /* The bitmap has to start on a chroma sample */
+    if ((params->bmpXpos & 0x1) ||
+        (colorSpace == ColorSpace_YUV420PSEMI && (params->bmpYpos & 0x1))) {
+
+        Dmai_err0("Bitmap position must be aligned to the chroma samples\n");
+        return Dmai_EINVAL;
+    }
+
+    /* Clip the bitmap to the video buffer, in whole chroma samples */
+    width = dstDim.width - params->bmpXpos;
+    width = bmpDim.width < width ? bmpDim.width : width;
+    width &= ~0x1;
+    height = dstDim.height - params->bmpYpos;
+    height = bmpDim.height < height ? bmpDim.height : height;
+
+    if (width <= 0 || height <= 0) {
+        Dmai_err0("Bitmap must be at least 2x1 pixels\n");
+        return Dmai_EINVAL;
+    }
+
+    /* Release the converted bitmap of a previous configuration */
+    cleanup(hBlend);
+
+    hBlend->bmpColorSpace = bmpColorSpace;
+    hBlend->colorSpace    = colorSpace;
+    hBlend->width         = width;
+    hBlend->height        = height;
+    hBlend->xPos          = params->bmpXpos;
+    hBlend->yPos          = params->bmpYpos;
+    hBlend->colorKey      = params->colorKey;
+    hBlend->bmpLineBytes  = (width * ColorSpace_getBpp(bmpColorSpace) + 7) / 8;
+
+    for (i = 0; i < 4; i++) {
+        hBlend->palette[i][0] = (UInt8) params->palette[i][0];
+        hBlend->palette[i][1] = (UInt8) params->palette[i][1];
+        hBlend->palette[i][2] = (UInt8) params->palette[i][2];
+        hBlend->palette[i][3] = (UInt8) params->palette[i][3];
+    }
+
+    hBlend->shadow = malloc(hBlend->bmpLineBytes * height);
+
+    if (hBlend->shadow == NULL) {
+        Dmai_err0("Failed to allocate space for the bitmap copy\n");
+        return Dmai_ENOMEM;
+    }
+
+    if (colorSpace == ColorSpace_UYVY) {
+        hBlend->numLayers = 1;
+        ret = initLayer(&hBlend->layers[0], width * 2, height);
+    }
+    else {
+        hBlend->numLayers = 2;
+        ret = initLayer(&hBlend->layers[0], width, height);
+
+        if (ret == Dmai_EOK) {
+            ret = initLayer(&hBlend->layers[1], width,
+                            colorSpace == ColorSpace_YUV420PSEMI ?
+                            (height + 1) / 2 : height);
+        }
+    }
+
+    if (ret < 0) {
+        cleanup(hBlend);
+        return ret;
+    }
+
+    return Dmai_EOK;
 }
 
 /******************************************************************************
@@ -60,7 +600,127 @@ Int Blend_config(Blend_Handle hBlend, Ccv_Handle hCcv, Buffer_Handle hBmpBuf,
 Int Blend_execute(Blend_Handle hBlend, Buffer_Handle hBmpBuf,
                   Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
-    return Dmai_ENOTIMPL;
+    BufferGfx_Dimensions bmpDim;
+    BufferGfx_Dimensions srcDim;
+    BufferGfx_Dimensions dstDim;
+    Int8                *bmp;
+    Int8                *src;
+    Int8                *dst;
+    Int32                srcChroma, dstChroma;
+    Bool                 changed;
+    Int                  line, width, height;
+
+    assert(hBlend);
+    assert(hBmpBuf);
+    assert(hSrcBuf);
+    assert(hDstBuf);
+    assert(Buffer_getUserPtr(hBmpBuf));
+    assert(Buffer_getUserPtr(hSrcBuf));
+    assert(Buffer_getUserPtr(hDstBuf));
+
+    if (hBlend->numLayers == 0) {
+        Dmai_err0("Blend job has not been configured\n");
+        return Dmai_EINVAL;
+    }
+
+    BufferGfx_getDimensions(hBmpBuf, &bmpDim);
+    BufferGfx_getDimensions(hSrcBuf, &srcDim);
+    BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+    assert(bmpDim.width >= hBlend->width);
+    assert(bmpDim.height >= hBlend->height);
+
+    /* Only convert the bitmap again if it changed since the last frame */
+    bmp = Buffer_getUserPtr(hBmpBuf);
+    changed = !hBlend->converted;
+
+    for (line = 0; line < hBlend->height && !changed; line++) {
+        changed = memcmp(bmp + line * bmpDim.lineLength,
+                         hBlend->shadow + line * hBlend->bmpLineBytes,
+                         hBlend->bmpLineBytes) != 0;
+    }
+
+    if (changed) {
+        Dmai_dbg0("Bitmap changed, converting it\n");
+
+        copyPlane(bmp, bmpDim.lineLength, (Int8 *) hBlend->shadow,
+                  hBlend->bmpLineBytes, hBlend->bmpLineBytes, hBlend->height);
+        convert(hBlend);
+    }
+
+    if (hBlend->colorSpace == ColorSpace_UYVY) {
+        src = Buffer_getUserPtr(hSrcBuf) +
+              srcDim.y * srcDim.lineLength + (srcDim.x << 1);
+        dst = Buffer_getUserPtr(hDstBuf) +
+              dstDim.y * dstDim.lineLength + (dstDim.x << 1);
+    }
+    else {
+        src = Buffer_getUserPtr(hSrcBuf) +
+              srcDim.y * srcDim.lineLength + srcDim.x;
+        dst = Buffer_getUserPtr(hDstBuf) +
+              dstDim.y * dstDim.lineLength + dstDim.x;
+    }
+
+    if (hBlend->colorSpace == ColorSpace_YUV420PSEMI) {
+        srcChroma = Buffer_getSize(hSrcBuf) * 2 / 3 +
+                    srcDim.y / 2 * srcDim.lineLength + srcDim.x;
+        dstChroma = Buffer_getSize(hDstBuf) * 2 / 3 +
+                    dstDim.y / 2 * dstDim.lineLength + dstDim.x;
+    }
+    else {
+        srcChroma = Buffer_getSize(hSrcBuf) / 2 +
+                    srcDim.y * srcDim.lineLength + srcDim.x;
+        dstChroma = Buffer_getSize(hDstBuf) / 2 +
+                    dstDim.y * dstDim.lineLength + dstDim.x;
+    }
+
+    /* Blend in place on the destination after copying the source there */
+    if (src != dst) {
+        width = srcDim.width < dstDim.width ? srcDim.width : dstDim.width;
+        height = srcDim.height < dstDim.height ? srcDim.height : dstDim.height;
+
+        if (hBlend->colorSpace == ColorSpace_UYVY) {
+            copyPlane(src, srcDim.lineLength, dst, dstDim.lineLength,
+                      width * 2, height);
+        }
+        else {
+            copyPlane(src, srcDim.lineLength, dst, dstDim.lineLength,
+                      width, height);
+            copyPlane(Buffer_getUserPtr(hSrcBuf) + srcChroma,
+                      srcDim.lineLength,
+                      Buffer_getUserPtr(hDstBuf) + dstChroma,
+                      dstDim.lineLength, width,
+                      hBlend->colorSpace == ColorSpace_YUV420PSEMI ?
+                      height / 2 : height);
+        }
+
+        Buffer_setNumBytesUsed(hDstBuf, Buffer_getNumBytesUsed(hSrcBuf));
+    }
+
+    if (hBlend->colorSpace == ColorSpace_UYVY) {
+        blendLayer(&hBlend->layers[0], (UInt8 *) dst +
+                   hBlend->yPos * dstDim.lineLength + (hBlend->xPos << 1),
+                   dstDim.lineLength);
+    }
+    else {
+        blendLayer(&hBlend->layers[0], (UInt8 *) dst +
+                   hBlend->yPos * dstDim.lineLength + hBlend->xPos,
+                   dstDim.lineLength);
+
+        dst = Buffer_getUserPtr(hDstBuf) + dstChroma;
+
+        if (hBlend->colorSpace == ColorSpace_YUV420PSEMI) {
+            dst += hBlend->yPos / 2 * dstDim.lineLength;
+        }
+        else {
+            dst += hBlend->yPos * dstDim.lineLength;
+        }
+
+        blendLayer(&hBlend->layers[1], (UInt8 *) dst + hBlend->xPos,
+                   dstDim.lineLength);
+    }
+
+    return Dmai_EOK;
 }
 
 /******************************************************************************
@@ -68,5 +728,10 @@ Int Blend_execute(Blend_Handle hBlend, Buffer_Handle hBmpBuf,
  ******************************************************************************/
 Int Blend_delete(Blend_Handle hBlend)
 {
-    return Dmai_ENOTIMPL;
+    if (hBlend) {
+        cleanup(hBlend);
+        free(hBlend);
+    }
+
+    return Dmai_EOK;
 }
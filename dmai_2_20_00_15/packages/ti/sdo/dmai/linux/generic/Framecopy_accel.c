@@ -30,44 +30,348 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * --/COPYRIGHT--*/
 
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 #include <xdc/std.h>
 #include <ti/sdo/dmai/Framecopy.h>
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
+
+#include "../../priv/_Framecopy.h"
+#include "../../priv/_Bands.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define MODULE_NAME     "Framecopy"
 
+/* Upper limit on the number of threads copying one frame */
+#define MAX_THREADS     4
+
+/* Frames smaller than this are copied by the calling thread using memcpy */
+#define MIN_BAND_BYTES  (512 * 1024)
+
+/* One plane (luma, chroma or packed pixels) of the frame being copied */
+typedef struct Framecopy_Plane {
+    const Int8             *src;
+    Int8                   *dst;
+    Int32                   srcLineLength;
+    Int32                   dstLineLength;
+    Int                     numBytes;
+    Bool                    contiguous;
+} Framecopy_Plane;
+
+typedef struct Framecopy_Object {
+    Framecopy_CommonObject  common;
+    ColorSpace_Type         colorSpace;
+    Int                     bpp;
+    Int                     numPlanes;
+    Framecopy_Plane         planes[2];
+    Bool                    streaming;
+    _Bands_Handle           hBands;
+} Framecopy_Object;
+
 /******************************************************************************
- * Framecopy_accel_init
+ * copyBytes
  ******************************************************************************/
-Int Framecopy_accel_init(Framecopy_Handle hFramecopy, Framecopy_Attrs *attrs)
+static Void copyBytes(Int8 *dst, const Int8 *src, Int numBytes, Bool streaming)
 {
-    return Dmai_ENOTIMPL;
+    Int x = 0;
+
+    /*
+     * A non-cached destination is written in whole bursts which bypass the
+     * cache (SSE2) or fill complete write buffer lines (NEON) rather than
+     * with the byte and word stores memcpy may use on unaligned edges.
+     */
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    uint8x16_t a, b, c, d;
+
+    if (streaming) {
+        for (; x + 64 <= numBytes; x += 64) {
+            a = vld1q_u8((const UInt8 *) src + x);
+            b = vld1q_u8((const UInt8 *) src + x + 16);
+            c = vld1q_u8((const UInt8 *) src + x + 32);
+            d = vld1q_u8((const UInt8 *) src + x + 48);
+            vst1q_u8((UInt8 *) dst + x, a);
+            vst1q_u8((UInt8 *) dst + x + 16, b);
+            vst1q_u8((UInt8 *) dst + x + 32, c);
+            vst1q_u8((UInt8 *) dst + x + 48, d);
+        }
+    }
+#elif defined(__SSE2__)
+    __m128i a, b, c, d;
+
+    if (streaming && numBytes >= 64) {
+        /* Non-temporal stores need an aligned destination */
+        x = (16 - ((unsigned long) dst & 0xf)) & 0xf;
+        memcpy(dst, src, x);
+
+        for (; x + 64 <= numBytes; x += 64) {
+            a = _mm_loadu_si128((const __m128i *) (src + x));
+            b = _mm_loadu_si128((const __m128i *) (src + x + 16));
+            c = _mm_loadu_si128((const __m128i *) (src + x + 32));
+            d = _mm_loadu_si128((const __m128i *) (src + x + 48));
+            _mm_stream_si128((__m128i *) (dst + x), a);
+            _mm_stream_si128((__m128i *) (dst + x + 16), b);
+            _mm_stream_si128((__m128i *) (dst + x + 32), c);
+            _mm_stream_si128((__m128i *) (dst + x + 48), d);
+        }
+    }
+#endif
+
+    memcpy(dst + x, src + x, numBytes - x);
+}
+
+/******************************************************************************
+ * copyLines
+ ******************************************************************************/
+static Void copyLines(Framecopy_Plane *plane, Int first, Int last,
+                      Bool streaming)
+{
+    const Int8 *src = plane->src + first * plane->srcLineLength;
+    Int8 *dst = plane->dst + first * plane->dstLineLength;
+    Int line;
+
+    if (plane->contiguous) {
+        copyBytes(dst, src, (last - first) * plane->srcLineLength, streaming);
+        return;
+    }
+
+    for (line = first; line < last; line++) {
+        copyBytes(dst, src, plane->numBytes, streaming);
+        src += plane->srcLineLength;
+        dst += plane->dstLineLength;
+    }
+}
+
+/******************************************************************************
+ * copyRows
+ ******************************************************************************/
+static Void copyRows(Ptr arg, Int firstRow, Int lastRow)
+{
+    Framecopy_Handle hFc = (Framecopy_Handle) arg;
+
+    copyLines(&hFc->planes[0], firstRow, lastRow, hFc->streaming);
+
+    if (hFc->numPlanes == 2) {
+        if (hFc->colorSpace == ColorSpace_YUV420PSEMI) {
+            copyLines(&hFc->planes[1], firstRow >> 1, lastRow >> 1,
+                      hFc->streaming);
+        }
+        else {
+            copyLines(&hFc->planes[1], firstRow, lastRow, hFc->streaming);
+        }
+    }
+
+#if !(defined(__ARM_NEON__) || defined(__ARM_NEON)) && defined(__SSE2__)
+    /* Make the non-temporal stores visible before the band is reported done */
+    if (hFc->streaming) {
+        _mm_sfence();
+    }
+#endif
+}
+
+/******************************************************************************
+ * Framecopy_accel_create
+ ******************************************************************************/
+Framecopy_Handle Framecopy_accel_create(Framecopy_Attrs *attrs)
+{
+    Framecopy_Handle hFc;
+    Int numThreads;
+
+    hFc = calloc(1, sizeof(Framecopy_Object));
+
+    if (hFc == NULL) {
+        Dmai_err0("Failed to allocate space for Framecopy Object\n");
+        return NULL;
+    }
+
+    /* One band per online CPU, within reason */
+    numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    numThreads = numThreads < 1 ? 1 : numThreads;
+    numThreads = numThreads > MAX_THREADS ? MAX_THREADS : numThreads;
+
+    hFc->hBands = _Bands_create(numThreads);
+
+    if (hFc->hBands == NULL) {
+        Dmai_err1("Failed to create %d copy threads\n", numThreads);
+        free(hFc);
+        return NULL;
+    }
+
+    Dmai_dbg1("Copying frames using %d threads\n", numThreads);
+
+    return hFc;
 }
 
 /******************************************************************************
  * Framecopy_accel_config
  ******************************************************************************/
-Int Framecopy_accel_config(Framecopy_Handle hFramecopy,
+Int Framecopy_accel_config(Framecopy_Handle hFc,
                            Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
-    return Dmai_ENOTIMPL;
+    BufferGfx_Dimensions srcDim;
+    BufferGfx_Dimensions dstDim;
+    ColorSpace_Type colorSpace = BufferGfx_getColorSpace(hSrcBuf);
+    Int width;
+
+    BufferGfx_getDimensions(hSrcBuf, &srcDim);
+    BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+    /* Select the smallest width */
+    width = srcDim.width < dstDim.width ? srcDim.width : dstDim.width;
+
+    /* Only the first plane would be copied of the planar formats */
+    if (colorSpace == ColorSpace_YUV420P ||
+        colorSpace == ColorSpace_YUV422P ||
+        colorSpace == ColorSpace_YUV444P) {
+
+        Dmai_err1("Color space %d not supported\n", colorSpace);
+        return Dmai_ENOTIMPL;
+    }
+
+    /* Two adjacent pixels are dependent, hence we need even numbers */
+    if ((colorSpace == ColorSpace_UYVY ||
+         colorSpace == ColorSpace_YUV422PSEMI ||
+         colorSpace == ColorSpace_YUV420PSEMI) &&
+        (width & 1)) {
+
+        Dmai_err1("Width needs to be even (%d)\n", width);
+        return Dmai_EINVAL;
+    }
+
+    hFc->bpp = ColorSpace_getBpp(colorSpace);
+
+    if (hFc->bpp < 0) {
+        return hFc->bpp;
+    }
+
+    hFc->colorSpace = colorSpace;
+    hFc->numPlanes = colorSpace == ColorSpace_YUV420PSEMI ||
+                     colorSpace == ColorSpace_YUV422PSEMI ? 2 : 1;
+
+    return Dmai_EOK;
 }
 
 /******************************************************************************
  * Framecopy_accel_execute
  ******************************************************************************/
-Int Framecopy_accel_execute(Framecopy_Handle hFramecopy,
+Int Framecopy_accel_execute(Framecopy_Handle hFc,
                             Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
-    return Dmai_ENOTIMPL;
+    BufferGfx_Dimensions srcDim, dstDim;
+    BufferGfx_Attrs gfxAttrs = BufferGfx_Attrs_DEFAULT;
+    Framecopy_Plane *luma = &hFc->planes[0];
+    Framecopy_Plane *chroma = &hFc->planes[1];
+    Int8 *src, *dst;
+    Int width, height, numBytes, chromaRows;
+
+    assert(Buffer_getUserPtr(hSrcBuf));
+    assert(Buffer_getUserPtr(hDstBuf));
+
+    if (hFc->numPlanes == 0) {
+        Dmai_err0("Framecopy job has not been configured\n");
+        return Dmai_EINVAL;
+    }
+
+    BufferGfx_getDimensions(hSrcBuf, &srcDim);
+    BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+    /* Select the smallest resolution */
+    width = srcDim.width < dstDim.width ? srcDim.width : dstDim.width;
+    height = srcDim.height < dstDim.height ? srcDim.height : dstDim.height;
+
+    if (hFc->colorSpace == ColorSpace_YUV420PSEMI) {
+        assert((srcDim.y & 0x1) == 0);
+        assert((dstDim.y & 0x1) == 0);
+    }
+
+    src = Buffer_getUserPtr(hSrcBuf);
+    dst = Buffer_getUserPtr(hDstBuf);
+
+    luma->src = src + srcDim.y * srcDim.lineLength + srcDim.x * hFc->bpp / 8;
+    luma->dst = dst + dstDim.y * dstDim.lineLength + dstDim.x * hFc->bpp / 8;
+    luma->srcLineLength = srcDim.lineLength;
+    luma->dstLineLength = dstDim.lineLength;
+    luma->numBytes = width * hFc->bpp / 8;
+    luma->contiguous = luma->numBytes == srcDim.lineLength &&
+                       srcDim.lineLength == dstDim.lineLength;
+
+    numBytes = luma->numBytes * height;
+
+    if (hFc->colorSpace == ColorSpace_YUV420PSEMI) {
+        chroma->src = src + Buffer_getSize(hSrcBuf) * 2 / 3 +
+                      srcDim.y / 2 * srcDim.lineLength + srcDim.x;
+        chroma->dst = dst + Buffer_getSize(hDstBuf) * 2 / 3 +
+                      dstDim.y / 2 * dstDim.lineLength + dstDim.x;
+        numBytes += luma->numBytes * height / 2;
+        chromaRows = height / 2;
+    }
+    else if (hFc->colorSpace == ColorSpace_YUV422PSEMI) {
+        chroma->src = src + Buffer_getSize(hSrcBuf) / 2 +
+                      srcDim.y * srcDim.lineLength + srcDim.x;
+        chroma->dst = dst + Buffer_getSize(hDstBuf) / 2 +
+                      dstDim.y * dstDim.lineLength + dstDim.x;
+        numBytes += luma->numBytes * height;
+        chromaRows = height;
+    }
+    else {
+        chromaRows = 0;
+    }
+
+    chroma->srcLineLength = luma->srcLineLength;
+    chroma->dstLineLength = luma->dstLineLength;
+    chroma->numBytes = luma->numBytes;
+    chroma->contiguous = luma->contiguous;
+
+    /* The source may have been written by a device behind the cache */
+    Buffer_cacheInv(hSrcBuf);
+
+    if (numBytes < MIN_BAND_BYTES) {
+        hFc->streaming = FALSE;
+        copyRows(hFc, 0, height);
+    }
+    else {
+        Buffer_getAttrs(hDstBuf, BufferGfx_getBufferAttrs(&gfxAttrs));
+
+        hFc->streaming = gfxAttrs.bAttrs.memParams.type != Memory_MALLOC &&
+                         (gfxAttrs.bAttrs.memParams.flags & Memory_NONCACHED);
+
+        /* Bands start on an even row to keep the chroma rows of 420 whole */
+        _Bands_run(hFc->hBands, copyRows, hFc, height, 2);
+    }
+
+    if (height > 0) {
+        Buffer_setCpuDirty(hDstBuf, luma->dst - dst,
+                           (height - 1) * dstDim.lineLength + luma->numBytes);
+
+        if (hFc->numPlanes > 1) {
+            Buffer_setCpuDirty(hDstBuf, chroma->dst - dst,
+                               (chromaRows - 1) * dstDim.lineLength +
+                               chroma->numBytes);
+        }
+    }
+
+    Buffer_setNumBytesUsed(hDstBuf, numBytes);
+
+    return Dmai_EOK;
 }
 
 /******************************************************************************
- * Framecopy_accel_exit
+ * Framecopy_accel_delete
  ******************************************************************************/
-Int Framecopy_accel_exit(Framecopy_Handle hFramecopy)
+Int Framecopy_accel_delete(Framecopy_Handle hFc)
 {
-    return Dmai_ENOTIMPL;
-}
+    if (hFc) {
+        _Bands_delete(hFc->hBands);
+        free(hFc);
+    }
 
+    return Dmai_EOK;
+}
@@ -30,22 +30,384 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * --/COPYRIGHT--*/
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
 #include <ti/sdo/dmai/Resize.h>
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define MODULE_NAME     "Resize"
 
+/* Filter coefficients are signed Q14 */
+#define COEFF_SHIFT     14
+#define COEFF_ONE       (1 << COEFF_SHIFT)
+
+/* Enough taps for the area filter of a 1/16x down-scale */
+#define MAX_TAPS        (2 * 16 + 2)
+
+/*
+ * Separable filter for one dimension of one plane. Every output sample is
+ * computed from 'taps' consecutive input samples starting at start[i], using
+ * the weights coeff[i * taps] onwards.
+ */
+typedef struct Resize_Filter {
+    Int                 taps;
+    Int32              *start;
+    Int16              *coeff;
+} Resize_Filter;
+
+/* Plane layouts handled by the horizontal pass */
+typedef enum {
+    Plane_LUMA = 0,
+    Plane_CBCR,
+    Plane_UYVY
+} Plane;
+
+typedef struct Resize_Object {
+    ColorSpace_Type     colorSpace;
+    Int                 srcWidth;
+    Int                 srcHeight;
+    Int                 dstWidth;
+    Int                 dstHeight;
+    Resize_Filter       hLuma;
+    Resize_Filter       vLuma;
+    Resize_Filter       hChroma;
+    Resize_Filter       vChroma;
+    UInt8              *ring;
+    Int                 ringLines;
+    Int                 ringLineLength;
+} Resize_Object;
+
 const Resize_Attrs Resize_Attrs_DEFAULT = {
-    0xe,
+    Resize_WindowType_BLACKMAN,
+    Resize_WindowType_BLACKMAN,
+    Resize_FilterType_LOWPASS,
+    Resize_FilterType_LOWPASS,
+    0xe
 };
 
+/******************************************************************************
+ * freeFilter
+ ******************************************************************************/
+static Void freeFilter(Resize_Filter *filter)
+{
+    free(filter->start);
+    free(filter->coeff);
+    filter->start = NULL;
+    filter->coeff = NULL;
+    filter->taps = 0;
+}
+
+/******************************************************************************
+ * cleanup
+ ******************************************************************************/
+static Void cleanup(Resize_Handle hResize)
+{
+    freeFilter(&hResize->hLuma);
+    freeFilter(&hResize->vLuma);
+    freeFilter(&hResize->hChroma);
+    freeFilter(&hResize->vChroma);
+
+    free(hResize->ring);
+    hResize->ring = NULL;
+}
+
+/******************************************************************************
+ * distance
+ ******************************************************************************/
+static inline Int32 distance(Int x, Int32 center, Int dstSize)
+{
+    Int32 dist = (2 * x + 1) * dstSize - center;
+
+    return dist < 0 ? -dist : dist;
+}
+
+/******************************************************************************
+ * initFilter
+ ******************************************************************************/
+static Int initFilter(Resize_Filter *filter, Int srcSize, Int dstSize)
+{
+    Int32 weight[MAX_TAPS];
+    Int32 radius, center, sum, rest;
+    Int16 *coeff;
+    Int first, last, start, taps, maxTap;
+    Int i, j, x;
+
+    /*
+     * Triangle (bilinear) filter, widened to the scale factor when
+     * down-scaling so that every input sample contributes (area filter).
+     * Positions are expressed in units of 1 / (2 * dstSize) input samples
+     * to keep the table calculation in integers: input sample x is centered
+     * at (2x + 1) * dstSize and output sample i at (2i + 1) * srcSize.
+     */
+    radius = srcSize > dstSize ? 2 * srcSize : 2 * dstSize;
+    taps = (2 * srcSize + dstSize - 1) / dstSize;
+    taps = taps < 2 ? 2 : taps;
+    taps = taps > srcSize ? srcSize : taps;
+
+    assert(taps <= MAX_TAPS);
+
+    filter->taps = taps;
+    filter->start = calloc(dstSize, sizeof(Int32));
+    filter->coeff = calloc(dstSize * taps, sizeof(Int16));
+
+    if (filter->start == NULL || filter->coeff == NULL) {
+        Dmai_err0("Failed to allocate space for filter coefficients\n");
+        return Dmai_ENOMEM;
+    }
+
+    for (i = 0; i < dstSize; i++) {
+        center = (2 * i + 1) * srcSize;
+        first = (center - radius) / (2 * dstSize) - 1;
+        last = (center + radius) / (2 * dstSize) + 1;
+
+        while (distance(first, center, dstSize) >= radius) {
+            first++;
+        }
+
+        while (distance(last, center, dstSize) >= radius) {
+            last--;
+        }
+
+        start = first < 0 ? 0 : first;
+        start = start > srcSize - taps ? srcSize - taps : start;
+        filter->start[i] = start;
+
+        memset(weight, 0, sizeof(weight));
+        sum = 0;
+
+        /* Samples outside the input are folded onto the edge samples */
+        for (j = first; j <= last; j++) {
+            x = j < 0 ? 0 : j >= srcSize ? srcSize - 1 : j;
+            weight[x - start] += radius - distance(j, center, dstSize);
+            sum += radius - distance(j, center, dstSize);
+        }
+
+        /* Normalize to Q14, giving the rounding error to the largest tap */
+        coeff = &filter->coeff[i * taps];
+        rest = COEFF_ONE;
+        maxTap = 0;
+
+        for (j = 0; j < taps; j++) {
+            coeff[j] = (Int16) ((Float) weight[j] * COEFF_ONE / sum);
+            rest -= coeff[j];
+
+            if (coeff[j] > coeff[maxTap]) {
+                maxTap = j;
+            }
+        }
+
+        coeff[maxTap] += rest;
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * hFilter
+ ******************************************************************************/
+static Void hFilter(const UInt8 *src, Int srcStep, UInt8 *dst, Int dstStep,
+                    Resize_Filter *filter, Int numSamples)
+{
+    const Int16 *coeff = filter->coeff;
+    const UInt8 *ptr;
+    Int32 acc;
+    Int i, t;
+
+    /* The weights are positive and sum to one, no saturation is needed */
+    for (i = 0; i < numSamples; i++) {
+        ptr = src + filter->start[i] * srcStep;
+        acc = COEFF_ONE >> 1;
+
+        for (t = 0; t < filter->taps; t++) {
+            acc += ptr[t * srcStep] * coeff[t];
+        }
+
+        *dst = (UInt8) (acc >> COEFF_SHIFT);
+        dst += dstStep;
+        coeff += filter->taps;
+    }
+}
+
+/******************************************************************************
+ * vFilter
+ ******************************************************************************/
+static Void vFilter(const UInt8 *lines[], const Int16 *coeff, Int taps,
+                    UInt8 *dst, Int numBytes)
+{
+    Int32 acc;
+    Int x = 0;
+    Int t;
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    int32x4_t accLo, accHi;
+    int16x8_t pix;
+
+    for (; x + 8 <= numBytes; x += 8) {
+        accLo = vdupq_n_s32(COEFF_ONE >> 1);
+        accHi = accLo;
+
+        for (t = 0; t < taps; t++) {
+            pix = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(lines[t] + x)));
+            accLo = vmlal_n_s16(accLo, vget_low_s16(pix), coeff[t]);
+            accHi = vmlal_n_s16(accHi, vget_high_s16(pix), coeff[t]);
+        }
+
+        vst1_u8(dst + x,
+                vqmovn_u16(vcombine_u16(vqshrun_n_s32(accLo, COEFF_SHIFT),
+                                        vqshrun_n_s32(accHi, COEFF_SHIFT))));
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc0, acc1, acc2, acc3, a, b, w;
+
+    /* Two input lines at a time, interleaved for _mm_madd_epi16 */
+    for (; x + 16 <= numBytes; x += 16) {
+        acc0 = _mm_set1_epi32(COEFF_ONE >> 1);
+        acc1 = acc0;
+        acc2 = acc0;
+        acc3 = acc0;
+
+        for (t = 0; t < taps; t += 2) {
+            a = _mm_loadu_si128((const __m128i *) (lines[t] + x));
+
+            if (t + 1 < taps) {
+                b = _mm_loadu_si128((const __m128i *) (lines[t + 1] + x));
+                w = _mm_set1_epi32((UInt32) (UInt16) coeff[t + 1] << 16 |
+                                   (UInt16) coeff[t]);
+            }
+            else {
+                b = zero;
+                w = _mm_set1_epi32((UInt16) coeff[t]);
+            }
+
+            acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(w,
+                       _mm_unpacklo_epi8(_mm_unpacklo_epi8(a, b), zero)));
+            acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(w,
+                       _mm_unpackhi_epi8(_mm_unpacklo_epi8(a, b), zero)));
+            acc2 = _mm_add_epi32(acc2, _mm_madd_epi16(w,
+                       _mm_unpacklo_epi8(_mm_unpackhi_epi8(a, b), zero)));
+            acc3 = _mm_add_epi32(acc3, _mm_madd_epi16(w,
+                       _mm_unpackhi_epi8(_mm_unpackhi_epi8(a, b), zero)));
+        }
+
+        acc0 = _mm_packs_epi32(_mm_srai_epi32(acc0, COEFF_SHIFT),
+                               _mm_srai_epi32(acc1, COEFF_SHIFT));
+        acc2 = _mm_packs_epi32(_mm_srai_epi32(acc2, COEFF_SHIFT),
+                               _mm_srai_epi32(acc3, COEFF_SHIFT));
+
+        _mm_storeu_si128((__m128i *) (dst + x), _mm_packus_epi16(acc0, acc2));
+    }
+#endif
+
+    for (; x < numBytes; x++) {
+        acc = COEFF_ONE >> 1;
+
+        for (t = 0; t < taps; t++) {
+            acc += lines[t][x] * coeff[t];
+        }
+
+        dst[x] = (UInt8) (acc >> COEFF_SHIFT);
+    }
+}
+
+/******************************************************************************
+ * filterLine
+ ******************************************************************************/
+static Void filterLine(Resize_Handle hResize, Plane plane,
+                       const UInt8 *src, UInt8 *dst)
+{
+    Int chromaWidth = hResize->dstWidth >> 1;
+
+    switch (plane) {
+        case Plane_LUMA:
+            hFilter(src, 1, dst, 1, &hResize->hLuma, hResize->dstWidth);
+            break;
+        case Plane_CBCR:
+            hFilter(src, 2, dst, 2, &hResize->hChroma, chromaWidth);
+            hFilter(src + 1, 2, dst + 1, 2, &hResize->hChroma, chromaWidth);
+            break;
+        case Plane_UYVY:
+            hFilter(src + 1, 2, dst + 1, 2, &hResize->hLuma,
+                    hResize->dstWidth);
+            hFilter(src, 4, dst, 4, &hResize->hChroma, chromaWidth);
+            hFilter(src + 2, 4, dst + 2, 4, &hResize->hChroma, chromaWidth);
+            break;
+    }
+}
+
+/******************************************************************************
+ * resizePlane
+ ******************************************************************************/
+static Void resizePlane(Resize_Handle hResize, Plane plane,
+                        Resize_Filter *filter, const UInt8 *src,
+                        Int srcLineLength, UInt8 *dst, Int dstLineLength,
+                        Int dstLines)
+{
+    const UInt8 *lines[MAX_TAPS];
+    Int numBytes, next, start;
+    Int i, t;
+
+    numBytes = plane == Plane_UYVY ? hResize->dstWidth * 2 : hResize->dstWidth;
+    next = 0;
+
+    /*
+     * Each input line is filtered horizontally once into a ring of
+     * 'ringLines' lines, which the vertical pass consumes while they are
+     * still in the cache. The windows of the output lines only move down,
+     * so a line is never needed again once it has left the ring.
+     */
+    for (i = 0; i < dstLines; i++) {
+        start = filter->start[i];
+        next = next < start ? start : next;
+
+        while (next < start + filter->taps) {
+            filterLine(hResize, plane, src + next * srcLineLength,
+                       hResize->ring +
+                       (next % hResize->ringLines) * hResize->ringLineLength);
+            next++;
+        }
+
+        for (t = 0; t < filter->taps; t++) {
+            lines[t] = hResize->ring +
+                       ((start + t) % hResize->ringLines) *
+                       hResize->ringLineLength;
+        }
+
+        vFilter(lines, &filter->coeff[i * filter->taps], filter->taps,
+                dst, numBytes);
+
+        dst += dstLineLength;
+    }
+}
+
 /******************************************************************************
  * Resize_create
  ******************************************************************************/
 Resize_Handle Resize_create(Resize_Attrs *attrs)
 {
-    return NULL;
+    Resize_Handle hResize;
+
+    assert(attrs);
+
+    hResize = (Resize_Handle)calloc(1, sizeof(Resize_Object));
+
+    if (hResize == NULL) {
+        Dmai_err0("Failed to allocate space for Resize Object\n");
+        return NULL;
+    }
+
+    return hResize;
 }
 
 /******************************************************************************
@@ -54,7 +416,152 @@ Resize_Handle Resize_create(Resize_Attrs *attrs)
 Int Resize_config(Resize_Handle hResize,
                   Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
-    return Dmai_ENOTIMPL;
+    BufferGfx_Dimensions srcDim, dstDim;
+    ColorSpace_Type      colorSpace;
+    UInt                 hDif;
+    UInt                 vDif;
+    Int                  ret;
+
+    /* Make sure our input parameters are valid */
+    if (!hResize) {
+        Dmai_err0("Resize_Handle parameter must not be NULL\n");
+        return Dmai_EINVAL;
+    }
+
+    if (!hSrcBuf) {
+        Dmai_err0("Source buffer parameter must not be NULL\n");
+        return Dmai_EINVAL;
+    }
+
+    if (!hDstBuf) {
+        Dmai_err0("Destination buffer parameter must not be NULL\n");
+        return Dmai_EINVAL;
+    }
+
+    /* Buffer needs to be graphics buffers */
+    if (Buffer_getType(hSrcBuf) != Buffer_Type_GRAPHICS ||
+        Buffer_getType(hDstBuf) != Buffer_Type_GRAPHICS) {
+
+        Dmai_err0("Src and dst buffers need to be graphics buffers\n");
+        return Dmai_EINVAL;
+    }
+
+    colorSpace = BufferGfx_getColorSpace(hSrcBuf);
+
+    if (colorSpace != BufferGfx_getColorSpace(hDstBuf)) {
+        Dmai_err0("Src and dst buffers need to have the same color space\n");
+        return Dmai_EINVAL;
+    }
+
+    if (colorSpace != ColorSpace_YUV420PSEMI &&
+        colorSpace != ColorSpace_YUV422PSEMI &&
+        colorSpace != ColorSpace_UYVY) {
+
+        Dmai_err1("Color space %d not supported\n", colorSpace);
+        return Dmai_ENOTIMPL;
+    }
+
+    BufferGfx_getDimensions(hSrcBuf, &srcDim);
+    BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+    if (dstDim.width <= 0) {
+        Dmai_err0("Destination buffer width must be greater than zero\n");
+        return Dmai_EINVAL;
+    }
+
+    if (dstDim.height <= 0) {
+        Dmai_err0("Destination buffer height must be greater than zero\n");
+        return Dmai_EINVAL;
+    }
+
+    /* The chroma is subsampled horizontally in all supported formats */
+    if ((srcDim.width & 0x1) || (dstDim.width & 0x1) ||
+        (srcDim.x & 0x1) || (dstDim.x & 0x1)) {
+
+        Dmai_err0("Buffer widths and horizontal offsets must be even\n");
+        return Dmai_EINVAL;
+    }
+
+    if (colorSpace == ColorSpace_YUV420PSEMI &&
+        ((srcDim.height & 0x1) || (dstDim.height & 0x1) ||
+         (srcDim.y & 0x1) || (dstDim.y & 0x1))) {
+
+        Dmai_err0("Buffer heights and vertical offsets must be even\n");
+        return Dmai_EINVAL;
+    }
+
+    /* Check for valid buffer scaling */
+    hDif = srcDim.width  * 256 / dstDim.width;
+    vDif = srcDim.height * 256 / dstDim.height;
+
+    if (hDif < 32) {
+        Dmai_err0("Horizontal up-scaling must not exceed 8x\n");
+        return Dmai_EINVAL;
+    }
+
+    if (hDif > 4096) {
+        Dmai_err0("Horizontal down-scaling must not exceed 1/16x\n");
+        return Dmai_EINVAL;
+    }
+
+    if (vDif < 32) {
+        Dmai_err0("Vertical up-scaling must not exceed 8x\n");
+        return Dmai_EINVAL;
+    }
+
+    if (vDif > 4096) {
+        Dmai_err0("Vertical down-scaling must not exceed 1/16x\n");
+        return Dmai_EINVAL;
+    }
+
+    /* Release the tables of a previous configuration */
+    cleanup(hResize);
+
+    hResize->colorSpace = colorSpace;
+    hResize->srcWidth   = srcDim.width;
+    hResize->srcHeight  = srcDim.height;
+    hResize->dstWidth   = dstDim.width;
+    hResize->dstHeight  = dstDim.height;
+
+    ret = initFilter(&hResize->hLuma, srcDim.width, dstDim.width);
+
+    if (ret == Dmai_EOK) {
+        ret = initFilter(&hResize->vLuma, srcDim.height, dstDim.height);
+    }
+
+    if (ret == Dmai_EOK) {
+        ret = initFilter(&hResize->hChroma, srcDim.width / 2,
+                         dstDim.width / 2);
+    }
+
+    if (ret == Dmai_EOK) {
+        if (colorSpace == ColorSpace_YUV420PSEMI) {
+            ret = initFilter(&hResize->vChroma, srcDim.height / 2,
+                             dstDim.height / 2);
+        }
+        else {
+            ret = initFilter(&hResize->vChroma, srcDim.height, dstDim.height);
+        }
+    }
+
+    if (ret < 0) {
+        cleanup(hResize);
+        return ret;
+    }
+
+    /* One horizontally filtered line per vertical tap */
+    hResize->ringLines = hResize->vLuma.taps > hResize->vChroma.taps ?
+                         hResize->vLuma.taps : hResize->vChroma.taps;
+    hResize->ringLineLength = (dstDim.width * 2 + 31) & ~31;
+    hResize->ring = malloc(hResize->ringLines * hResize->ringLineLength);
+
+    if (hResize->ring == NULL) {
+        Dmai_err0("Failed to allocate space for line buffers\n");
+        cleanup(hResize);
+        return Dmai_ENOMEM;
+    }
+
+    return Dmai_EOK;
 }
 
 /******************************************************************************
@@ -63,7 +570,86 @@ Int Resize_config(Resize_Handle hResize,
 Int Resize_execute(Resize_Handle hResize,
                    Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
-    return Dmai_ENOTIMPL;
+    BufferGfx_Dimensions srcDim;
+    BufferGfx_Dimensions dstDim;
+    UInt8               *src;
+    UInt8               *dst;
+
+    assert(hResize);
+    assert(hSrcBuf);
+    assert(hDstBuf);
+    assert(Buffer_getUserPtr(hSrcBuf));
+    assert(Buffer_getUserPtr(hDstBuf));
+
+    if (hResize->ring == NULL) {
+        Dmai_err0("Resize job has not been configured\n");
+        return Dmai_EINVAL;
+    }
+
+    BufferGfx_getDimensions(hSrcBuf, &srcDim);
+    BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+    assert(srcDim.width == hResize->srcWidth);
+    assert(srcDim.height == hResize->srcHeight);
+    assert(dstDim.width == hResize->dstWidth);
+    assert(dstDim.height == hResize->dstHeight);
+
+    if (hResize->colorSpace == ColorSpace_UYVY) {
+        src = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+              srcDim.y * srcDim.lineLength + (srcDim.x << 1);
+        dst = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+              dstDim.y * dstDim.lineLength + (dstDim.x << 1);
+
+        resizePlane(hResize, Plane_UYVY, &hResize->vLuma,
+                    src, srcDim.lineLength, dst, dstDim.lineLength,
+                    dstDim.height);
+
+        Buffer_setNumBytesUsed(hDstBuf, dstDim.width * dstDim.height * 2);
+
+        return Dmai_EOK;
+    }
+
+    /* Luma plane */
+    src = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+          srcDim.y * srcDim.lineLength + srcDim.x;
+    dst = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+          dstDim.y * dstDim.lineLength + dstDim.x;
+
+    resizePlane(hResize, Plane_LUMA, &hResize->vLuma,
+                src, srcDim.lineLength, dst, dstDim.lineLength,
+                dstDim.height);
+
+    /* Interleaved CbCr plane */
+    if (hResize->colorSpace == ColorSpace_YUV420PSEMI) {
+        src = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+              Buffer_getSize(hSrcBuf) * 2 / 3 +
+              srcDim.y / 2 * srcDim.lineLength + srcDim.x;
+        dst = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+              Buffer_getSize(hDstBuf) * 2 / 3 +
+              dstDim.y / 2 * dstDim.lineLength + dstDim.x;
+
+        resizePlane(hResize, Plane_CBCR, &hResize->vChroma,
+                    src, srcDim.lineLength, dst, dstDim.lineLength,
+                    dstDim.height / 2);
+
+        Buffer_setNumBytesUsed(hDstBuf, dstDim.width * dstDim.height * 3 / 2);
+    }
+    else {
+        src = (UInt8 *) Buffer_getUserPtr(hSrcBuf) +
+              Buffer_getSize(hSrcBuf) / 2 +
+              srcDim.y * srcDim.lineLength + srcDim.x;
+        dst = (UInt8 *) Buffer_getUserPtr(hDstBuf) +
+              Buffer_getSize(hDstBuf) / 2 +
+              dstDim.y * dstDim.lineLength + dstDim.x;
+
+        resizePlane(hResize, Plane_CBCR, &hResize->vChroma,
+                    src, srcDim.lineLength, dst, dstDim.lineLength,
+                    dstDim.height);
+
+        Buffer_setNumBytesUsed(hDstBuf, dstDim.width * dstDim.height * 2);
+    }
+
+    return Dmai_EOK;
 }
 
 /******************************************************************************
@@ -71,5 +657,10 @@ Int Resize_execute(Resize_Handle hResize,
  ******************************************************************************/
 Int Resize_delete(Resize_Handle hResize)
 {
-    return Dmai_ENOTIMPL;
+    if (hResize) {
+        cleanup(hResize);
+        free(hResize);
+    }
+
+    return Dmai_EOK;
 }
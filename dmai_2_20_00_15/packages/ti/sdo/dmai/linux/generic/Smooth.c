@@ -30,22 +30,329 @@
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * --/COPYRIGHT--*/
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <xdc/std.h>
+
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
 #include <ti/sdo/dmai/Smooth.h>
 
+#include "../../priv/_Bands.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define MODULE_NAME     "Smooth"
 
+/* Number of frame lines processed together, chosen to stay in the L1 cache */
+#define BAND_LINES      16
+
+/* One plane (Y, CbCr or UYVY) of the frame being processed */
+typedef struct Smooth_Plane {
+    const UInt8        *src;
+    UInt8              *dst;
+    Int32               srcLineLength;
+    Int32               dstLineLength;
+    Int                 numBytes;
+    Int                 numLines;
+    Int                 step[2];        /* for even and odd bytes */
+} Smooth_Plane;
+
+typedef struct Smooth_Object {
+    Smooth_Mode         mode;
+    ColorSpace_Type     colorSpace;
+    Int                 width;
+    Int                 height;
+    Int                 numPlanes;
+    Smooth_Plane        planes[2];
+    _Bands_Handle       hBands;
+} Smooth_Object;
+
 const Smooth_Attrs Smooth_Attrs_DEFAULT = {
     0xe,
+    Smooth_Mode_ELA,
+    1,
 };
 
+/******************************************************************************
+ * averageLine
+ ******************************************************************************/
+static Void averageLine(const UInt8 *above, const UInt8 *below, UInt8 *dst,
+                        Int numBytes)
+{
+    Int x = 0;
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    for (; x + 16 <= numBytes; x += 16) {
+        vst1q_u8(dst + x, vrhaddq_u8(vld1q_u8(above + x),
+                                     vld1q_u8(below + x)));
+    }
+#elif defined(__SSE2__)
+    for (; x + 16 <= numBytes; x += 16) {
+        _mm_storeu_si128((__m128i *) (dst + x),
+            _mm_avg_epu8(_mm_loadu_si128((const __m128i *) (above + x)),
+                         _mm_loadu_si128((const __m128i *) (below + x))));
+    }
+#endif
+
+    for (; x < numBytes; x++) {
+        dst[x] = (above[x] + below[x] + 1) >> 1;
+    }
+}
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+/******************************************************************************
+ * elaVector
+ ******************************************************************************/
+static inline uint8x16_t elaVector(const UInt8 *above, const UInt8 *below,
+                                   Int step)
+{
+    uint8x16_t a, b, out, dBest, d, m;
+
+    a = vld1q_u8(above);
+    b = vld1q_u8(below);
+    dBest = vabdq_u8(a, b);
+    out = vrhaddq_u8(a, b);
+
+    a = vld1q_u8(above - step);
+    b = vld1q_u8(below + step);
+    d = vabdq_u8(a, b);
+    m = vcltq_u8(d, dBest);
+    out = vbslq_u8(m, vrhaddq_u8(a, b), out);
+    dBest = vminq_u8(d, dBest);
+
+    a = vld1q_u8(above + step);
+    b = vld1q_u8(below - step);
+    d = vabdq_u8(a, b);
+    m = vcltq_u8(d, dBest);
+
+    return vbslq_u8(m, vrhaddq_u8(a, b), out);
+}
+#elif defined(__SSE2__)
+/******************************************************************************
+ * elaVector
+ ******************************************************************************/
+static inline __m128i elaVector(const UInt8 *above, const UInt8 *below,
+                                Int step)
+{
+    __m128i a, b, out, dBest, d, m;
+
+    /* SSE2 has no unsigned compare, d >= dBest is max(d, dBest) == d */
+    a = _mm_loadu_si128((const __m128i *) above);
+    b = _mm_loadu_si128((const __m128i *) below);
+    dBest = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+    out = _mm_avg_epu8(a, b);
+
+    a = _mm_loadu_si128((const __m128i *) (above - step));
+    b = _mm_loadu_si128((const __m128i *) (below + step));
+    d = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+    m = _mm_cmpeq_epi8(_mm_max_epu8(d, dBest), d);
+    out = _mm_or_si128(_mm_and_si128(m, out),
+                       _mm_andnot_si128(m, _mm_avg_epu8(a, b)));
+    dBest = _mm_min_epu8(d, dBest);
+
+    a = _mm_loadu_si128((const __m128i *) (above + step));
+    b = _mm_loadu_si128((const __m128i *) (below - step));
+    d = _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+    m = _mm_cmpeq_epi8(_mm_max_epu8(d, dBest), d);
+
+    return _mm_or_si128(_mm_and_si128(m, out),
+                        _mm_andnot_si128(m, _mm_avg_epu8(a, b)));
+}
+#endif
+
+/******************************************************************************
+ * elaLine
+ ******************************************************************************/
+static Void elaLine(const UInt8 *above, const UInt8 *below, UInt8 *dst,
+                    Int numBytes, const Int *steps)
+{
+    Int x, end, best, diff, step, maxStep;
+
+    /*
+     * Every output sample is the average of the pair of samples above and
+     * below it, taken along the direction (left diagonal, vertical or right
+     * diagonal) where they differ the least. 'steps' holds the distance
+     * between neighbouring samples of the same component, for even and odd
+     * bytes (UYVY luma sits every 2 bytes, its chroma every 4). Samples on
+     * the borders are interpolated vertically.
+     */
+    /* Differing steps are even, so vector lanes keep the parity of bytes */
+    maxStep = steps[0] > steps[1] ? steps[0] : steps[1];
+    end = numBytes - maxStep;
+    x = maxStep < numBytes ? maxStep : numBytes;
+
+    averageLine(above, below, dst, x);
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    {
+        uint8x16_t odd = vreinterpretq_u8_u16(vdupq_n_u16(0xff00));
+        uint8x16_t out;
+
+        for (; x + 16 <= end; x += 16) {
+            out = elaVector(above + x, below + x, steps[0]);
+
+            if (steps[1] != steps[0]) {
+                out = vbslq_u8(odd, elaVector(above + x, below + x, steps[1]),
+                               out);
+            }
+
+            vst1q_u8(dst + x, out);
+        }
+    }
+#elif defined(__SSE2__)
+    {
+        __m128i odd = _mm_set1_epi16((short) 0xff00);
+        __m128i out;
+
+        for (; x + 16 <= end; x += 16) {
+            out = elaVector(above + x, below + x, steps[0]);
+
+            if (steps[1] != steps[0]) {
+                out = _mm_or_si128(_mm_andnot_si128(odd, out),
+                    _mm_and_si128(odd, elaVector(above + x, below + x,
+                                                 steps[1])));
+            }
+
+            _mm_storeu_si128((__m128i *) (dst + x), out);
+        }
+    }
+#endif
+
+    for (; x < end; x++) {
+        step = steps[x & 0x1];
+        best = abs(above[x] - below[x]);
+        dst[x] = (above[x] + below[x] + 1) >> 1;
+
+        diff = abs(above[x - step] - below[x + step]);
+
+        if (diff < best) {
+            best = diff;
+            dst[x] = (above[x - step] + below[x + step] + 1) >> 1;
+        }
+
+        diff = abs(above[x + step] - below[x - step]);
+
+        if (diff < best) {
+            dst[x] = (above[x + step] + below[x - step] + 1) >> 1;
+        }
+    }
+
+    if (x < numBytes) {
+        averageLine(above + x, below + x, dst + x, numBytes - x);
+    }
+}
+
+/******************************************************************************
+ * smoothLines
+ ******************************************************************************/
+static Void smoothLines(Smooth_Handle hSmooth, Smooth_Plane *plane,
+                        Int first, Int last)
+{
+    const UInt8 *src, *above, *below;
+    UInt8 *dst;
+    Int line;
+
+    for (line = first; line < last; line++) {
+        src = plane->src + line * plane->srcLineLength;
+        dst = plane->dst + line * plane->dstLineLength;
+
+        /*
+         * Lines of the kept field are copied unless working in place. The
+         * other lines are interpolated from the source only, so the bands
+         * never depend on each other's output.
+         */
+        if (!(line & 0x1) || hSmooth->mode == Smooth_Mode_WEAVE) {
+            if (src != dst) {
+                memcpy(dst, src, plane->numBytes);
+            }
+            continue;
+        }
+
+        above = src - plane->srcLineLength;
+        below = line + 1 < plane->numLines ? src + plane->srcLineLength :
+                                             above;
+
+        if (hSmooth->mode == Smooth_Mode_BOB) {
+            averageLine(above, below, dst, plane->numBytes);
+        }
+        else {
+            elaLine(above, below, dst, plane->numBytes, plane->step);
+        }
+    }
+}
+
+/******************************************************************************
+ * smoothRows
+ ******************************************************************************/
+static Void smoothRows(Ptr arg, Int firstRow, Int lastRow)
+{
+    Smooth_Handle hSmooth = (Smooth_Handle) arg;
+    Smooth_Plane *chroma = &hSmooth->planes[1];
+    Int row, end;
+
+    /* Both planes of a band of rows are done while the band is cached */
+    for (row = firstRow; row < lastRow; row += BAND_LINES) {
+        end = row + BAND_LINES < lastRow ? row + BAND_LINES : lastRow;
+
+        smoothLines(hSmooth, &hSmooth->planes[0], row, end);
+
+        if (hSmooth->numPlanes == 1) {
+            continue;
+        }
+
+        if (hSmooth->colorSpace == ColorSpace_YUV420PSEMI) {
+            smoothLines(hSmooth, chroma, row >> 1, end >> 1);
+        }
+        else {
+            smoothLines(hSmooth, chroma, row, end);
+        }
+    }
+}
+
 /******************************************************************************
  * Smooth_create
  ******************************************************************************/
 Smooth_Handle Smooth_create(Smooth_Attrs *attrs)
 {
-    return NULL;
+    Smooth_Handle hSmooth;
+
+    assert(attrs);
+
+    if (attrs->mode != Smooth_Mode_ELA && attrs->mode != Smooth_Mode_BOB &&
+        attrs->mode != Smooth_Mode_WEAVE) {
+
+        Dmai_err1("Unsupported deinterlacing mode %d\n", attrs->mode);
+        return NULL;
+    }
+
+    hSmooth = calloc(1, sizeof(Smooth_Object));
+
+    if (hSmooth == NULL) {
+        Dmai_err0("Failed to allocate space for Smooth Object\n");
+        return NULL;
+    }
+
+    hSmooth->mode = attrs->mode;
+
+    if (attrs->numThreads > 1) {
+        hSmooth->hBands = _Bands_create(attrs->numThreads);
+
+        if (hSmooth->hBands == NULL) {
+            Dmai_err1("Failed to create %d worker threads\n",
+                      attrs->numThreads);
+            free(hSmooth);
+            return NULL;
+        }
+    }
+
+    return hSmooth;
 }
 
 /******************************************************************************
@@ -54,7 +361,84 @@ Smooth_Handle Smooth_create(Smooth_Attrs *attrs)
 Int Smooth_config(Smooth_Handle hSmooth,
                   Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
-    return Dmai_ENOTIMPL;
+    BufferGfx_Dimensions srcDim, dstDim;
+    ColorSpace_Type      colorSpace;
+
+    if (!hSmooth) {
+        Dmai_err0("Smooth_Handle parameter must not be NULL\n");
+        return Dmai_EINVAL;
+    }
+
+    if (!hSrcBuf || !hDstBuf) {
+        Dmai_err0("Source and destination buffers must not be NULL\n");
+        return Dmai_EINVAL;
+    }
+
+    /* Buffer needs to be graphics buffers */
+    if (Buffer_getType(hSrcBuf) != Buffer_Type_GRAPHICS ||
+        Buffer_getType(hDstBuf) != Buffer_Type_GRAPHICS) {
+
+        Dmai_err0("Src and dst buffers need to be graphics buffers\n");
+        return Dmai_EINVAL;
+    }
+
+    colorSpace = BufferGfx_getColorSpace(hSrcBuf);
+
+    if (colorSpace != BufferGfx_getColorSpace(hDstBuf)) {
+        Dmai_err0("Src and dst buffers need to have the same color space\n");
+        return Dmai_EINVAL;
+    }
+
+    if (colorSpace != ColorSpace_YUV420PSEMI &&
+        colorSpace != ColorSpace_YUV422PSEMI &&
+        colorSpace != ColorSpace_UYVY) {
+
+        Dmai_err1("Color space %d not supported\n", colorSpace);
+        return Dmai_ENOTIMPL;
+    }
+
+    BufferGfx_getDimensions(hSrcBuf, &srcDim);
+    BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+    if (srcDim.width != dstDim.width || srcDim.height != dstDim.height) {
+        Dmai_err0("Src and dst buffers need to have the same dimensions\n");
+        return Dmai_EINVAL;
+    }
+
+    if (colorSpace == ColorSpace_YUV420PSEMI &&
+        ((dstDim.height & 0x1) || (srcDim.y & 0x1) || (dstDim.y & 0x1))) {
+
+        Dmai_err0("Buffer heights and vertical offsets must be even\n");
+        return Dmai_EINVAL;
+    }
+
+    hSmooth->colorSpace = colorSpace;
+    hSmooth->width      = dstDim.width;
+    hSmooth->height     = dstDim.height;
+
+    /* The same component is 'step' bytes away on the line */
+    if (colorSpace == ColorSpace_UYVY) {
+        hSmooth->numPlanes          = 1;
+        hSmooth->planes[0].numBytes = dstDim.width * 2;
+        hSmooth->planes[0].numLines = dstDim.height;
+        hSmooth->planes[0].step[0]  = 4;    /* Cb and Cr */
+        hSmooth->planes[0].step[1]  = 2;    /* Y */
+    }
+    else {
+        hSmooth->numPlanes          = 2;
+        hSmooth->planes[0].numBytes = dstDim.width;
+        hSmooth->planes[0].numLines = dstDim.height;
+        hSmooth->planes[0].step[0]  = 1;
+        hSmooth->planes[0].step[1]  = 1;
+        hSmooth->planes[1].numBytes = dstDim.width;
+        hSmooth->planes[1].numLines =
+            colorSpace == ColorSpace_YUV420PSEMI ? dstDim.height / 2 :
+                                                   dstDim.height;
+        hSmooth->planes[1].step[0]  = 2;
+        hSmooth->planes[1].step[1]  = 2;
+    }
+
+    return Dmai_EOK;
 }
 
 /******************************************************************************
@@ -63,7 +447,78 @@ Int Smooth_config(Smooth_Handle hSmooth,
 Int Smooth_execute(Smooth_Handle hSmooth,
                    Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
 {
-    return Dmai_ENOTIMPL;
+    BufferGfx_Dimensions srcDim;
+    BufferGfx_Dimensions dstDim;
+    Smooth_Plane        *luma;
+    Smooth_Plane        *chroma;
+    Int8                *src;
+    Int8                *dst;
+
+    assert(hSmooth);
+    assert(hSrcBuf);
+    assert(hDstBuf);
+    assert(Buffer_getUserPtr(hSrcBuf));
+    assert(Buffer_getUserPtr(hDstBuf));
+
+    if (hSmooth->numPlanes == 0) {
+        Dmai_err0("Smooth job has not been configured\n");
+        return Dmai_EINVAL;
+    }
+
+    BufferGfx_getDimensions(hSrcBuf, &srcDim);
+    BufferGfx_getDimensions(hDstBuf, &dstDim);
+
+    assert(srcDim.width == hSmooth->width);
+    assert(srcDim.height == hSmooth->height);
+    assert(dstDim.width == hSmooth->width);
+    assert(dstDim.height == hSmooth->height);
+
+    src = Buffer_getUserPtr(hSrcBuf);
+    dst = Buffer_getUserPtr(hDstBuf);
+    luma = &hSmooth->planes[0];
+    chroma = &hSmooth->planes[1];
+
+    luma->srcLineLength = srcDim.lineLength;
+    luma->dstLineLength = dstDim.lineLength;
+
+    if (hSmooth->colorSpace == ColorSpace_UYVY) {
+        luma->src = (UInt8 *) src + srcDim.y * srcDim.lineLength +
+                    (srcDim.x << 1);
+        luma->dst = (UInt8 *) dst + dstDim.y * dstDim.lineLength +
+                    (dstDim.x << 1);
+
+        Buffer_setNumBytesUsed(hDstBuf, dstDim.width * dstDim.height * 2);
+    }
+    else {
+        luma->src = (UInt8 *) src + srcDim.y * srcDim.lineLength + srcDim.x;
+        luma->dst = (UInt8 *) dst + dstDim.y * dstDim.lineLength + dstDim.x;
+
+        chroma->srcLineLength = srcDim.lineLength;
+        chroma->dstLineLength = dstDim.lineLength;
+
+        if (hSmooth->colorSpace == ColorSpace_YUV420PSEMI) {
+            chroma->src = (UInt8 *) src + Buffer_getSize(hSrcBuf) * 2 / 3 +
+                          srcDim.y / 2 * srcDim.lineLength + srcDim.x;
+            chroma->dst = (UInt8 *) dst + Buffer_getSize(hDstBuf) * 2 / 3 +
+                          dstDim.y / 2 * dstDim.lineLength + dstDim.x;
+
+            Buffer_setNumBytesUsed(hDstBuf,
+                                   dstDim.width * dstDim.height * 3 / 2);
+        }
+        else {
+            chroma->src = (UInt8 *) src + Buffer_getSize(hSrcBuf) / 2 +
+                          srcDim.y * srcDim.lineLength + srcDim.x;
+            chroma->dst = (UInt8 *) dst + Buffer_getSize(hDstBuf) / 2 +
+                          dstDim.y * dstDim.lineLength + dstDim.x;
+
+            Buffer_setNumBytesUsed(hDstBuf, dstDim.width * dstDim.height * 2);
+        }
+    }
+
+    /* Bands start on an even line to keep the chroma lines of 420 whole */
+    _Bands_run(hSmooth->hBands, smoothRows, hSmooth, hSmooth->height, 2);
+
+    return Dmai_EOK;
 }
 
 /******************************************************************************
@@ -71,5 +526,10 @@ Int Smooth_execute(Smooth_Handle hSmooth,
  ******************************************************************************/
 Int Smooth_delete(Smooth_Handle hSmooth)
 {
-    return Dmai_ENOTIMPL;
+    if (hSmooth) {
+        _Bands_delete(hSmooth->hBands);
+        free(hSmooth);
+    }
+
+    return Dmai_EOK;
 }
@@ -0,0 +1,59 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+#ifndef ti_sdo_dmai__Bands_h_
+#define ti_sdo_dmai__Bands_h_
+
+#include <xdc/std.h>
+
+/*
+ * Splits the rows of a frame in to one contiguous band per thread and runs
+ * a function on every band in parallel. The calling thread processes the
+ * first band itself, so a handle with one thread (or a NULL handle) simply
+ * calls the function for all rows.
+ */
+typedef struct _Bands_Object *_Bands_Handle;
+
+/* Processes rows [firstRow, lastRow) of the frame described by arg */
+typedef Void (*_Bands_Fxn)(Ptr arg, Int firstRow, Int lastRow);
+
+extern _Bands_Handle _Bands_create(Int numThreads);
+
+/* Band boundaries are multiples of 'align' rows */
+extern Void _Bands_run(_Bands_Handle hBands, _Bands_Fxn fxn, Ptr arg,
+                       Int numRows, Int align);
+
+extern Int _Bands_getNumThreads(_Bands_Handle hBands);
+
+extern Void _Bands_delete(_Bands_Handle hBands);
+
+#endif // ti_sdo_dmai__Bands_h_
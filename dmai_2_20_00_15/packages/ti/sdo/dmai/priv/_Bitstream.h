@@ -0,0 +1,69 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+#ifndef ti_sdo_dmai__Bitstream_h_
+#define ti_sdo_dmai__Bitstream_h_
+
+#include <string.h>
+
+#include <xdc/std.h>
+
+/******************************************************************************
+ * _Bitstream_findStartCode
+ *
+ * Returns a pointer to the first 0x000001 start code prefix starting in
+ * [ptr, end - 3], or NULL if there is none.
+ ******************************************************************************/
+static inline UInt8 *_Bitstream_findStartCode(UInt8 *ptr, UInt8 *end)
+{
+    UInt8 *p = ptr + 2;
+
+    while (p < end) {
+        /* Let the C library look for the 0x01, it scans a word at a time */
+        p = (UInt8 *) memchr(p, 0x01, end - p);
+
+        if (p == NULL) {
+            break;
+        }
+
+        if (p[-1] == 0 && p[-2] == 0) {
+            return p - 2;
+        }
+
+        /* The zeros of the next prefix can't overlap this 0x01 */
+        p += 3;
+    }
+
+    return NULL;
+}
+
+#endif // ti_sdo_dmai__Bitstream_h_
@@ -50,7 +50,7 @@
 
 typedef struct _Buffer_State {
     Int32                   numBytes;
-    UInt16                  useMask;
+    volatile UInt32         useMask;    /* 32 bit word for _Sync_cas */
 } _Buffer_State;
 
 typedef struct _Buffer_Object {
@@ -64,6 +64,11 @@ typedef struct _Buffer_Object {
     Bool                    reference;
     BufTab_Handle           hBufTab;
     Int32                   virtualBufferSize;
+    volatile Int32          refCount;
+    Buffer_Handle           hParent;
+    Buffer_Coherency        coherency;
+    Int32                   dirtyStart;
+    Int32                   dirtyEnd;
 } _Buffer_Object;
 
 typedef struct _BufferGfx_Object {
@@ -82,6 +87,7 @@ extern "C" {
 extern Void _Buffer_setId(Buffer_Handle hBuf, Int id);
 extern Void _Buffer_setBufTab(Buffer_Handle hBuf, BufTab_Handle hBufTab);
 extern Int32 _Buffer_getOriginalSize(Buffer_Handle hBuf);
+extern Void _Buffer_setVirtualPtr(Buffer_Handle hBuf, Int8 *ptr);
 
 extern Void _BufferGfx_getAttrs(Buffer_Handle hBuf, Buffer_Attrs *attrs);
 extern Void _BufferGfx_init(Buffer_Handle hBuf, Buffer_Attrs *attrs);
@@ -38,13 +38,20 @@
 #include <ti/sdo/dmai/Ccv.h>
 #include <ti/sdo/dmai/Cpu.h>
 
+/* Software conversion kernels, scalar or SIMD (see Ccv.c) */
+typedef struct _Ccv_Kernels _Ccv_Kernels;
+
 typedef struct Ccv_Object {
-    Int             fd;
-    Int             width;
-    Int             height;
-    Int             accel;
-    Ccv_Mode        mode;
-    Cpu_Device      device;
+    Int                 fd;
+    Int                 width;
+    Int                 height;
+    Int                 accel;
+    Ccv_Mode            mode;
+    Cpu_Device          device;
+    const _Ccv_Kernels *kernels;
 } Ccv_Object;
 
+/* Per-OS hook: TRUE if the CPU has the SIMD unit the kernels were built for */
+extern Bool _Ccv_simdSupported(Void);
+
 #endif // ti_sdo_dmai__Ccv_h_
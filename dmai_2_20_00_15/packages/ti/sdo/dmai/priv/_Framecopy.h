@@ -35,9 +35,14 @@
 
 #include <xdc/std.h>
 
+#include <ti/sdo/dmai/Time.h>
+
 typedef struct Framecopy_CommonObject {
-    Int      accel;
-    Int      sdma;
+    Int         accel;
+    Int         sdma;
+    Time_Handle hTime;
+    Double      numBytes;
+    Double      numUsecs;
 } Framecopy_CommonObject;
 
 /* Accelerated functions */
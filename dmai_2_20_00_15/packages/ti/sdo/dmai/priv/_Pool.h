@@ -0,0 +1,79 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+
+#ifndef ti_sdo_dmai__Pool_h_
+#define ti_sdo_dmai__Pool_h_
+
+#include <xdc/std.h>
+
+#include <ti/sdo/ce/osal/Sem.h>
+
+#include <ti/sdo/dmai/Dmai.h>
+
+#include "_Sync.h"
+
+/*
+ * Lock guarding the pre-created instance pools of the codec modules. It is
+ * only held while walking a pool, never across codec calls, and sleeps on
+ * a semaphore rather than spinning so a preempted holder can not starve
+ * the waiters. The semaphore is created by the first user.
+ */
+static inline Int _Pool_lock(Sem_Handle volatile *hSemPtr)
+{
+    Sem_Handle hSem;
+
+    if (*hSemPtr == NULL) {
+        hSem = Sem_create(0, 1);
+
+        if (hSem == NULL) {
+            return Dmai_ENOMEM;
+        }
+
+        if (!_Sync_cas(hSemPtr, NULL, hSem)) {
+            Sem_delete(hSem);
+        }
+    }
+
+    if (Sem_pend(*hSemPtr, Sem_FOREVER) != Sem_EOK) {
+        return Dmai_EFAIL;
+    }
+
+    return Dmai_EOK;
+}
+
+static inline Void _Pool_unlock(Sem_Handle volatile *hSemPtr)
+{
+    Sem_post(*hSemPtr);
+}
+
+#endif // ti_sdo_dmai__Pool_h_
@@ -0,0 +1,164 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2010, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+
+#ifndef ti_sdo_dmai__Sync_h_
+#define ti_sdo_dmai__Sync_h_
+
+#include <xdc/std.h>
+
+/*
+ * Atomic primitives used by modules whose objects may be shared between
+ * threads. The GNU toolchains used for Linux provide them as builtins. On
+ * Bios they are made atomic by disabling interrupts around the access, and
+ * on WinCE by the Interlocked functions. Both of these only handle 32 bit
+ * words, which is also the size of a pointer on those targets.
+ */
+#if defined(__GNUC__)
+
+#define _Sync_barrier()                 __sync_synchronize()
+#define _Sync_cas(ptr, oldVal, newVal)  \
+    __sync_bool_compare_and_swap((ptr), (oldVal), (newVal))
+#define _Sync_fetchAndOr(ptr, val)      __sync_fetch_and_or((ptr), (val))
+#define _Sync_fetchAndAnd(ptr, val)     __sync_fetch_and_and((ptr), (val))
+#define _Sync_addAndFetch(ptr, val)     __sync_add_and_fetch((ptr), (val))
+#define _Sync_ffs(val)                  __builtin_ffs(val)
+
+#else
+
+#if defined(xdc_target__os_WindowsCE)
+
+#include <windows.h>
+
+static inline Void _Sync_barrier(Void)
+{
+    LONG dummy;
+
+    /* Interlocked operations are full memory barriers */
+    InterlockedExchange(&dummy, 0);
+}
+
+static inline Bool _Sync_casWord(volatile UInt32 *ptr, UInt32 oldVal,
+                                 UInt32 newVal)
+{
+    return (UInt32)InterlockedCompareExchange((LPLONG)ptr, (LONG)newVal,
+                                              (LONG)oldVal) == oldVal;
+}
+
+static inline Int32 _Sync_addWord(volatile Int32 *ptr, Int32 val)
+{
+    return InterlockedExchangeAdd((LPLONG)ptr, val) + val;
+}
+
+#elif defined(__TI_COMPILER_VERSION__)
+
+#include <std.h>
+#include <hwi.h>
+
+/* Bios runs on a single core, so the call only has to stop the compiler */
+#define _Sync_barrier()                 HWI_restore(HWI_disable())
+
+static inline Bool _Sync_casWord(volatile UInt32 *ptr, UInt32 oldVal,
+                                 UInt32 newVal)
+{
+    Uns  key = HWI_disable();
+    Bool swapped = *ptr == oldVal;
+
+    if (swapped) {
+        *ptr = newVal;
+    }
+
+    HWI_restore(key);
+
+    return swapped;
+}
+
+static inline Int32 _Sync_addWord(volatile Int32 *ptr, Int32 val)
+{
+    Uns   key = HWI_disable();
+    Int32 newVal = *ptr + val;
+
+    *ptr = newVal;
+
+    HWI_restore(key);
+
+    return newVal;
+}
+
+#else
+
+#error "No atomic primitives for this toolchain"
+
+#endif
+
+#define _Sync_cas(ptr, oldVal, newVal)  \
+    _Sync_casWord((volatile UInt32 *)(ptr), (UInt32)(oldVal), (UInt32)(newVal))
+#define _Sync_addAndFetch(ptr, val)     \
+    _Sync_addWord((volatile Int32 *)(ptr), (val))
+
+static inline UInt32 _Sync_fetchAndOr(volatile UInt32 *ptr, UInt32 val)
+{
+    UInt32 oldVal;
+
+    do {
+        oldVal = *ptr;
+    } while (!_Sync_casWord(ptr, oldVal, oldVal | val));
+
+    return oldVal;
+}
+
+static inline UInt32 _Sync_fetchAndAnd(volatile UInt32 *ptr, UInt32 val)
+{
+    UInt32 oldVal;
+
+    do {
+        oldVal = *ptr;
+    } while (!_Sync_casWord(ptr, oldVal, oldVal & val));
+
+    return oldVal;
+}
+
+static inline Int _Sync_ffs(UInt32 val)
+{
+    Int bit;
+
+    for (bit = 1; val; bit++, val >>= 1) {
+        if (val & 1) {
+            return bit;
+        }
+    }
+
+    return 0;
+}
+
+#endif
+
+#endif // ti_sdo_dmai__Sync_h_
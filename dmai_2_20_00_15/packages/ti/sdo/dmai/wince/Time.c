@@ -37,6 +37,8 @@
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Time.h>
 
+#include "../priv/_Time.h"
+
 #define MODULE_NAME     "Time"
 
 typedef struct Time_Object {
@@ -167,3 +169,13 @@ Int Time_total(Time_Handle hTime, UInt32 *totalPtr)
     *totalPtr = (UInt32)(deltaCounter.LowPart);
     return Dmai_EOK;
 }
+
+/******************************************************************************
+ * _Time_getSemTicks
+ ******************************************************************************/
+UInt32 _Time_getSemTicks(Void)
+{
+    /* Sem_pend only supports Sem_FOREVER here, any unit will do */
+    return GetTickCount();
+}
+
@@ -48,6 +48,7 @@
 #include <ti/sdo/dmai/Pause.h>
 #include <ti/sdo/dmai/BufTab.h>
 #include <ti/sdo/dmai/Loader.h>
+#include <ti/sdo/dmai/Probe.h>
 #include <ti/sdo/dmai/VideoStd.h>
 #include <ti/sdo/dmai/ce/Vdec2.h>
 #include <ti/sdo/dmai/BufferGfx.h>
@@ -59,6 +60,9 @@
 /* Buffering for the display driver */
 #define NUM_DISPLAY_BUFS        4 
 
+/* Maximum number of display buffers handed to the display thread at once */
+#define MAX_DISPLAY_BATCH       16
+
 /* The masks to use for knowing when a buffer is free */
 #define CODEC_FREE              0x1
 #define DISPLAY_FREE            0x2
@@ -149,7 +153,9 @@ static Int resizeBufTab(Vdec2_Handle hVd2, Int displayBufs)
 static Int handleCodecBufs(Vdec2_Handle hVd2, Fifo_Handle hFifo)
 {
     Buffer_Handle hOutBuf, hFreeBuf;
+    Ptr hDisplayBufs[MAX_DISPLAY_BATCH];
     Int numDisplayBufs = 0;
+    Int numBatched = 0;
     UInt16 useMask;
 
     /* Get a buffer for display from the codec */
@@ -159,16 +165,22 @@ static Int handleCodecBufs(Vdec2_Handle hVd2, Fifo_Handle hFifo)
         useMask = Buffer_getUseMask(hOutBuf);
         Buffer_setUseMask(hOutBuf, useMask | DISPLAY_FREE);
 
-        /* Send buffer to display thread */
-        if (Fifo_put(hFifo, hOutBuf) < 0) {
-            ERR("Failed to send buffer to display thread\n");
-            return FAILURE;
-        }
-
+        hDisplayBufs[numBatched++] = hOutBuf;
         numDisplayBufs++;
-        
+
         /* Get another buffer for display from the codec */
         hOutBuf = Vdec2_getDisplayBuf(hVd2);
+
+        /* Send the batch of buffers to the display thread */
+        if (numBatched == MAX_DISPLAY_BATCH || (hOutBuf == NULL &&
+                                                numBatched > 0)) {
+            if (Fifo_putMany(hFifo, hDisplayBufs, numBatched) < 0) {
+                ERR("Failed to send buffers to display thread\n");
+                return FAILURE;
+            }
+
+            numBatched = 0;
+        }
     }
 
     /* Get a buffer to free from the codec */
@@ -217,6 +229,7 @@ static Int flushDisplayPipe(Fifo_Handle hFifo, BufTab_Handle hBufTab,
 {
    /* Flush the Display pipe with blank buffers */
    Buffer_Handle hBuf;
+   Ptr hBlankBufs[NUM_DISPLAY_BUFS];
    Int i;
 
    for (i = 0; i < NUM_DISPLAY_BUFS; i++) {
@@ -230,16 +243,38 @@ static Int flushDisplayPipe(Fifo_Handle hFifo, BufTab_Handle hBufTab,
 
        blackFill(hBuf);
 
-       /* Send buffer to display thread */
-       if (Fifo_put(hFifo, hBuf) < 0) {
-           ERR("Failed to send buffer to display thread\n");
-           return FAILURE;
-       }
+       hBlankBufs[i] = hBuf;
+   }
+
+   /* Send all blank buffers to the display thread at once */
+   if (Fifo_putMany(hFifo, hBlankBufs, NUM_DISPLAY_BUFS) < 0) {
+       ERR("Failed to send buffers to display thread\n");
+       return FAILURE;
    }
 
    return SUCCESS;
 }
 
+/******************************************************************************
+ * getLoaderFormat
+ ******************************************************************************/
+static Loader_Format getLoaderFormat(Char *codecName)
+{
+    if (strcmp(codecName, "h264dec") == 0) {
+        return Loader_Format_H264;
+    }
+
+    if (strcmp(codecName, "mpeg4dec") == 0) {
+        return Loader_Format_MPEG4;
+    }
+
+    if (strcmp(codecName, "mpeg2dec") == 0) {
+        return Loader_Format_MPEG2;
+    }
+
+    return Loader_Format_NONE;
+}
+
 /******************************************************************************
  * findClipDimensions
  ******************************************************************************/
@@ -357,10 +392,6 @@ Int findClipDimensions(Loader_Handle hLoader, Char * videoFile,
         return FAILURE;
     }
 
-    /* Record clip's width and height for OSD display */
-    gblSetImageWidth(dim->width);
-    gblSetImageHeight(dim->height);
-
     return SUCCESS;
 }
 
@@ -437,24 +468,6 @@ Void *videoThrFxn(Void *arg)
     /* Color space */
     gfxAttrs.colorSpace = colorSpace;
 
-    /* Set the original dimensions of the Buffers to the max */
-    gfxAttrs.dim.width = params->maxWidth;
-    gfxAttrs.dim.height = params->maxHeight;
-    gfxAttrs.dim.lineLength = BufferGfx_calcLineLength(gfxAttrs.dim.width,
-                                                       colorSpace);
-
-    /* Create a table of buffers for decoded data */
-    hBufTab = BufTab_create(NUM_DISPLAY_BUFS, bufSize,
-                            BufferGfx_getBufferAttrs(&gfxAttrs));
-
-    if (hBufTab == NULL) {
-        ERR("Failed to create BufTab for display pipe\n");
-        cleanup(THREAD_FAILURE);
-    }
-
-    /* The codec is going to use this BufTab for output buffers */
-    Vdec2_setBufTab(hVd2, hBufTab);
-
     /* Ask the codec how much input data it needs */
     lAttrs.readSize = Vdec2_getInBufSize(hVd2);
 
@@ -467,6 +480,17 @@ Void *videoThrFxn(Void *arg)
     /* Use asynchronous mode since we have a separate loader thread */
     lAttrs.async = TRUE;
 
+    /* Hand the codec one frame at a time, and index them for looping */
+    lAttrs.format = getLoaderFormat(envp->videoDecoder);
+    lAttrs.index = TRUE;
+
+    /*
+     * Map the file so that looping back to an indexed frame only moves the
+     * window instead of reading the file again. Windows are staged in the
+     * (contiguous) ring buffer for the codec.
+     */
+    lAttrs.mode = Loader_Mode_MMAP;
+
     /* Create the file loader for reading encoded data */
     hLoader = Loader_create(envp->videoFile, &lAttrs);
 
@@ -487,11 +511,42 @@ Void *videoThrFxn(Void *arg)
     /* Signal that initialization is done and wait for other threads */
     Rendezvous_meet(envp->hRendezvousInit);
 
-    /* Find the clip's dimensions */
-    if (findClipDimensions(hLoader, envp->videoFile, hBufTab, hVd2, &dim) 
-        == FAILURE) {
+    /* Prime the file loader to look at the beginning of the file */
+    if (Loader_prime(hLoader, &hInBuf) < 0) {
+        ERR("Failed to prime loader for file %s\n", envp->videoFile);
         cleanup(THREAD_FAILURE);
-    };
+    }
+
+    /* Parse the clip's dimensions from its sequence header if possible */
+    if (Probe_getDimensions(lAttrs.format, hInBuf, &dim) < 0) {
+        /* Set the original dimensions of the Buffers to the max */
+        gfxAttrs.dim.width = params->maxWidth;
+        gfxAttrs.dim.height = params->maxHeight;
+        gfxAttrs.dim.lineLength = BufferGfx_calcLineLength(gfxAttrs.dim.width,
+                                                           colorSpace);
+
+        /* Create a table of buffers for decoded data */
+        hBufTab = BufTab_create(NUM_DISPLAY_BUFS, bufSize,
+                                BufferGfx_getBufferAttrs(&gfxAttrs));
+
+        if (hBufTab == NULL) {
+            ERR("Failed to create BufTab for display pipe\n");
+            cleanup(THREAD_FAILURE);
+        }
+
+        /* The codec is going to use this BufTab for output buffers */
+        Vdec2_setBufTab(hVd2, hBufTab);
+
+        /* Fall back to decoding until the first frame to display */
+        if (findClipDimensions(hLoader, envp->videoFile, hBufTab, hVd2, &dim)
+            == FAILURE) {
+            cleanup(THREAD_FAILURE);
+        }
+    }
+
+    /* Record clip's width and height for OSD display */
+    gblSetImageWidth(dim.width);
+    gblSetImageHeight(dim.height);
 
     /* Adjust width and height to match the clip's dimensions */
     params->maxWidth     = dim.width;
@@ -513,7 +568,7 @@ Void *videoThrFxn(Void *arg)
     /* Which output buffer size does the codec require? */
     bufSize = Vdec2_getOutBufSize(hVd2);
 
-    /* Recreate the BufTab */
+    /* Recreate the BufTab if one was needed to find the dimensions */
     if (hBufTab) {
         BufTab_delete(hBufTab);
     }
@@ -553,8 +608,13 @@ prime:
         numBufs = totalNumBufs - NUM_DISPLAY_BUFS;
     }
 
-    /* Prime the file loader and start reading from beginning of file */
-    if (Loader_prime(hLoader, &hInBuf) < 0) {
+    /*
+     * Restart at the first indexed frame, or from the beginning of file. The
+     * file is mapped, so neither of them reads it again.
+     */
+    if ((Loader_getNumFrames(hLoader) > 0 ?
+         Loader_seek(hLoader, 0, &hInBuf) :
+         Loader_prime(hLoader, &hInBuf)) < 0) {
         ERR("Failed to prime loader for file %s\n", envp->videoFile);
         cleanup(THREAD_FAILURE);
     }
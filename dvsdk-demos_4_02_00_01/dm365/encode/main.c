@@ -941,6 +941,12 @@ Int main(Int argc, Char *argv[])
         cleanup(EXIT_FAILURE);
     }
 
+    /*
+     * Every fifo in the video pipeline has exactly one producer and one
+     * consumer thread, so use the lock-free ring instead of a pipe.
+     */
+    fAttrs.mode = Fifo_Mode_RING;
+
     /* Create the video threads if a file name is supplied */
     if (args.videoFile) {
         /* Create the capture fifos */